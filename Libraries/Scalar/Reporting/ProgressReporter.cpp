@@ -1,5 +1,7 @@
 #include "ProgressReporter.h"
 
+#include "CPUDispatch.h"
+#include "Trace.h"
 #include "VoidAndCluster/VoidAndCluster.h"
 #include "Utils/Dimensions.h"
 
@@ -26,7 +28,10 @@ ProgressReporter::ProgressReporter(const VoidAndCluster* vc, size_t updateInterv
     m_finishedPhase3Part1(false),
     m_finishedPhase3Part2(false),
     m_doneAnalyzing(false),
-    m_donePrinting(false)
+    m_donePrinting(false),
+    m_traceSampleTime(std::chrono::steady_clock::now()),
+    m_traceSampleSwaps(0),
+    m_traceSampleRanks(0)
 {
 
 }
@@ -170,11 +175,13 @@ void ProgressReporter::CmdReporter()
 {
     auto dims = m_vc->GetSTBNData().dimensions;
     std::stringstream ss;
-    ss << "Running VoidAndCluster on " << dims.x << "x" << dims.y << "x" << dims.z << "x" << dims.w << "\n";
+    ss << "Running VoidAndCluster on " << dims.x << "x" << dims.y << "x" << dims.z << "x" << dims.w << " (CPU dispatch: " << ISAToString(GetSelectedISA()) << ")\n";
     LogLine(ss.str());
+    Trace::SetThreadName("Progress reporter");
     while (IsInProgress())
     {
         UpdateCMD();
+        SampleTraceCounters();
         std::this_thread::sleep_for(std::chrono::milliseconds(m_updateIntervalMs));
     }
     LogSummaryLine(m_vc->GetProgressData().phase3Part2EndTime - m_vc->GetProgressData().initializeToWhiteNoiseStartTime);
@@ -269,6 +276,34 @@ void ProgressReporter::UpdateCMD()
     }
 }
 
+void ProgressReporter::SampleTraceCounters()
+{
+    if (!Trace::IsOpen())
+        return;
+
+    // Ranks are handed out by Phase 1 Part 1, Phase 2 and Phase 3 Part 2
+    const VoidAndClusterProgressData& pd = m_vc->GetProgressData();
+    size_t swaps = pd.reorganizeToBlueNoiseIterationsSoFar;
+    size_t ranks = 0;
+    if (m_finishedReorganizeToBlueNoise)
+        ranks += pd.phase1Part1OnesCountTotal - pd.phase1Part1OnesCountRemaining;
+    if (m_finishedPhase1Part2 && pd.phase2OnesCountCurrent >= pd.phase1Part1OnesCountTotal)
+        ranks += pd.phase2OnesCountCurrent - pd.phase1Part1OnesCountTotal;
+    if (m_finishedPhase3Part1)
+        ranks += pd.phase3Part2OnesCountTotal - pd.phase3Part2OnesCountRemaining;
+
+    auto now = std::chrono::steady_clock::now();
+    float seconds = std::chrono::duration<float>(now - m_traceSampleTime).count();
+    if (seconds > 0.0f)
+    {
+        Trace::Counter("Swaps/sec", float(swaps - m_traceSampleSwaps) / seconds);
+        Trace::Counter("Ranks/sec", float(ranks - m_traceSampleRanks) / seconds);
+    }
+    m_traceSampleTime = now;
+    m_traceSampleSwaps = swaps;
+    m_traceSampleRanks = ranks;
+}
+
 void ProgressReporter::UpdateInitializeToWhiteNoise()
 {
     auto current = m_vc->GetProgressData().initializeToWhiteNoiseCurrentIndex;
@@ -341,7 +376,8 @@ void ProgressReporter::UpdatePhase3Part2()
     auto remaining = m_vc->GetProgressData().phase3Part2OnesCountRemaining;
     auto total = m_vc->GetProgressData().phase3Part2OnesCountTotal;
     auto completed = total - remaining;
-    float percentage = 100.0f * (static_cast<float>(completed) / static_cast<float>(total));
+    // total is 0 when a max rank skipped Phase 3
+    float percentage = (total > 0) ? 100.0f * (static_cast<float>(completed) / static_cast<float>(total)) : 100.0f;
 
     auto duration = std::chrono::steady_clock::now() - m_vc->GetProgressData().phase3Part2StartTime;
     LogProgressLine(6, percentage, completed, total, m_totalLabelWidth, duration);
@@ -41,9 +41,15 @@ private:
     double m_phase3Part1StartTime;
     double m_phase3Part2StartTime;
 
+    // Last sample of the trace counters, for swaps and ranks per second
+    std::chrono::steady_clock::time_point m_traceSampleTime;
+    size_t m_traceSampleSwaps;
+    size_t m_traceSampleRanks;
+
     bool IsInProgress();
     void CmdReporter();
     void UpdateCMD();
+    void SampleTraceCounters();
 
     void UpdateInitializeToWhiteNoise();
     void UpdateReorganizeToBlueNoise();
@@ -5,11 +5,12 @@ bool operator==(const SigmaPerDimension& a, const SigmaPerDimension& b)
     return (a.x == b.x) && (a.y == b.y) && (a.z == b.z) && (a.w == b.w);
 }
 
-STBNData::STBNData(Dimensions _dimensions) :
+STBNData::STBNData(Dimensions _dimensions, bool withEnergy) :
     dimensions(_dimensions),
     numPixels(_dimensions.x* _dimensions.y* _dimensions.z* _dimensions.w)
 {
-    energy.resize(numPixels, 0.0f);
+    if (withEnergy)
+        energy.resize(numPixels, 0.0f);
     pixelOn.resize(numPixels, false);
     pixelRank.resize(numPixels, numPixels);
 }
@@ -1,9 +1,10 @@
 #pragma once
 
-#include <vector>
 #include <vector>
 
+#include "ArenaAllocator.h"
 #include "Utils/Dimensions.h"
+#include "Utils/PixelBitset.h"
 
 struct SigmaPerDimension
 {
@@ -17,11 +18,12 @@ bool operator==(const SigmaPerDimension& a, const SigmaPerDimension& b);
 
 struct STBNData
 {
-    STBNData(Dimensions _dimensions);
+    // Without withEnergy, energy is left empty, for controllers that keep the energy somewhere else
+    STBNData(Dimensions _dimensions, bool withEnergy = true);
 
-    std::vector<float> energy;
-    std::vector<bool> pixelOn;
-    std::vector<size_t> pixelRank;
+    ArenaVector<float> energy;
+    PixelBitset pixelOn;
+    ArenaVector<size_t> pixelRank;
 
     Dimensions dimensions;
     const size_t numPixels;
@@ -0,0 +1,216 @@
+#include "STBNExtender.h"
+
+#include <algorithm>
+#include <numeric>
+
+#include "Utils/PixelCoords.h"
+
+namespace
+{
+
+Dimensions ExtendedDims(Dimensions dims, size_t extendedDimZ)
+{
+    dims.z = extendedDimZ;
+    return dims;
+}
+
+size_t NumPixels(const Dimensions& dims)
+{
+    return dims.x * dims.y * dims.z * dims.w;
+}
+
+// The working window is the new slices with a halo of fixed slices on both sides. Splats from the new
+// slices never reach past the halo, and splats from the halo only wrap around into the other side of the halo.
+// If the existing slices aren't thick enough to make two separate halos, the whole extended volume is used.
+Dimensions WindowDims(const Dimensions& existingDims, size_t extendedDimZ, size_t haloZ)
+{
+    Dimensions dims = ExtendedDims(existingDims, extendedDimZ);
+    if (2 * haloZ < existingDims.z)
+        dims.z = (extendedDimZ - existingDims.z) + 2 * haloZ;
+    return dims;
+}
+
+size_t WindowStartZ(const Dimensions& existingDims, size_t haloZ)
+{
+    return (2 * haloZ < existingDims.z) ? existingDims.z - haloZ : 0;
+}
+
+}
+
+STBNExtender::STBNExtender(Dimensions existingDims, const std::vector<size_t>& existingRanks, size_t extendedDimZ, SigmaPerDimension sigmas, ScalarImplementation scalarImplementation, const std::vector<int>& groups) :
+    m_existingDims(existingDims),
+    m_numExistingPixels(NumPixels(existingDims)),
+    m_numNewPixels(NumPixels(ExtendedDims(existingDims, extendedDimZ)) - NumPixels(existingDims)),
+    m_kernelX(sigmas.x, existingDims.x),
+    m_kernelY(sigmas.y, existingDims.y),
+    m_kernelZ(sigmas.z, extendedDimZ),
+    m_kernelW(sigmas.w, existingDims.w),
+    m_data(ExtendedDims(existingDims, extendedDimZ)),
+    m_windowStartZ(WindowStartZ(existingDims, size_t(m_kernelZ.max()))),
+    m_window(WindowDims(existingDims, extendedDimZ, size_t(m_kernelZ.max())), ControllerUsesEnergy(scalarImplementation)),
+    m_sigmas(sigmas),
+    m_groups(groups)
+{
+    m_updater = MakeVCController(scalarImplementation, m_window, m_kernelX, m_kernelY, m_kernelZ, m_kernelW, m_groups);
+
+    // Existing pixel (x,y,z,w) keeps its coordinates in the extended volume
+    std::vector<size_t> existingOrder(m_numExistingPixels);
+    std::iota(existingOrder.begin(), existingOrder.end(), size_t(0));
+    std::stable_sort(existingOrder.begin(), existingOrder.end(), [&existingRanks](size_t a, size_t b) { return existingRanks[a] < existingRanks[b]; });
+
+    m_existingOrder.resize(m_numExistingPixels);
+    for (size_t index = 0; index < m_numExistingPixels; ++index)
+    {
+        PixelCoords coords = PixelIndexToPixelCoords(existingOrder[index], m_existingDims);
+        m_existingOrder[index] = PixelCoordsToPixelIndex(coords, m_data.dimensions);
+    }
+}
+
+std::vector<bool> STBNExtender::MakeExistingRankSlots() const
+{
+    // Existing pixel k sits at (k + 0.5) / numExisting through the rank range and new pixel j at (j + 0.5) / numNew.
+    // Merging the two sequences interleaves them evenly while keeping the existing rank order.
+    std::vector<bool> ret(m_data.numPixels, false);
+    size_t existingIndex = 0;
+    size_t newIndex = 0;
+    for (size_t rank = 0; rank < m_data.numPixels; ++rank)
+    {
+        bool existing = (existingIndex < m_numExistingPixels) &&
+            ((newIndex >= m_numNewPixels) || ((2 * existingIndex + 1) * m_numNewPixels <= (2 * newIndex + 1) * m_numExistingPixels));
+        ret[rank] = existing;
+        if (existing)
+            existingIndex++;
+        else
+            newIndex++;
+    }
+    return ret;
+}
+
+bool STBNExtender::ExtendedToWindowIndex(size_t pixelIndex, size_t& windowPixelIndex) const
+{
+    PixelCoords coords = PixelIndexToPixelCoords(pixelIndex, m_data.dimensions);
+    coords.z = (coords.z + m_data.dimensions.z - m_windowStartZ) % m_data.dimensions.z;
+    if (coords.z >= m_window.dimensions.z)
+        return false;
+    windowPixelIndex = PixelCoordsToPixelIndex(coords, m_window.dimensions);
+    return true;
+}
+
+size_t STBNExtender::WindowToExtendedIndex(size_t windowPixelIndex) const
+{
+    PixelCoords coords = PixelIndexToPixelCoords(windowPixelIndex, m_window.dimensions);
+    coords.z = (coords.z + m_windowStartZ) % m_data.dimensions.z;
+    return PixelCoordsToPixelIndex(coords, m_data.dimensions);
+}
+
+bool STBNExtender::IsNewPixel(size_t windowPixelIndex) const
+{
+    return PixelIndexToPixelCoords(WindowToExtendedIndex(windowPixelIndex), m_data.dimensions).z >= m_existingDims.z;
+}
+
+void STBNExtender::Make()
+{
+    // pixelOn marks which window pixels the engine may pick. Fixed halo pixels are never picked, so their
+    // energy is splatted by hand when their rank comes up instead of going through SetPixelOn.
+    std::vector<bool> existingSlots = MakeExistingRankSlots();
+    const size_t halfPixels = m_data.numPixels / 2;
+    size_t existingIndex = 0;
+
+    // Window pixels hold extended ranks, which run past the window's own pixel count, so m_data.numPixels is unranked
+    std::fill(m_window.pixelRank.begin(), m_window.pixelRank.end(), m_data.numPixels);
+
+    // Like Phase 2: insert into the largest void, with fixed pixels "on" so they are never a void.
+    m_updater->SetAllEnergyToZero();
+    for (size_t windowPixelIndex = 0; windowPixelIndex < m_window.numPixels; ++windowPixelIndex)
+        m_updater->SetPixelOn(windowPixelIndex, !IsNewPixel(windowPixelIndex));
+
+    for (size_t rank = 0; rank < halfPixels; ++rank)
+    {
+        if (existingSlots[rank])
+        {
+            size_t pixelIndex = m_existingOrder[existingIndex++];
+            m_data.pixelRank[pixelIndex] = rank;
+
+            size_t windowPixelIndex;
+            if (ExtendedToWindowIndex(pixelIndex, windowPixelIndex))
+                m_updater->SplatOn(PixelIndexToPixelCoords(windowPixelIndex, m_window.dimensions));
+        }
+        else
+        {
+            size_t largestVoidIndex = m_updater->GetLargestVoid();
+            m_updater->SetPixelOn(largestVoidIndex, true);
+            m_updater->SetPixelRank(largestVoidIndex, rank);
+            m_updater->SplatOn(PixelIndexToPixelCoords(largestVoidIndex, m_window.dimensions));
+        }
+    }
+
+    // Like Phase 3: the unranked pixels are the ones, and the tightest cluster of them gets the next rank.
+    // Fixed pixels are "off" so they are never a cluster, but still emit energy until their rank comes up.
+    m_updater->SetAllEnergyToZero();
+    for (size_t windowPixelIndex = 0; windowPixelIndex < m_window.numPixels; ++windowPixelIndex)
+    {
+        bool unrankedNewPixel = IsNewPixel(windowPixelIndex) && (m_window.pixelRank[windowPixelIndex] == m_data.numPixels);
+        m_updater->SetPixelOn(windowPixelIndex, unrankedNewPixel);
+        if (unrankedNewPixel)
+            m_updater->SplatOn(PixelIndexToPixelCoords(windowPixelIndex, m_window.dimensions));
+    }
+    for (size_t index = existingIndex; index < m_numExistingPixels; ++index)
+    {
+        size_t windowPixelIndex;
+        if (ExtendedToWindowIndex(m_existingOrder[index], windowPixelIndex))
+            m_updater->SplatOn(PixelIndexToPixelCoords(windowPixelIndex, m_window.dimensions));
+    }
+
+    for (size_t rank = halfPixels; rank < m_data.numPixels; ++rank)
+    {
+        if (existingSlots[rank])
+        {
+            size_t pixelIndex = m_existingOrder[existingIndex++];
+            m_data.pixelRank[pixelIndex] = rank;
+
+            size_t windowPixelIndex;
+            if (ExtendedToWindowIndex(pixelIndex, windowPixelIndex))
+                m_updater->SplatOff(PixelIndexToPixelCoords(windowPixelIndex, m_window.dimensions));
+        }
+        else
+        {
+            size_t tightestClusterIndex = m_updater->GetTightestCluster();
+            m_updater->SetPixelOn(tightestClusterIndex, false);
+            m_updater->SetPixelRank(tightestClusterIndex, rank);
+            m_updater->SplatOff(PixelIndexToPixelCoords(tightestClusterIndex, m_window.dimensions));
+        }
+    }
+
+    // copy the new pixel ranks out of the window
+    for (size_t windowPixelIndex = 0; windowPixelIndex < m_window.numPixels; ++windowPixelIndex)
+    {
+        if (IsNewPixel(windowPixelIndex))
+            m_data.pixelRank[WindowToExtendedIndex(windowPixelIndex)] = m_window.pixelRank[windowPixelIndex];
+    }
+}
+
+BlueNoiseTexturesND STBNExtender::GetBlueNoiseTextures() const
+{
+    BlueNoiseTexturesND textures;
+    textures.Init({ static_cast<int>(m_data.dimensions.x), static_cast<int>(m_data.dimensions.y), static_cast<int>(m_data.dimensions.z), 1 }, { m_sigmas.x, m_sigmas.y, m_sigmas.z, 1 }, m_groups);
+    auto& pixels = textures.GetPixels();
+    for (size_t pixelIndex = 0; pixelIndex < m_data.numPixels; ++pixelIndex)
+    {
+        Pixel& pixel = pixels[pixelIndex];
+        pixel.energy = 0.0f;
+        pixel.on = true;
+        pixel.rank = static_cast<int>(m_data.pixelRank[pixelIndex]);
+    }
+
+    return textures;
+}
+
+const STBNData& STBNExtender::GetSTBNData() const
+{
+    return m_data;
+}
+
+size_t STBNExtender::GetWindowDimZ() const
+{
+    return m_window.dimensions.z;
+}
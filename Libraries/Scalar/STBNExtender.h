@@ -0,0 +1,58 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "BlueNoiseTexturesND.h"
+#include "Kernel/BlueNoiseGaussianKernel.h"
+#include "STBNData.h"
+#include "STBNMaker.h"
+#include "VoidAndCluster/VCController.h"
+
+// Appends Z slices to an existing scalar STBN without regenerating it.
+// The existing pixels keep their relative rank order and are spread evenly through the ranks of the
+// extended texture. Void and cluster then only runs over the new slices, plus a halo of fixed slices
+// (wrapped toroidally) that is as thick as the Z kernel, so the cost is proportional to the new slices.
+class STBNExtender
+{
+public:
+    STBNExtender(Dimensions existingDims, const std::vector<size_t>& existingRanks, size_t extendedDimZ, SigmaPerDimension sigmas, ScalarImplementation scalarImplementation, const std::vector<int>& groups = { 0, 0, 1, 2 });
+
+    void Make();
+
+    BlueNoiseTexturesND GetBlueNoiseTextures() const;
+
+    const STBNData& GetSTBNData() const;
+
+    // Depth of the working volume that void and cluster actually runs on
+    size_t GetWindowDimZ() const;
+
+private:
+    Dimensions m_existingDims;
+    size_t m_numExistingPixels;
+    size_t m_numNewPixels;
+
+    // Existing pixel indices, in the extended volume, sorted by their existing rank
+    std::vector<size_t> m_existingOrder;
+
+    BlueNoiseGaussianKernel m_kernelX;
+    BlueNoiseGaussianKernel m_kernelY;
+    BlueNoiseGaussianKernel m_kernelZ;
+    BlueNoiseGaussianKernel m_kernelW;
+
+    // The full extended volume. Only pixelRank is used.
+    STBNData m_data;
+
+    // Fixed slices kept below the new range. Window slice s is extended slice (m_windowStartZ + s) % dims.z
+    size_t m_windowStartZ;
+    STBNData m_window;
+    std::unique_ptr<VCController> m_updater;
+
+    SigmaPerDimension m_sigmas;
+    std::vector<int> m_groups;
+
+    std::vector<bool> MakeExistingRankSlots() const;
+    bool ExtendedToWindowIndex(size_t pixelIndex, size_t& windowPixelIndex) const;
+    size_t WindowToExtendedIndex(size_t windowPixelIndex) const;
+    bool IsNewPixel(size_t windowPixelIndex) const;
+};
@@ -4,37 +4,68 @@
 #include <vector>
 
 #include "STBNRandom.h"
+#include "Utils/PixelCoords.h"
 #include "VoidAndCluster/VoidAndCluster.h"
+#include "VoidAndCluster/Auto/AutoController2Dx1Dx1D.h"
+#include "VoidAndCluster/Distributed/DistributedController2Dx1Dx1D.h"
+#include "VoidAndCluster/FixedPoint/FixedPointController2Dx1Dx1D.h"
 #include "VoidAndCluster/Reference/ReferenceController2Dx1Dx1D.h"
 #include "VoidAndCluster/Reference/ReferenceController2Dx2D.h"
 #include "VoidAndCluster/SliceCache/SliceCacheController2Dx1Dx1D.h"
 #include "VoidAndCluster/SliceCache/SliceCacheController2Dx2D.h"
+#include "VoidAndCluster/SliceCache/SliceCacheControllerND.h"
 
-STBNMaker::STBNMaker(Dimensions dims, SigmaPerDimension sigmas, float initialBinaryPatternDensity, ScalarImplementation scalarImplementation) :
-    m_numPixels(dims.x * dims.y * dims.z * dims.w),
-    m_kernelX(sigmas.x, dims.x),
-    m_kernelY(sigmas.y, dims.y),
-    m_kernelZ(sigmas.z, dims.z),
-    m_kernelW(sigmas.w, dims.w),
-    m_data(dims),
-    m_sigmas(sigmas),
-    m_initialBinaryPatternDensity(initialBinaryPatternDensity)
+bool ControllerUsesEnergy(ScalarImplementation scalarImplementation)
+{
+    switch (scalarImplementation)
+    {
+    case ScalarImplementation::FixedPoint32_2Dx1Dx1D:
+    case ScalarImplementation::FixedPoint64_2Dx1Dx1D:
+    case ScalarImplementation::Distributed_2Dx1Dx1D:
+        return false;
+    default:
+        return true;
+    }
+}
+
+std::unique_ptr<VCController> MakeVCController(ScalarImplementation scalarImplementation, STBNData& data, const SymmetricKernel& kernelX, const SymmetricKernel& kernelY, const SymmetricKernel& kernelZ, const SymmetricKernel& kernelW, const std::vector<int>& groups, const TileOptions& tileOptions)
 {
     switch (scalarImplementation)
     {
     case ScalarImplementation::Reference_2Dx1Dx1D:
-        m_updater = std::make_unique<ReferenceController2Dx1Dx1D>(m_data, m_kernelX, m_kernelY, m_kernelZ, m_kernelW);
-        break;
+        return std::make_unique<ReferenceController2Dx1Dx1D>(data, kernelX, kernelY, kernelZ, kernelW);
     case ScalarImplementation::Reference_2Dx2D:
-        m_updater = std::make_unique<ReferenceController2Dx2D>(m_data, m_kernelX, m_kernelY, m_kernelZ, m_kernelW);
-        break;
+        return std::make_unique<ReferenceController2Dx2D>(data, kernelX, kernelY, kernelZ, kernelW);
     case ScalarImplementation::SliceCache_2Dx1Dx1D:
-        m_updater = std::make_unique<SliceCacheController2Dx1Dx1D>(m_data, m_kernelX, m_kernelY, m_kernelZ, m_kernelW);
-        break;
+        return std::make_unique<SliceCacheController2Dx1Dx1D>(data, kernelX, kernelY, kernelZ, kernelW);
     case ScalarImplementation::SliceCache_2Dx2D:
-        m_updater = std::make_unique<SliceCacheController2Dx2D>(m_data, m_kernelX, m_kernelY, m_kernelZ, m_kernelW);
-        break;
+        return std::make_unique<SliceCacheController2Dx2D>(data, kernelX, kernelY, kernelZ, kernelW);
+    case ScalarImplementation::SliceCache_ND:
+        return std::make_unique<SliceCacheControllerND>(data, BlueNoiseTexturesND::MakeGroupMasks(groups, 4), kernelX, kernelY, kernelZ, kernelW);
+    case ScalarImplementation::Auto_2Dx1Dx1D:
+        return std::make_unique<AutoController2Dx1Dx1D>(data, kernelX, kernelY, kernelZ, kernelW);
+    case ScalarImplementation::FixedPoint32_2Dx1Dx1D:
+        return std::make_unique<FixedPointController2Dx1Dx1D<int32_t>>(data, kernelX, kernelY, kernelZ, kernelW);
+    case ScalarImplementation::FixedPoint64_2Dx1Dx1D:
+        return std::make_unique<FixedPointController2Dx1Dx1D<int64_t>>(data, kernelX, kernelY, kernelZ, kernelW);
+    case ScalarImplementation::Distributed_2Dx1Dx1D:
+        return std::make_unique<DistributedController2Dx1Dx1D>(data, kernelX, kernelY, kernelZ, kernelW, tileOptions);
     }
+    return nullptr;
+}
+
+STBNMaker::STBNMaker(Dimensions dims, SigmaPerDimension sigmas, float initialBinaryPatternDensity, ScalarImplementation scalarImplementation, const std::vector<int>& groups, const TileOptions& tileOptions) :
+    m_numPixels(dims.x * dims.y * dims.z * dims.w),
+    m_kernelX(sigmas.x, dims.x),
+    m_kernelY(sigmas.y, dims.y),
+    m_kernelZ(sigmas.z, dims.z),
+    m_kernelW(sigmas.w, dims.w),
+    m_data(dims, ControllerUsesEnergy(scalarImplementation)),
+    m_sigmas(sigmas),
+    m_initialBinaryPatternDensity(initialBinaryPatternDensity),
+    m_groups(groups)
+{
+    m_updater = MakeVCController(scalarImplementation, m_data, m_kernelX, m_kernelY, m_kernelZ, m_kernelW, m_groups, tileOptions);
 
     m_vc = std::make_unique<VoidAndCluster>(initialBinaryPatternDensity, m_updater.get());
 }
@@ -48,17 +79,32 @@ void STBNMaker::Make()
     m_vc->Phase3();
 }
 
+void STBNMaker::SetMaxRank(size_t maxRank)
+{
+    m_vc->SetMaxRank(maxRank);
+}
+
+void STBNMaker::MakeFromPattern(std::span<const size_t> onPixels)
+{
+    m_vc->InitializeFromPattern(onPixels);
+    m_vc->ReorganizeToBlueNoise();
+    m_vc->Phase1();
+    m_vc->Phase2();
+    m_vc->Phase3();
+}
+
 BlueNoiseTexturesND STBNMaker::GetBlueNoiseTextures() const
 {
     BlueNoiseTexturesND textures;
-    textures.Init({ static_cast<int>(m_data.dimensions.x), static_cast<int>(m_data.dimensions.y), static_cast<int>(m_data.dimensions.z), 1 }, { m_sigmas.x, m_sigmas.y, m_sigmas.z, 1 }, { 0, 0, 1, 2 });
+    textures.Init({ static_cast<int>(m_data.dimensions.x), static_cast<int>(m_data.dimensions.y), static_cast<int>(m_data.dimensions.z), 1 }, { m_sigmas.x, m_sigmas.y, m_sigmas.z, 1 }, m_groups);
     auto& pixels = textures.GetPixels();
+    std::vector<size_t> pixelRank = PixelValuesToLinearOrder(m_data.pixelRank, m_data.dimensions);
     for (size_t pixelIndex = 0; pixelIndex < m_numPixels; ++pixelIndex)
     {
         Pixel& pixel = pixels[pixelIndex];
         pixel.energy = 0.0f;
         pixel.on = true;
-        pixel.rank = static_cast<int>(m_data.pixelRank[pixelIndex]);
+        pixel.rank = static_cast<int>(pixelRank[pixelIndex]);
     }
 
     return textures;
@@ -2,10 +2,13 @@
 
 #include <array>
 #include <memory>
+#include <span>
+#include <vector>
 
 #include "BlueNoiseTexturesND.h"
 #include "Kernel/BlueNoiseGaussianKernel.h"
 #include "STBNData.h"
+#include "VoidAndCluster/Distributed/DistributedController2Dx1Dx1D.h"
 #include "VoidAndCluster/VCController.h"
 
 class VoidAndCluster;
@@ -15,16 +18,33 @@ enum ScalarImplementation
     Reference_2Dx1Dx1D,
     Reference_2Dx2D,
     SliceCache_2Dx1Dx1D,
-    SliceCache_2Dx2D
+    SliceCache_2Dx2D,
+    SliceCache_ND,      // Any grouping of the dimensions, given as BlueNoiseTexturesND style groups
+    Auto_2Dx1Dx1D,      // Switches query strategy as it goes. Same results as Reference_2Dx1Dx1D.
+    FixedPoint32_2Dx1Dx1D,  // Slice cache with int32 fixed point energy. Splats are exact and order independent.
+    FixedPoint64_2Dx1Dx1D,  // Same with int64, for more fraction bits
+    Distributed_2Dx1Dx1D    // Slice cache split into tiles, on threads or processes. Same results as SliceCache_2Dx1Dx1D.
 };
 
+// Whether the controller works on STBNData::energy. The fixed point controllers keep their own integer energy, and
+// Distributed_2Dx1Dx1D keeps the energy in its tiles.
+bool ControllerUsesEnergy(ScalarImplementation scalarImplementation);
+
+std::unique_ptr<VCController> MakeVCController(ScalarImplementation scalarImplementation, STBNData& data, const SymmetricKernel& kernelX, const SymmetricKernel& kernelY, const SymmetricKernel& kernelZ, const SymmetricKernel& kernelW, const std::vector<int>& groups = { 0, 0, 1, 2 }, const TileOptions& tileOptions = {});
+
 class STBNMaker
 {
 public:
-    STBNMaker(Dimensions dims, SigmaPerDimension sigmas, float initialBinaryPatternDensity, ScalarImplementation scalarImplementation);
+    STBNMaker(Dimensions dims, SigmaPerDimension sigmas, float initialBinaryPatternDensity, ScalarImplementation scalarImplementation, const std::vector<int>& groups = { 0, 0, 1, 2 }, const TileOptions& tileOptions = {});
 
     void Make();
 
+    // Stops once ranks 0 to maxRank-1 are assigned. See VoidAndCluster::SetMaxRank.
+    void SetMaxRank(size_t maxRank);
+
+    // Same as Make, but starts from the given on pixels instead of white noise
+    void MakeFromPattern(std::span<const size_t> onPixels);
+
     BlueNoiseTexturesND GetBlueNoiseTextures() const;
 
     const VoidAndCluster* GetVoidAndCluster() const;
@@ -44,5 +64,6 @@ private:
 
     SigmaPerDimension m_sigmas;
     float m_initialBinaryPatternDensity;
+    std::vector<int> m_groups;
 };
 
@@ -0,0 +1,107 @@
+#include "STBNMultiresolutionMaker.h"
+
+#include <algorithm>
+
+#include "STBNRandom.h"
+#include "Utils/PixelCoords.h"
+#include "VoidAndCluster/VoidAndCluster.h"
+
+namespace
+{
+
+bool CanHalve(const Dimensions& dims)
+{
+    return (dims.x % 2 == 0) && (dims.y % 2 == 0) && (dims.x / 2 >= STBNMultiresolutionMaker::c_minCoarseDim) && (dims.y / 2 >= STBNMultiresolutionMaker::c_minCoarseDim);
+}
+
+}
+
+STBNMultiresolutionMaker::STBNMultiresolutionMaker(Dimensions dims, SigmaPerDimension sigmas, float initialBinaryPatternDensity, ScalarImplementation scalarImplementation, size_t numLevels, const std::vector<int>& groups, const TileOptions& tileOptions) :
+    m_dims(dims),
+    m_initialBinaryPatternDensity(initialBinaryPatternDensity),
+    m_maker(dims, sigmas, initialBinaryPatternDensity, scalarImplementation, groups, tileOptions)
+{
+    if (numLevels > 1 && CanHalve(dims))
+    {
+        // The coarse levels are small enough that the layout doesn't matter, and x / 2 may not be brickable
+        Dimensions coarseDims = { dims.x / 2, dims.y / 2, dims.z, dims.w };
+        SigmaPerDimension coarseSigmas = { sigmas.x / 2.0f, sigmas.y / 2.0f, sigmas.z, sigmas.w };
+        m_coarse = std::make_unique<STBNMultiresolutionMaker>(coarseDims, coarseSigmas, initialBinaryPatternDensity, scalarImplementation, numLevels - 1, groups, tileOptions);
+        m_coarse->SetMaxRank(NumSeedPixels());
+    }
+}
+
+void STBNMultiresolutionMaker::SetMaxRank(size_t maxRank)
+{
+    m_maker.SetMaxRank(maxRank);
+}
+
+size_t STBNMultiresolutionMaker::NumSeedPixels() const
+{
+    // Same count as InitializeToWhiteNoise
+    size_t numPixels = m_dims.x * m_dims.y * m_dims.z * m_dims.w;
+    return std::max(size_t(float(numPixels) * m_initialBinaryPatternDensity), (size_t)2);
+}
+
+void STBNMultiresolutionMaker::Make()
+{
+    if (!m_coarse)
+    {
+        m_maker.Make();
+        return;
+    }
+
+    m_coarse->Make();
+    std::vector<size_t> onPixels = UpsampleCoarsePattern();
+    m_maker.MakeFromPattern(onPixels);
+}
+
+std::vector<size_t> STBNMultiresolutionMaker::UpsampleCoarsePattern() const
+{
+    // Coarse pixels are taken in rank order, so the seed is the coarse progressive pattern at 4x the density,
+    // and each one lands on a random one of its 4 fine pixels. If there are more seeds than coarse pixels,
+    // later passes take the next of the 4 fine pixels.
+    const STBNData& coarseData = m_coarse->GetVoidAndCluster()->GetSTBNData();
+    size_t count = NumSeedPixels();
+
+    // Only the first count ranks were assigned, the rest are numPixels
+    std::vector<size_t> coarseByRank(coarseData.numPixels);
+    for (size_t pixelIndex = 0; pixelIndex < coarseData.numPixels; ++pixelIndex)
+    {
+        if (coarseData.pixelRank[pixelIndex] < coarseData.numPixels)
+            coarseByRank[coarseData.pixelRank[pixelIndex]] = pixelIndex;
+    }
+
+    pcg32_random_t rng = GetRNG();
+    std::vector<uint32_t> firstSubPixel(coarseData.numPixels);
+    for (uint32_t& subPixel : firstSubPixel)
+        subPixel = pcg32_boundedrand_r(&rng, 4);
+
+    std::vector<size_t> ret(std::min(count, 4 * coarseData.numPixels));
+    for (size_t index = 0; index < ret.size(); ++index)
+    {
+        size_t coarsePixelIndex = coarseByRank[index % coarseData.numPixels];
+        size_t subPixel = (firstSubPixel[coarsePixelIndex] + index / coarseData.numPixels) % 4;
+
+        PixelCoords coords = PixelIndexToPixelCoords(coarsePixelIndex, coarseData.dimensions);
+        coords.x = coords.x * 2 + subPixel % 2;
+        coords.y = coords.y * 2 + subPixel / 2;
+        ret[index] = PixelCoordsToPixelIndex(coords, m_dims);
+    }
+    return ret;
+}
+
+BlueNoiseTexturesND STBNMultiresolutionMaker::GetBlueNoiseTextures() const
+{
+    return m_maker.GetBlueNoiseTextures();
+}
+
+const VoidAndCluster* STBNMultiresolutionMaker::GetVoidAndCluster() const
+{
+    return m_maker.GetVoidAndCluster();
+}
+
+size_t STBNMultiresolutionMaker::GetNumLevels() const
+{
+    return m_coarse ? m_coarse->GetNumLevels() + 1 : 1;
+}
\ No newline at end of file
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "BlueNoiseTexturesND.h"
+#include "STBNData.h"
+#include "STBNMaker.h"
+
+// Coarse to fine scalar STBN. Each level below the finest solves at half the X and Y resolution with
+// half the X and Y sigma, and the first ranks of that solve, upsampled, seed the initial binary pattern of
+// the level above instead of white noise. The seed is already blue at the coarse scale, so the
+// ReorganizeToBlueNoise swaps mostly just refine it, and coarse levels only rank as many pixels as are seeded.
+class STBNMultiresolutionMaker
+{
+public:
+    // numLevels of 1 is the same as STBNMaker. Levels stop early once X or Y would go odd or below c_minCoarseDim.
+    STBNMultiresolutionMaker(Dimensions dims, SigmaPerDimension sigmas, float initialBinaryPatternDensity, ScalarImplementation scalarImplementation, size_t numLevels, const std::vector<int>& groups = { 0, 0, 1, 2 }, const TileOptions& tileOptions = {});
+
+    // Applies to the finest level. Coarse levels always stop after the ranks their seeds need.
+    void SetMaxRank(size_t maxRank);
+
+    void Make();
+
+    BlueNoiseTexturesND GetBlueNoiseTextures() const;
+
+    const VoidAndCluster* GetVoidAndCluster() const;
+
+    // Number of levels that will actually be solved, including this one
+    size_t GetNumLevels() const;
+
+    static const size_t c_minCoarseDim = 16;
+
+private:
+    Dimensions m_dims;
+    float m_initialBinaryPatternDensity;
+
+    std::unique_ptr<STBNMultiresolutionMaker> m_coarse;
+    STBNMaker m_maker;
+
+    size_t NumSeedPixels() const;
+    std::vector<size_t> UpsampleCoarsePattern() const;
+};
\ No newline at end of file
@@ -1,6 +1,15 @@
 #include "Dimensions.h"
 
+#include "PixelCoords.h"
+
 bool operator==(const Dimensions& a, const Dimensions& b)
 {
-    return (a.x == b.x) && (a.y == b.y) && (a.z == b.z) && (a.w == b.w);
+    return (a.x == b.x) && (a.y == b.y) && (a.z == b.z) && (a.w == b.w) && (a.layout == b.layout);
+}
+
+bool IsLayoutSupported(const Dimensions& dims)
+{
+    if (dims.layout == PixelLayout::Bricked)
+        return (dims.x % c_brickSizeX == 0) && (dims.y % c_brickSizeY == 0) && (dims.z % c_brickSizeZ == 0);
+    return true;
 }
\ No newline at end of file
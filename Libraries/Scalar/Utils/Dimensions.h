@@ -1,15 +1,29 @@
 #pragma once
 
-union Dimensions
+// How pixels are ordered in memory. Everything goes through PixelCoordsToPixelIndex, so only it and its inverse need to know.
+enum class PixelLayout
 {
-    struct
+    Linear,     // x fastest, then y, then z, then w
+    Bricked     // 8x8x4 XYZ bricks stored contiguously, x fastest inside a brick. Z taps land a few cache lines apart instead of a slice apart.
+};
+
+struct Dimensions
+{
+    union
     {
-        size_t x;
-        size_t y;
-        size_t z;
-        size_t w;
+        struct
+        {
+            size_t x;
+            size_t y;
+            size_t z;
+            size_t w;
+        };
+        size_t dim[4];
     };
-    size_t dim[4];
+    PixelLayout layout = PixelLayout::Linear;
 };
 
-bool operator==(const Dimensions& a, const Dimensions& b);
\ No newline at end of file
+bool operator==(const Dimensions& a, const Dimensions& b);
+
+// Bricked needs x and y to be multiples of 8, and z a multiple of 4
+bool IsLayoutSupported(const Dimensions& dims);
\ No newline at end of file
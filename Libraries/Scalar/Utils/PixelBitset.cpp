@@ -0,0 +1,56 @@
+#include "PixelBitset.h"
+
+#include <algorithm>
+
+PixelBitset::PixelBitset(size_t size, bool value)
+{
+    resize(size, value);
+}
+
+void PixelBitset::resize(size_t size, bool value)
+{
+    // Set the new bits in the current last word before it grows
+    if (value && size > m_size && (m_size % c_wordBits) != 0)
+        m_words.back() |= ~uint64_t(0) << (m_size % c_wordBits);
+
+    m_words.resize((size + c_wordBits - 1) / c_wordBits, value ? ~uint64_t(0) : 0);
+    m_size = size;
+    ClearUnusedBits();
+}
+
+void PixelBitset::Fill(bool value)
+{
+    std::fill(m_words.begin(), m_words.end(), value ? ~uint64_t(0) : 0);
+    ClearUnusedBits();
+}
+
+void PixelBitset::FlipAll()
+{
+    for (uint64_t& word : m_words)
+        word = ~word;
+    ClearUnusedBits();
+}
+
+size_t PixelBitset::Count() const
+{
+    size_t ret = 0;
+    for (uint64_t word : m_words)
+        ret += size_t(std::popcount(word));
+    return ret;
+}
+
+bool PixelBitset::operator==(const PixelBitset& other) const
+{
+    return m_size == other.m_size && m_words == other.m_words;
+}
+
+bool PixelBitset::operator!=(const PixelBitset& other) const
+{
+    return !(*this == other);
+}
+
+void PixelBitset::ClearUnusedBits()
+{
+    if ((m_size % c_wordBits) != 0)
+        m_words.back() &= ~(~uint64_t(0) << (m_size % c_wordBits));
+}
\ No newline at end of file
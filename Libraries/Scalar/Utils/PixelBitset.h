@@ -0,0 +1,98 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <vector>
+
+// One bit per pixel, packed into 64 bit words.
+// Bits past size() in the last word are always clear, so whole word operations don't need to mask them.
+class PixelBitset
+{
+public:
+    static const size_t c_wordBits = 64;
+
+    PixelBitset() = default;
+    PixelBitset(size_t size, bool value = false);
+
+    void resize(size_t size, bool value = false);
+
+    size_t size() const { return m_size; }
+
+    bool operator[](size_t index) const { return (m_words[index / c_wordBits] >> (index % c_wordBits)) & 1; }
+
+    void Set(size_t index, bool value)
+    {
+        uint64_t bit = uint64_t(1) << (index % c_wordBits);
+        if (value)
+            m_words[index / c_wordBits] |= bit;
+        else
+            m_words[index / c_wordBits] &= ~bit;
+    }
+
+    void Flip(size_t index) { m_words[index / c_wordBits] ^= uint64_t(1) << (index % c_wordBits); }
+
+    void Fill(bool value);
+
+    // Flips every bit a word at a time
+    void FlipAll();
+
+    // Number of set bits
+    size_t Count() const;
+
+    size_t NumWords() const { return m_words.size(); }
+
+    uint64_t GetWord(size_t wordIndex) const { return m_words[wordIndex]; }
+
+    // numBits (at most 32) bits starting at index, as the low bits of the result
+    uint32_t GetBits(size_t index, size_t numBits) const
+    {
+        size_t wordIndex = index / c_wordBits;
+        size_t shift = index % c_wordBits;
+        uint64_t bits = m_words[wordIndex] >> shift;
+        if (shift + numBits > c_wordBits)
+            bits |= m_words[wordIndex + 1] << (c_wordBits - shift);
+        return uint32_t(bits & ((uint64_t(1) << numBits) - 1));
+    }
+
+    // Calls lambda(index) for each bit in [begin, end) that equals VALUE, in ascending order.
+    // Words with no such bits are skipped without looking at their pixels.
+    template<bool VALUE, typename LAMBDA>
+    void ForEachBit(size_t begin, size_t end, const LAMBDA& lambda) const
+    {
+        if (begin >= end)
+            return;
+
+        size_t firstWord = begin / c_wordBits;
+        size_t lastWord = (end - 1) / c_wordBits;
+        for (size_t wordIndex = firstWord; wordIndex <= lastWord; ++wordIndex)
+        {
+            uint64_t word = VALUE ? m_words[wordIndex] : ~m_words[wordIndex];
+            if (wordIndex == firstWord)
+                word &= ~uint64_t(0) << (begin % c_wordBits);
+            if (wordIndex == lastWord && (end % c_wordBits) != 0)
+                word &= ~(~uint64_t(0) << (end % c_wordBits));
+
+            size_t baseIndex = wordIndex * c_wordBits;
+            while (word)
+            {
+                lambda(baseIndex + size_t(std::countr_zero(word)));
+                word &= word - 1;
+            }
+        }
+    }
+
+    template<bool VALUE, typename LAMBDA>
+    void ForEachBit(const LAMBDA& lambda) const
+    {
+        ForEachBit<VALUE>(0, m_size, lambda);
+    }
+
+    bool operator==(const PixelBitset& other) const;
+    bool operator!=(const PixelBitset& other) const;
+
+private:
+    void ClearUnusedBits();
+
+    std::vector<uint64_t> m_words;
+    size_t m_size = 0;
+};
\ No newline at end of file
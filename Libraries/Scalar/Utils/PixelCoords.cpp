@@ -6,6 +6,21 @@ size_t PixelCoordsToPixelIndex(const PixelCoords& pixelCoords, const Dimensions&
 {
     size_t ret = 0;
 
+    if (dims.layout == PixelLayout::Bricked)
+    {
+        ret += pixelCoords[3];
+        ret *= dims.z / c_brickSizeZ;
+        ret += pixelCoords[2] / c_brickSizeZ;
+        ret *= dims.y / c_brickSizeY;
+        ret += pixelCoords[1] / c_brickSizeY;
+        ret *= dims.x / c_brickSizeX;
+        ret += pixelCoords[0] / c_brickSizeX;
+        ret *= c_brickPixelCount;
+        ret += ((pixelCoords[2] % c_brickSizeZ) * c_brickSizeY + (pixelCoords[1] % c_brickSizeY)) * c_brickSizeX + (pixelCoords[0] % c_brickSizeX);
+
+        return ret;
+    }
+
     ret += pixelCoords[3];
     ret *= dims.z;
     ret += pixelCoords[2];
@@ -21,10 +36,41 @@ PixelCoords PixelIndexToPixelCoords(size_t pixelIndex, const Dimensions& dims)
 {
     PixelCoords ret;
 
+    if (dims.layout == PixelLayout::Bricked)
+    {
+        size_t brickIndex = pixelIndex / c_brickPixelCount;
+        size_t brickPixelIndex = pixelIndex % c_brickPixelCount;
+        size_t bricksX = dims.x / c_brickSizeX;
+        size_t bricksY = dims.y / c_brickSizeY;
+        size_t bricksZ = dims.z / c_brickSizeZ;
+
+        ret[0] = (brickIndex % bricksX) * c_brickSizeX + brickPixelIndex % c_brickSizeX;
+        ret[1] = ((brickIndex / bricksX) % bricksY) * c_brickSizeY + (brickPixelIndex / c_brickSizeX) % c_brickSizeY;
+        ret[2] = ((brickIndex / (bricksX * bricksY)) % bricksZ) * c_brickSizeZ + brickPixelIndex / (c_brickSizeX * c_brickSizeY);
+        ret[3] = brickIndex / (bricksX * bricksY * bricksZ);
+
+        return ret;
+    }
+
     ret[0] = (pixelIndex % (dims.x)) / (1);
     ret[1] = (pixelIndex % (dims.x * dims.y)) / (dims.x);
     ret[2] = (pixelIndex % (dims.x * dims.y * dims.z)) / (dims.x * dims.y);
-    ret[3] = (pixelIndex % (dims.x * dims.y * dims.z * dims.y)) / (dims.x * dims.y * dims.z);
+    ret[3] = (pixelIndex % (dims.x * dims.y * dims.z * dims.w)) / (dims.x * dims.y * dims.z);
+
+    return ret;
+}
+
+std::vector<size_t> PixelValuesToLinearOrder(const ArenaVector<size_t>& values, const Dimensions& dims)
+{
+    if (dims.layout == PixelLayout::Linear)
+        return std::vector<size_t>(values.begin(), values.end());
+
+    Dimensions linearDims = dims;
+    linearDims.layout = PixelLayout::Linear;
+
+    std::vector<size_t> ret(values.size());
+    for (size_t pixelIndex = 0; pixelIndex < values.size(); ++pixelIndex)
+        ret[PixelCoordsToPixelIndex(PixelIndexToPixelCoords(pixelIndex, dims), linearDims)] = values[pixelIndex];
 
     return ret;
 }
\ No newline at end of file
@@ -1,6 +1,10 @@
 #pragma once
 
-union Dimensions;
+#include <vector>
+
+#include "ArenaAllocator.h"
+
+struct Dimensions;
 
 union PixelCoords
 {
@@ -16,6 +20,15 @@ union PixelCoords
     inline size_t& operator[](size_t index) { return coords[index]; }
 };
 
+// Brick size of PixelLayout::Bricked
+static const size_t c_brickSizeX = 8;
+static const size_t c_brickSizeY = 8;
+static const size_t c_brickSizeZ = 4;
+static const size_t c_brickPixelCount = c_brickSizeX * c_brickSizeY * c_brickSizeZ;
+
 size_t PixelCoordsToPixelIndex(const PixelCoords& pixelCoords, const Dimensions& dims);
 
-PixelCoords PixelIndexToPixelCoords(size_t pixelIndex, const Dimensions& dims);
\ No newline at end of file
+PixelCoords PixelIndexToPixelCoords(size_t pixelIndex, const Dimensions& dims);
+
+// Reorders per pixel values from the layout of dims to linear order, for writing out
+std::vector<size_t> PixelValuesToLinearOrder(const ArenaVector<size_t>& values, const Dimensions& dims);
\ No newline at end of file
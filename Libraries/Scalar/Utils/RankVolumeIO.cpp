@@ -0,0 +1,113 @@
+#include "RankVolumeIO.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <numeric>
+
+#include "stb_image.h"
+
+#include "Utils/Dimensions.h"
+
+namespace
+{
+
+size_t NumPixels(const Dimensions& dims)
+{
+    return dims.x * dims.y * dims.z * dims.w;
+}
+
+// Turns arbitrary per pixel sort keys into a dense 0..N-1 rank order
+template<typename T>
+void KeysToRanks(const std::vector<T>& keys, std::vector<size_t>& ranks)
+{
+    std::vector<size_t> order(keys.size());
+    std::iota(order.begin(), order.end(), size_t(0));
+    std::stable_sort(order.begin(), order.end(), [&keys](size_t a, size_t b) { return keys[a] < keys[b]; });
+
+    ranks.resize(keys.size());
+    for (size_t rank = 0; rank < order.size(); ++rank)
+        ranks[order[rank]] = rank;
+}
+
+}
+
+bool LoadRanksFromPNGs(const std::string& fileNamePattern, const Dimensions& dims, std::vector<size_t>& ranks)
+{
+    const size_t sliceSize = dims.x * dims.y;
+    const size_t numSlices = dims.z * dims.w;
+
+    std::vector<unsigned char> values(NumPixels(dims));
+    for (size_t sliceIndex = 0; sliceIndex < numSlices; ++sliceIndex)
+    {
+        char fileName[1024];
+        snprintf(fileName, sizeof(fileName), fileNamePattern.c_str(), int(sliceIndex));
+
+        int width, height, channels;
+        unsigned char* pixels = stbi_load(fileName, &width, &height, &channels, 1);
+        if (!pixels)
+            return false;
+
+        bool sizeMatches = (size_t(width) == dims.x) && (size_t(height) == dims.y);
+        if (sizeMatches)
+            std::copy(pixels, pixels + sliceSize, &values[sliceIndex * sliceSize]);
+
+        stbi_image_free(pixels);
+
+        if (!sizeMatches)
+            return false;
+    }
+
+    KeysToRanks(values, ranks);
+    return true;
+}
+
+bool LoadRanksFromRaw(const std::string& filePath, const Dimensions& dims, std::vector<size_t>& ranks)
+{
+    std::ifstream file(filePath, std::ios::binary);
+    if (!file)
+        return false;
+
+    std::vector<uint32_t> values(NumPixels(dims));
+    file.read(reinterpret_cast<char*>(values.data()), std::streamsize(values.size() * sizeof(uint32_t)));
+    if (size_t(file.gcount()) != values.size() * sizeof(uint32_t))
+        return false;
+
+    // Raw ranks should already be a permutation, but sorting also accepts rank volumes from other tools
+    KeysToRanks(values, ranks);
+    return true;
+}
+
+bool SaveRanksToRaw(const std::string& filePath, const std::vector<size_t>& ranks)
+{
+    std::ofstream file(filePath, std::ios::binary);
+    if (!file)
+        return false;
+
+    std::vector<uint32_t> values(ranks.begin(), ranks.end());
+    file.write(reinterpret_cast<const char*>(values.data()), std::streamsize(values.size() * sizeof(uint32_t)));
+    return bool(file);
+}
+
+
+bool SaveProgressivePointsToRaw(const std::string& filePath, const std::vector<size_t>& ranks, size_t count)
+{
+    std::ofstream file(filePath, std::ios::binary);
+    if (!file)
+        return false;
+
+    std::vector<uint32_t> points(count, UINT32_MAX);
+    size_t numPoints = 0;
+    for (size_t pixelIndex = 0; pixelIndex < ranks.size(); ++pixelIndex)
+    {
+        if (ranks[pixelIndex] < count)
+        {
+            points[ranks[pixelIndex]] = uint32_t(pixelIndex);
+            numPoints++;
+        }
+    }
+    points.resize(numPoints);
+
+    file.write(reinterpret_cast<const char*>(points.data()), std::streamsize(points.size() * sizeof(uint32_t)));
+    return bool(file);
+}
\ No newline at end of file
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+struct Dimensions;
+
+// Loads the XY slices written by SaveTextures (one 8 bit png per Z/W slice, fileNamePattern containing %i).
+// The png values are quantized, so ranks are recovered by sorting on value with ties broken by pixel index.
+bool LoadRanksFromPNGs(const std::string& fileNamePattern, const Dimensions& dims, std::vector<size_t>& ranks);
+
+// Raw rank volumes are one little endian uint32 per pixel, x fastest, exactly as STBNData::pixelRank is laid out.
+bool LoadRanksFromRaw(const std::string& filePath, const Dimensions& dims, std::vector<size_t>& ranks);
+
+bool SaveRanksToRaw(const std::string& filePath, const std::vector<size_t>& ranks);
+
+
+// Progressive point lists are the pixels with ranks below count, in rank order, as one little endian uint32
+// linear pixel index (x fastest) each. Pixels without a rank below count, e.g. after a max rank, are left out.
+bool SaveProgressivePointsToRaw(const std::string& filePath, const std::vector<size_t>& ranks, size_t count);
\ No newline at end of file
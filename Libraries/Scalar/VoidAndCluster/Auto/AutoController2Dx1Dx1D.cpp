@@ -0,0 +1,493 @@
+#include "AutoController2Dx1Dx1D.h"
+
+#include <algorithm>
+#include <cfloat>
+
+#include "Utils/PixelCoords.h"
+#include "VoidAndCluster/SliceCache/SliceCacheFuncs.h"
+
+namespace
+{
+    // Queries between re-evaluations of the strategy
+    const size_t c_evaluateInterval = 256;
+
+    // Only switch when the best strategy is estimated to cost this fraction of the current one or less.
+    // Switching isn't free: a slice cache starts fully dirty and the pixel lists are rebuilt.
+    const float c_switchThreshold = 0.75f;
+
+    // A run of splats with no queries longer than this fraction of the pixels is a phase like Phase1Part2
+    // or Phase3Part1, where keeping acceleration structures up to date buys nothing.
+    const size_t c_idleSplatDivisor = 16;
+
+    inline size_t CoordsToXYSlice(const PixelCoords& coords, const Dimensions& dims)
+    {
+        return (coords.w * dims.z) + coords.z;
+    }
+}
+
+AutoController2Dx1Dx1D::AutoController2Dx1Dx1D(STBNData& data, SymmetricKernel kernelX, SymmetricKernel kernelY, SymmetricKernel kernelZ, SymmetricKernel kernelW) :
+    m_data(data),
+    m_kernelX(kernelX),
+    m_kernelY(kernelY),
+    m_kernelZ(kernelZ),
+    m_kernelW(kernelW),
+    m_strategy(AutoStrategy::SliceCache),
+    m_pixelOnCount(data.pixelOn.Count()),
+    m_cache(data.dimensions),
+    m_queryIsCluster(false),
+    m_phaseBoundary(true),
+    m_splatsSinceQuery(0),
+    m_windowQueries{ 0, 0 },
+    m_windowPixelsVisited{ 0, 0 }
+{
+    // Optimistic until measured: one dirty slice per query
+    m_sliceCacheCost[0] = m_sliceCacheCost[1] = float(m_cache.numSlicesXY + m_cache.sliceSizeXY);
+}
+
+STBNData& AutoController2Dx1Dx1D::GetSTBNData()
+{
+    return m_data;
+}
+
+size_t AutoController2Dx1Dx1D::GetPixelOnCount() const
+{
+    return m_pixelOnCount;
+}
+
+size_t AutoController2Dx1Dx1D::GetTightestCluster()
+{
+    BeginQuery(true);
+
+    size_t pixelsVisited = 0;
+    size_t clusterPixelIndex = 0;
+    switch (m_strategy)
+    {
+        case AutoStrategy::FullScan:
+        {
+            float maxEnergy = -FLT_MAX;
+            m_data.pixelOn.ForEachBit<true>(
+                [&](size_t pixelIndex)
+                {
+                    if (m_data.energy[pixelIndex] > maxEnergy)
+                    {
+                        maxEnergy = m_data.energy[pixelIndex];
+                        clusterPixelIndex = pixelIndex;
+                    }
+                }
+            );
+            pixelsVisited = m_data.numPixels;
+            break;
+        }
+        case AutoStrategy::SliceCache:
+        {
+            float maxEnergy = -FLT_MAX;
+            pixelsVisited = m_cache.numSlicesXY;
+            for (size_t sliceXYIndex = 0; sliceXYIndex < m_cache.numSlicesXY; sliceXYIndex++)
+            {
+                if (m_cache.dirtyMax[sliceXYIndex])
+                {
+                    size_t sliceTightestClusterIndex = 0;
+                    float sliceMaxEnergy = -FLT_MAX;
+                    ForEachPixelInXYSlice<true>(m_cache, m_data.pixelOn, sliceXYIndex,
+                        [&](size_t i)
+                        {
+                            if (m_data.energy[i] > sliceMaxEnergy)
+                            {
+                                sliceMaxEnergy = m_data.energy[i];
+                                sliceTightestClusterIndex = i;
+                            }
+                        }
+                    );
+                    m_cache.maxValue[sliceXYIndex] = sliceMaxEnergy;
+                    m_cache.maxValueIndex[sliceXYIndex] = sliceTightestClusterIndex;
+                    m_cache.dirtyMax[sliceXYIndex] = false;
+                    pixelsVisited += m_cache.sliceSizeXY;
+                }
+
+                if (m_cache.maxValue[sliceXYIndex] > maxEnergy || (m_cache.maxValue[sliceXYIndex] == maxEnergy && m_cache.maxValueIndex[sliceXYIndex] < clusterPixelIndex))
+                {
+                    maxEnergy = m_cache.maxValue[sliceXYIndex];
+                    clusterPixelIndex = m_cache.maxValueIndex[sliceXYIndex];
+                }
+            }
+            break;
+        }
+        case AutoStrategy::PixelList:
+        {
+            // The list isn't in pixel index order, so break ties on the index like a full scan would
+            float maxEnergy = -FLT_MAX;
+            for (size_t listIndex = 0; listIndex < m_pixelOnCount; ++listIndex)
+            {
+                size_t pixelIndex = m_pixelList[listIndex];
+                float energy = m_data.energy[pixelIndex];
+                if (energy > maxEnergy || (energy == maxEnergy && pixelIndex < clusterPixelIndex))
+                {
+                    maxEnergy = energy;
+                    clusterPixelIndex = pixelIndex;
+                }
+            }
+            pixelsVisited = m_pixelOnCount;
+            break;
+        }
+    }
+
+    EndQuery(pixelsVisited);
+    return clusterPixelIndex;
+}
+
+size_t AutoController2Dx1Dx1D::GetLargestVoid()
+{
+    BeginQuery(false);
+
+    size_t pixelsVisited = 0;
+    size_t voidPixelIndex = 0;
+    switch (m_strategy)
+    {
+        case AutoStrategy::FullScan:
+        {
+            float minEnergy = FLT_MAX;
+            m_data.pixelOn.ForEachBit<false>(
+                [&](size_t pixelIndex)
+                {
+                    if (m_data.energy[pixelIndex] < minEnergy)
+                    {
+                        minEnergy = m_data.energy[pixelIndex];
+                        voidPixelIndex = pixelIndex;
+                    }
+                }
+            );
+            pixelsVisited = m_data.numPixels;
+            break;
+        }
+        case AutoStrategy::SliceCache:
+        {
+            float minEnergy = FLT_MAX;
+            pixelsVisited = m_cache.numSlicesXY;
+            for (size_t sliceXYIndex = 0; sliceXYIndex < m_cache.numSlicesXY; sliceXYIndex++)
+            {
+                if (m_cache.dirtyMin[sliceXYIndex])
+                {
+                    size_t sliceLargestVoidIndex = 0;
+                    float sliceMinEnergy = FLT_MAX;
+                    ForEachPixelInXYSlice<false>(m_cache, m_data.pixelOn, sliceXYIndex,
+                        [&](size_t i)
+                        {
+                            if (m_data.energy[i] < sliceMinEnergy)
+                            {
+                                sliceMinEnergy = m_data.energy[i];
+                                sliceLargestVoidIndex = i;
+                            }
+                        }
+                    );
+                    m_cache.minValue[sliceXYIndex] = sliceMinEnergy;
+                    m_cache.minValueIndex[sliceXYIndex] = sliceLargestVoidIndex;
+                    m_cache.dirtyMin[sliceXYIndex] = false;
+                    pixelsVisited += m_cache.sliceSizeXY;
+                }
+
+                if (m_cache.minValue[sliceXYIndex] < minEnergy || (m_cache.minValue[sliceXYIndex] == minEnergy && m_cache.minValueIndex[sliceXYIndex] < voidPixelIndex))
+                {
+                    minEnergy = m_cache.minValue[sliceXYIndex];
+                    voidPixelIndex = m_cache.minValueIndex[sliceXYIndex];
+                }
+            }
+            break;
+        }
+        case AutoStrategy::PixelList:
+        {
+            float minEnergy = FLT_MAX;
+            for (size_t listIndex = m_pixelOnCount; listIndex < m_data.numPixels; ++listIndex)
+            {
+                size_t pixelIndex = m_pixelList[listIndex];
+                float energy = m_data.energy[pixelIndex];
+                if (energy < minEnergy || (energy == minEnergy && pixelIndex < voidPixelIndex))
+                {
+                    minEnergy = energy;
+                    voidPixelIndex = pixelIndex;
+                }
+            }
+            pixelsVisited = m_data.numPixels - m_pixelOnCount;
+            break;
+        }
+    }
+
+    EndQuery(pixelsVisited);
+    return voidPixelIndex;
+}
+
+template<bool ON, bool CACHE>
+void AutoController2Dx1Dx1D::SplatImpl(const PixelCoords& pixelCoords)
+{
+    // Same arithmetic, in the same order, as ReferenceController2Dx1Dx1D: XY, then Z, then W
+    const Dimensions& dims = m_data.dimensions;
+    ArenaVector<float>& energy = m_data.energy;
+    PixelCoords coords = pixelCoords;
+
+    size_t xySlice = CoordsToXYSlice(pixelCoords, dims);
+    for (int iy = m_kernelY.start(); iy <= m_kernelY.end(); ++iy)
+    {
+        float kernelY = m_kernelY[size_t(abs(iy))];
+        coords.y = CalcOffsetPixelCoord(pixelCoords.y, iy, dims.y);
+        for (int ix = m_kernelX.start(); ix <= m_kernelX.end(); ++ix)
+        {
+            float kernelX = m_kernelX[size_t(abs(ix))];
+            coords.x = CalcOffsetPixelCoord(pixelCoords.x, ix, dims.x);
+            size_t pixelIndex = PixelCoordsToPixelIndex(coords, dims);
+
+            if (CACHE)
+                SplatPixel<ON>(m_cache, energy, m_data.pixelOn, pixelIndex, kernelX * kernelY, xySlice);
+            else if (ON)
+                energy[pixelIndex] += kernelX * kernelY;
+            else
+                energy[pixelIndex] -= kernelX * kernelY;
+        }
+    }
+
+    coords = pixelCoords;
+    for (int iz = m_kernelZ.start(); iz <= m_kernelZ.end(); ++iz)
+    {
+        coords.z = CalcOffsetPixelCoord(pixelCoords.z, iz, dims.z);
+        size_t pixelIndex = PixelCoordsToPixelIndex(coords, dims);
+
+        if (CACHE)
+            SplatPixel<ON>(m_cache, energy, m_data.pixelOn, pixelIndex, m_kernelZ[size_t(abs(iz))], CoordsToXYSlice(coords, dims));
+        else if (ON)
+            energy[pixelIndex] += m_kernelZ[size_t(abs(iz))];
+        else
+            energy[pixelIndex] -= m_kernelZ[size_t(abs(iz))];
+    }
+
+    coords = pixelCoords;
+    for (int iw = m_kernelW.start(); iw <= m_kernelW.end(); ++iw)
+    {
+        coords.w = CalcOffsetPixelCoord(pixelCoords.w, iw, dims.w);
+        size_t pixelIndex = PixelCoordsToPixelIndex(coords, dims);
+
+        if (CACHE)
+            SplatPixel<ON>(m_cache, energy, m_data.pixelOn, pixelIndex, m_kernelW[size_t(abs(iw))], CoordsToXYSlice(coords, dims));
+        else if (ON)
+            energy[pixelIndex] += m_kernelW[size_t(abs(iw))];
+        else
+            energy[pixelIndex] -= m_kernelW[size_t(abs(iw))];
+    }
+}
+
+template<bool ON>
+void AutoController2Dx1Dx1D::Splat(const PixelCoords& pixelCoords)
+{
+    m_splatsSinceQuery++;
+    if (m_strategy != AutoStrategy::FullScan && m_splatsSinceQuery > m_data.numPixels / c_idleSplatDivisor)
+    {
+        MigrateTo(AutoStrategy::FullScan);
+        m_phaseBoundary = true;
+    }
+
+    if (m_strategy == AutoStrategy::SliceCache)
+        SplatImpl<ON, true>(pixelCoords);
+    else
+        SplatImpl<ON, false>(pixelCoords);
+}
+
+void AutoController2Dx1Dx1D::SplatOn(const PixelCoords& pixelCoords)
+{
+    Splat<true>(pixelCoords);
+}
+
+void AutoController2Dx1Dx1D::SplatOff(const PixelCoords& pixelCoords)
+{
+    Splat<false>(pixelCoords);
+}
+
+void AutoController2Dx1Dx1D::SetPixelOn(size_t pixelIndex, bool value)
+{
+    bool wasOn = m_data.pixelOn[pixelIndex];
+    m_data.pixelOn.Set(pixelIndex, value);
+
+    if (m_strategy == AutoStrategy::SliceCache)
+    {
+        auto xySlice = CoordsToXYSlice(PixelIndexToPixelCoords(pixelIndex, m_data.dimensions), m_data.dimensions);
+        m_cache.dirtyMax[xySlice] = true;
+        m_cache.dirtyMin[xySlice] = true;
+    }
+
+    if (wasOn == value)
+        return;
+
+    // Move the pixel across the on/off boundary of the list by swapping it with the pixel at the boundary
+    if (m_strategy == AutoStrategy::PixelList)
+    {
+        size_t boundary = value ? m_pixelOnCount : m_pixelOnCount - 1;
+        size_t position = m_pixelListPosition[pixelIndex];
+        uint32_t boundaryPixelIndex = m_pixelList[boundary];
+
+        m_pixelList[position] = boundaryPixelIndex;
+        m_pixelListPosition[boundaryPixelIndex] = uint32_t(position);
+        m_pixelList[boundary] = uint32_t(pixelIndex);
+        m_pixelListPosition[pixelIndex] = uint32_t(boundary);
+    }
+
+    if (value)
+        m_pixelOnCount++;
+    else
+        m_pixelOnCount--;
+}
+
+void AutoController2Dx1Dx1D::SetPixelRank(size_t pixelIndex, size_t rank)
+{
+    m_data.pixelRank[pixelIndex] = rank;
+}
+
+void AutoController2Dx1Dx1D::SetAllEnergyToZero()
+{
+    std::fill(m_data.energy.begin(), m_data.energy.end(), 0.0f);
+    std::fill(m_cache.dirtyMax.begin(), m_cache.dirtyMax.end(), true);
+    std::fill(m_cache.dirtyMin.begin(), m_cache.dirtyMin.end(), true);
+    m_phaseBoundary = true;
+}
+
+void AutoController2Dx1Dx1D::InvertPixelOn(size_t pixelIndex)
+{
+    SetPixelOn(pixelIndex, !m_data.pixelOn[pixelIndex]);
+}
+
+void AutoController2Dx1Dx1D::InvertAllPixels()
+{
+    m_data.pixelOn.FlipAll();
+
+    if (m_strategy == AutoStrategy::SliceCache)
+    {
+        std::fill(m_cache.dirtyMax.begin(), m_cache.dirtyMax.end(), true);
+        std::fill(m_cache.dirtyMin.begin(), m_cache.dirtyMin.end(), true);
+    }
+
+    // The off pixels become the on pixels, so rotate them to the front of the list
+    if (m_strategy == AutoStrategy::PixelList)
+    {
+        std::rotate(m_pixelList.begin(), m_pixelList.begin() + m_pixelOnCount, m_pixelList.end());
+        for (size_t position = 0; position < m_pixelList.size(); ++position)
+            m_pixelListPosition[m_pixelList[position]] = uint32_t(position);
+    }
+
+    m_pixelOnCount = m_data.numPixels - m_pixelOnCount;
+}
+
+void AutoController2Dx1Dx1D::SetPixelsOn(std::span<const size_t> pixelIndices, bool value)
+{
+    // SetPixelOn keeps the pixel list partitioned, which needs a swap per pixel anyway
+    for (size_t pixelIndex : pixelIndices)
+        SetPixelOn(pixelIndex, value);
+}
+
+void AutoController2Dx1Dx1D::SetRanks(std::span<const size_t> pixelIndices, size_t firstRank)
+{
+    for (size_t index = 0; index < pixelIndices.size(); ++index)
+        m_data.pixelRank[pixelIndices[index]] = firstRank + index;
+}
+
+AutoStrategy AutoController2Dx1Dx1D::GetStrategy() const
+{
+    return m_strategy;
+}
+
+const AutoControllerStats& AutoController2Dx1Dx1D::GetStats() const
+{
+    return m_stats;
+}
+
+void AutoController2Dx1Dx1D::BeginQuery(bool cluster)
+{
+    m_queryIsCluster = cluster;
+    m_splatsSinceQuery = 0;
+
+    if (m_phaseBoundary)
+    {
+        // The last measurements were for another phase, so re-probe the slice cache
+        m_sliceCacheCost[0] = m_sliceCacheCost[1] = float(m_cache.numSlicesXY + m_cache.sliceSizeXY);
+        m_windowQueries[0] = m_windowQueries[1] = 0;
+        m_windowPixelsVisited[0] = m_windowPixelsVisited[1] = 0;
+        Evaluate();
+    }
+}
+
+void AutoController2Dx1Dx1D::EndQuery(size_t pixelsVisited)
+{
+    size_t kind = m_queryIsCluster ? 1 : 0;
+    m_windowQueries[kind]++;
+    m_windowPixelsVisited[kind] += pixelsVisited;
+    m_stats.queries[(size_t)m_strategy]++;
+    m_stats.pixelsVisited[(size_t)m_strategy] += pixelsVisited;
+
+    if (m_windowQueries[0] + m_windowQueries[1] >= c_evaluateInterval)
+        Evaluate();
+}
+
+void AutoController2Dx1Dx1D::Evaluate()
+{
+    size_t windowQueries = m_windowQueries[0] + m_windowQueries[1];
+    float clusterFraction = windowQueries > 0 ? float(m_windowQueries[1]) / float(windowQueries) : (m_queryIsCluster ? 1.0f : 0.0f);
+
+    if (m_strategy == AutoStrategy::SliceCache)
+    {
+        for (size_t kind = 0; kind < 2; ++kind)
+        {
+            if (m_windowQueries[kind] > 0)
+                m_sliceCacheCost[kind] = float(m_windowPixelsVisited[kind]) / float(m_windowQueries[kind]);
+        }
+    }
+
+    // Estimated pixels visited per query
+    float costs[(size_t)AutoStrategy::Count];
+    costs[(size_t)AutoStrategy::FullScan] = float(m_data.numPixels);
+    costs[(size_t)AutoStrategy::SliceCache] = clusterFraction * m_sliceCacheCost[1] + (1.0f - clusterFraction) * m_sliceCacheCost[0];
+    costs[(size_t)AutoStrategy::PixelList] = clusterFraction * float(m_pixelOnCount) + (1.0f - clusterFraction) * float(m_data.numPixels - m_pixelOnCount);
+
+    AutoStrategy best = m_strategy;
+    for (size_t strategy = 0; strategy < (size_t)AutoStrategy::Count; ++strategy)
+    {
+        if (costs[strategy] < costs[(size_t)best])
+            best = (AutoStrategy)strategy;
+    }
+
+    if (best != m_strategy && costs[(size_t)best] <= costs[(size_t)m_strategy] * c_switchThreshold)
+        MigrateTo(best);
+
+    m_windowQueries[0] = m_windowQueries[1] = 0;
+    m_windowPixelsVisited[0] = m_windowPixelsVisited[1] = 0;
+    m_phaseBoundary = false;
+}
+
+void AutoController2Dx1Dx1D::MigrateTo(AutoStrategy strategy)
+{
+    if (strategy == m_strategy)
+        return;
+
+    // The structures of the old strategy weren't maintained, so build the new ones from scratch
+    switch (strategy)
+    {
+        case AutoStrategy::SliceCache:
+        {
+            std::fill(m_cache.dirtyMax.begin(), m_cache.dirtyMax.end(), true);
+            std::fill(m_cache.dirtyMin.begin(), m_cache.dirtyMin.end(), true);
+            break;
+        }
+        case AutoStrategy::PixelList:
+        {
+            m_pixelList.resize(m_data.numPixels);
+            m_pixelListPosition.resize(m_data.numPixels);
+            size_t onPosition = 0;
+            size_t offPosition = m_pixelOnCount;
+            for (size_t pixelIndex = 0; pixelIndex < m_data.numPixels; ++pixelIndex)
+            {
+                size_t position = m_data.pixelOn[pixelIndex] ? onPosition++ : offPosition++;
+                m_pixelList[position] = uint32_t(pixelIndex);
+                m_pixelListPosition[pixelIndex] = uint32_t(position);
+            }
+            break;
+        }
+        default:
+            break;
+    }
+
+    m_strategy = strategy;
+    m_stats.strategySwitches++;
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "VoidAndCluster/VCController.h"
+
+#include "Kernel/SymmetricKernel.h"
+#include "VoidAndCluster/SliceCache/SliceCacheImpl.h"
+
+// How the auto controller answers tightest cluster / largest void queries.
+// They all return the same pixel, so switching never changes the result.
+enum class AutoStrategy
+{
+    FullScan,       // Scan every pixel, like the reference engine. Splats do no bookkeeping.
+    SliceCache,     // Per XY slice min/max caches, like the slice cache engine.
+    PixelList,      // Scan only the on pixels (clusters) or off pixels (voids). Cheap when one side is sparse.
+    Count
+};
+
+struct AutoControllerStats
+{
+    size_t queries[(size_t)AutoStrategy::Count] = {};
+    size_t pixelsVisited[(size_t)AutoStrategy::Count] = {};
+    size_t strategySwitches = 0;
+};
+
+// 2Dx1Dx1D controller, bit-identical to ReferenceController2Dx1Dx1D, which picks the cheapest query strategy as it goes.
+// It measures the pixels each query visits and re-evaluates every so often, and at phase boundaries:
+// when energy is reset, or when a long run of splats without queries makes cache bookkeeping pure overhead.
+class AutoController2Dx1Dx1D : public VCController
+{
+public:
+    AutoController2Dx1Dx1D(STBNData& data, SymmetricKernel kernelX, SymmetricKernel kernelY, SymmetricKernel kernelZ, SymmetricKernel kernelW);
+
+    virtual STBNData& GetSTBNData() override;
+
+    virtual size_t GetPixelOnCount() const override;
+
+    virtual size_t GetTightestCluster() override;
+
+    virtual size_t GetLargestVoid() override;
+
+    virtual void SplatOn(const PixelCoords& pixelCoords) override;
+
+    virtual void SplatOff(const PixelCoords& pixelCoords) override;
+
+    virtual void SetPixelOn(size_t pixelIndex, bool value) override;
+
+    virtual void SetPixelRank(size_t pixelIndex, size_t rank) override;
+
+    virtual void SetAllEnergyToZero() override;
+
+    virtual void InvertPixelOn(size_t pixelIndex) override;
+    virtual void InvertAllPixels() override;
+
+    virtual void SetPixelsOn(std::span<const size_t> pixelIndices, bool value) override;
+
+    virtual void SetRanks(std::span<const size_t> pixelIndices, size_t firstRank) override;
+
+    AutoStrategy GetStrategy() const;
+
+    const AutoControllerStats& GetStats() const;
+
+private:
+    template<bool ON>
+    void Splat(const PixelCoords& pixelCoords);
+
+    template<bool ON, bool CACHE>
+    void SplatImpl(const PixelCoords& pixelCoords);
+
+    void BeginQuery(bool cluster);
+    void EndQuery(size_t pixelsVisited);
+    void Evaluate();
+    void MigrateTo(AutoStrategy strategy);
+
+    STBNData& m_data;
+
+    SymmetricKernel m_kernelX;
+    SymmetricKernel m_kernelY;
+    SymmetricKernel m_kernelZ;
+    SymmetricKernel m_kernelW;
+
+    AutoStrategy m_strategy;
+    size_t m_pixelOnCount;
+
+    // SliceCache structures, valid when that strategy is active
+    SliceCacheData2Dx1Dx1D m_cache;
+
+    // PixelList structures, valid when that strategy is active.
+    // m_pixelList holds the on pixels in [0, m_pixelOnCount) and the off pixels after that.
+    std::vector<uint32_t> m_pixelList;
+    std::vector<uint32_t> m_pixelListPosition;
+
+    // Cost sampling, in pixels visited per query, for the current evaluation window
+    bool m_queryIsCluster;
+    bool m_phaseBoundary;
+    size_t m_splatsSinceQuery;
+    size_t m_windowQueries[2];        // [0] = voids, [1] = clusters
+    size_t m_windowPixelsVisited[2];
+    float m_sliceCacheCost[2];        // Last measured slice cache cost per query kind
+
+    AutoControllerStats m_stats;
+};
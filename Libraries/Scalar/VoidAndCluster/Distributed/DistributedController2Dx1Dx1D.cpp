@@ -0,0 +1,144 @@
+#include "DistributedController2Dx1Dx1D.h"
+
+#include <algorithm>
+
+#include "Utils/PixelCoords.h"
+
+DistributedController2Dx1Dx1D::DistributedController2Dx1Dx1D(STBNData& data, SymmetricKernel kernelX, SymmetricKernel kernelY, SymmetricKernel kernelZ, SymmetricKernel kernelW, const TileOptions& options) :
+    m_data(data),
+    m_sliceSizeXY(data.dimensions.x * data.dimensions.y)
+{
+    const Dimensions& dims = data.dimensions;
+    size_t numSlices = dims.z * dims.w;
+    size_t numTiles = std::clamp<size_t>(options.numTiles, 1, numSlices);
+
+    // Spread the slices as evenly as possible
+    for (size_t tile = 0; tile <= numTiles; ++tile)
+        m_tileFirstSlice.push_back(tile * numSlices / numTiles);
+
+    for (size_t tile = 0; tile < numTiles; ++tile)
+    {
+        size_t firstSlice = m_tileFirstSlice[tile];
+        size_t tileSlices = m_tileFirstSlice[tile + 1] - firstSlice;
+        m_links.push_back(MakeTileLink(options.transport,
+            [=]()
+            {
+                return new TileWorker(dims, firstSlice, tileSlices, kernelX, kernelY, kernelZ, kernelW);
+            }
+        ));
+    }
+    m_pending.resize(numTiles);
+}
+
+STBNData& DistributedController2Dx1Dx1D::GetSTBNData()
+{
+    return m_data;
+}
+
+size_t DistributedController2Dx1Dx1D::GetPixelOnCount() const
+{
+    return m_data.pixelOn.Count();
+}
+
+size_t DistributedController2Dx1Dx1D::TileOfPixel(size_t pixelIndex) const
+{
+    size_t slice = pixelIndex / m_sliceSizeXY;
+    return size_t(std::upper_bound(m_tileFirstSlice.begin(), m_tileFirstSlice.end(), slice) - m_tileFirstSlice.begin()) - 1;
+}
+
+void DistributedController2Dx1Dx1D::Broadcast(TileCommand command, size_t pixelIndex)
+{
+    TileRequest request = { command, 0, pixelIndex };
+    for (std::vector<TileRequest>& pending : m_pending)
+        pending.push_back(request);
+}
+
+TileReply DistributedController2Dx1Dx1D::Query(TileCommand command)
+{
+    // Send everything first so the tiles work in parallel, then gather
+    Broadcast(command, 0);
+    for (size_t tile = 0; tile < m_links.size(); ++tile)
+    {
+        m_links[tile]->Send(m_pending[tile].data(), m_pending[tile].size());
+        m_pending[tile].clear();
+    }
+
+    // Tiles are in pixel order, so the first of equal energies wins, like a full scan
+    TileReply best = { 0, 0.0f, 0 };
+    for (size_t tile = 0; tile < m_links.size(); ++tile)
+    {
+        TileReply reply = m_links[tile]->Receive();
+        if (!reply.found)
+            continue;
+
+        bool better = (command == TileCommand::TightestCluster) ? reply.energy > best.energy : reply.energy < best.energy;
+        if (!best.found || better)
+            best = reply;
+    }
+    return best;
+}
+
+size_t DistributedController2Dx1Dx1D::GetTightestCluster()
+{
+    return size_t(Query(TileCommand::TightestCluster).pixelIndex);
+}
+
+size_t DistributedController2Dx1Dx1D::GetLargestVoid()
+{
+    return size_t(Query(TileCommand::LargestVoid).pixelIndex);
+}
+
+void DistributedController2Dx1Dx1D::SplatOn(const PixelCoords& pixelCoords)
+{
+    Broadcast(TileCommand::SplatOn, PixelCoordsToPixelIndex(pixelCoords, m_data.dimensions));
+}
+
+void DistributedController2Dx1Dx1D::SplatOff(const PixelCoords& pixelCoords)
+{
+    Broadcast(TileCommand::SplatOff, PixelCoordsToPixelIndex(pixelCoords, m_data.dimensions));
+}
+
+void DistributedController2Dx1Dx1D::SetPixelOn(size_t pixelIndex, bool value)
+{
+    m_data.pixelOn.Set(pixelIndex, value);
+    TileRequest request = { value ? TileCommand::SetPixelOn : TileCommand::SetPixelOff, 0, pixelIndex };
+    m_pending[TileOfPixel(pixelIndex)].push_back(request);
+}
+
+void DistributedController2Dx1Dx1D::SetPixelRank(size_t pixelIndex, size_t rank)
+{
+    m_data.pixelRank[pixelIndex] = rank;
+}
+
+void DistributedController2Dx1Dx1D::SetAllEnergyToZero()
+{
+    Broadcast(TileCommand::SetAllEnergyToZero, 0);
+}
+
+void DistributedController2Dx1Dx1D::InvertPixelOn(size_t pixelIndex)
+{
+    SetPixelOn(pixelIndex, !m_data.pixelOn[pixelIndex]);
+}
+
+void DistributedController2Dx1Dx1D::InvertAllPixels()
+{
+    m_data.pixelOn.FlipAll();
+    Broadcast(TileCommand::InvertAllPixels, 0);
+}
+
+void DistributedController2Dx1Dx1D::SetPixelsOn(std::span<const size_t> pixelIndices, bool value)
+{
+    for (size_t pixelIndex : pixelIndices)
+        SetPixelOn(pixelIndex, value);
+}
+
+void DistributedController2Dx1Dx1D::SetRanks(std::span<const size_t> pixelIndices, size_t firstRank)
+{
+    for (size_t index = 0; index < pixelIndices.size(); ++index)
+        m_data.pixelRank[pixelIndices[index]] = firstRank + index;
+}
+
+size_t DistributedController2Dx1Dx1D::GetNumTiles() const
+{
+    return m_links.size();
+}
\ No newline at end of file
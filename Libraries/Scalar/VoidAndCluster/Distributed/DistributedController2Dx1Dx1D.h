@@ -0,0 +1,68 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "VoidAndCluster/VCController.h"
+
+#include "Kernel/SymmetricKernel.h"
+#include "TileLink.h"
+
+struct TileOptions
+{
+    size_t numTiles = 4;
+    TileTransport transport = TileTransport::Threads;
+};
+
+// 2Dx1Dx1D controller that splits the XY slices (slice = w * dims.z + z) into contiguous ranges owned by tiles,
+// which can be separate processes. The coordinator keeps pixelOn and pixelRank, and each tile keeps the energy
+// and slice cache of its own slices. The coordinator never reads STBNData::energy, so its STBNData can be made
+// without it (see ControllerUsesEnergy()), and the energy is only ever held once, split across the tiles.
+// Splats and on/off changes are batched up and only sent when a query needs them, and a query is a reduction of
+// one answer per tile. Ranks are bit identical to SliceCache_2Dx1Dx1D.
+// Needs the linear layout, so that a slice range is a contiguous range of pixels.
+class DistributedController2Dx1Dx1D : public VCController
+{
+public:
+    DistributedController2Dx1Dx1D(STBNData& data, SymmetricKernel kernelX, SymmetricKernel kernelY, SymmetricKernel kernelZ, SymmetricKernel kernelW, const TileOptions& options);
+
+    virtual STBNData& GetSTBNData() override;
+
+    virtual size_t GetPixelOnCount() const override;
+
+    virtual size_t GetTightestCluster() override;
+
+    virtual size_t GetLargestVoid() override;
+
+    virtual void SplatOn(const PixelCoords& pixelCoords) override;
+
+    virtual void SplatOff(const PixelCoords& pixelCoords) override;
+
+    virtual void SetPixelOn(size_t pixelIndex, bool value) override;
+
+    virtual void SetPixelRank(size_t pixelIndex, size_t rank) override;
+
+    virtual void SetAllEnergyToZero() override;
+
+    virtual void InvertPixelOn(size_t pixelIndex) override;
+
+    virtual void InvertAllPixels() override;
+
+    virtual void SetPixelsOn(std::span<const size_t> pixelIndices, bool value) override;
+
+    virtual void SetRanks(std::span<const size_t> pixelIndices, size_t firstRank) override;
+
+    size_t GetNumTiles() const;
+
+private:
+    size_t TileOfPixel(size_t pixelIndex) const;
+    void Broadcast(TileCommand command, size_t pixelIndex);
+    TileReply Query(TileCommand command);
+
+    STBNData& m_data;
+    size_t m_sliceSizeXY;
+
+    std::vector<size_t> m_tileFirstSlice;   // One past the end for the last tile too
+    std::vector<std::unique_ptr<TileLink>> m_links;
+    std::vector<std::vector<TileRequest>> m_pending;
+};
\ No newline at end of file
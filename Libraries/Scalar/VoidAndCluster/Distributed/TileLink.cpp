@@ -0,0 +1,227 @@
+#include "TileLink.h"
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+
+#include "Trace.h"
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    const std::chrono::milliseconds c_busySampleInterval(10);
+}
+
+TileLink::~TileLink()
+{
+
+}
+
+std::unique_ptr<TileLink> MakeTileLink(TileTransport transport, const std::function<TileWorker*()>& makeWorker)
+{
+#ifndef _WIN32
+    if (transport == TileTransport::Processes)
+        return std::make_unique<ProcessTileLink>(makeWorker);
+#endif
+    return std::make_unique<ThreadTileLink>(makeWorker);
+}
+
+ThreadTileLink::ThreadTileLink(const std::function<TileWorker*()>& makeWorker)
+{
+    m_thread = std::thread(&ThreadTileLink::Run, this, makeWorker);
+}
+
+ThreadTileLink::~ThreadTileLink()
+{
+    TileRequest quit = { TileCommand::Quit, 0, 0 };
+    Send(&quit, 1);
+    m_thread.join();
+}
+
+void ThreadTileLink::Send(const TileRequest* requests, size_t count)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_requests.insert(m_requests.end(), requests, requests + count);
+    }
+    m_requestReady.notify_one();
+}
+
+TileReply ThreadTileLink::Receive()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_replyReady.wait(lock, [this] { return !m_replies.empty(); });
+    TileReply reply = m_replies.front();
+    m_replies.pop_front();
+    return reply;
+}
+
+void ThreadTileLink::Run(const std::function<TileWorker*()>& makeWorker)
+{
+    std::unique_ptr<TileWorker> worker(makeWorker());
+    std::vector<TileRequest> requests;
+
+    // Traces get how busy the tile is, sampled every c_busySampleInterval, rather than a span per request batch
+    static std::atomic<int> s_nextTraceIndex(0);
+    const bool trace = Trace::IsOpen();
+    const char* busyCounter = nullptr;
+    if (trace)
+    {
+        std::string name = "Tile worker " + std::to_string(s_nextTraceIndex++);
+        Trace::SetThreadName(Trace::Intern(name));
+        busyCounter = Trace::Intern(name + " busy %");
+    }
+    auto windowStart = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::duration busy(0);
+
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_requestReady.wait(lock, [this] { return !m_requests.empty(); });
+            requests.assign(m_requests.begin(), m_requests.end());
+            m_requests.clear();
+        }
+
+        auto batchStart = trace ? std::chrono::steady_clock::now() : windowStart;
+        for (const TileRequest& request : requests)
+        {
+            if (request.command == TileCommand::Quit)
+                return;
+
+            TileReply reply;
+            if (worker->Handle(request, reply))
+            {
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_replies.push_back(reply);
+                }
+                m_replyReady.notify_one();
+            }
+        }
+
+        if (trace)
+        {
+            auto now = std::chrono::steady_clock::now();
+            busy += now - batchStart;
+            if (now - windowStart >= c_busySampleInterval)
+            {
+                Trace::Counter(busyCounter, 100.0 * std::chrono::duration<double>(busy).count() / std::chrono::duration<double>(now - windowStart).count());
+                windowStart = now;
+                busy = std::chrono::steady_clock::duration(0);
+            }
+        }
+    }
+}
+
+#ifndef _WIN32
+
+namespace
+{
+    bool ReadAll(int fd, void* data, size_t size)
+    {
+        char* bytes = (char*)data;
+        while (size > 0)
+        {
+            ssize_t count = read(fd, bytes, size);
+            if (count <= 0)
+                return false;
+            bytes += count;
+            size -= size_t(count);
+        }
+        return true;
+    }
+
+    bool WriteAll(int fd, const void* data, size_t size)
+    {
+        const char* bytes = (const char*)data;
+        while (size > 0)
+        {
+            ssize_t count = write(fd, bytes, size);
+            if (count <= 0)
+                return false;
+            bytes += count;
+            size -= size_t(count);
+        }
+        return true;
+    }
+}
+
+// The tile is forked, so create links before starting other threads; a lock held by another thread at fork time stays locked in the child.
+ProcessTileLink::ProcessTileLink(const std::function<TileWorker*()>& makeWorker) :
+    m_socket(-1),
+    m_pid(-1)
+{
+    int sockets[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) != 0)
+        throw std::runtime_error("ProcessTileLink: socketpair failed");
+
+    m_pid = fork();
+    if (m_pid < 0)
+        throw std::runtime_error("ProcessTileLink: fork failed");
+
+    if (m_pid == 0)
+    {
+        close(sockets[0]);
+        std::unique_ptr<TileWorker> worker(makeWorker());
+        TileRequest requests[256];
+        while (true)
+        {
+            // Wait for one request, then take whatever else has arrived, leaving room to finish a partly read one
+            if (!ReadAll(sockets[1], &requests[0], sizeof(TileRequest)))
+                _exit(1);
+            ssize_t extra = recv(sockets[1], &requests[1], sizeof(requests) - 2 * sizeof(TileRequest), MSG_DONTWAIT);
+            size_t count = 1 + (extra > 0 ? size_t(extra) / sizeof(TileRequest) : 0);
+            if (extra > 0 && (size_t(extra) % sizeof(TileRequest)) != 0)
+            {
+                size_t partial = size_t(extra) % sizeof(TileRequest);
+                if (!ReadAll(sockets[1], (char*)&requests[count] + partial, sizeof(TileRequest) - partial))
+                    _exit(1);
+                count++;
+            }
+
+            for (size_t index = 0; index < count; ++index)
+            {
+                if (requests[index].command == TileCommand::Quit)
+                    _exit(0);
+
+                TileReply reply;
+                if (worker->Handle(requests[index], reply) && !WriteAll(sockets[1], &reply, sizeof(reply)))
+                    _exit(1);
+            }
+        }
+    }
+
+    close(sockets[1]);
+    m_socket = sockets[0];
+}
+
+ProcessTileLink::~ProcessTileLink()
+{
+    TileRequest quit = { TileCommand::Quit, 0, 0 };
+    Send(&quit, 1);
+    close(m_socket);
+    waitpid(m_pid, nullptr, 0);
+}
+
+void ProcessTileLink::Send(const TileRequest* requests, size_t count)
+{
+    if (!WriteAll(m_socket, requests, count * sizeof(TileRequest)))
+        throw std::runtime_error("ProcessTileLink: tile process went away");
+}
+
+TileReply ProcessTileLink::Receive()
+{
+    TileReply reply;
+    if (!ReadAll(m_socket, &reply, sizeof(reply)))
+        throw std::runtime_error("ProcessTileLink: tile process went away");
+    return reply;
+}
+
+#endif
\ No newline at end of file
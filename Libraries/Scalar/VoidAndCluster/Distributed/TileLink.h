@@ -0,0 +1,70 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "TileWorker.h"
+
+enum class TileTransport
+{
+    Threads,    // Each tile is a thread of this process, talking through shared memory
+    Processes   // Each tile is a forked process, talking over a local socket. Falls back to threads where fork isn't available.
+};
+
+// The coordinator's connection to one tile. Requests are fire and forget, and only the
+// queries get a reply, so requests stream to the tile while it works on earlier ones.
+class TileLink
+{
+public:
+    virtual ~TileLink();
+
+    virtual void Send(const TileRequest* requests, size_t count) = 0;
+
+    virtual TileReply Receive() = 0;
+};
+
+// Makes a link to a new tile. makeWorker runs on the tile's side, so a process tile allocates its own memory.
+std::unique_ptr<TileLink> MakeTileLink(TileTransport transport, const std::function<TileWorker*()>& makeWorker);
+
+class ThreadTileLink : public TileLink
+{
+public:
+    ThreadTileLink(const std::function<TileWorker*()>& makeWorker);
+    virtual ~ThreadTileLink() override;
+
+    virtual void Send(const TileRequest* requests, size_t count) override;
+
+    virtual TileReply Receive() override;
+
+private:
+    void Run(const std::function<TileWorker*()>& makeWorker);
+
+    std::mutex m_mutex;
+    std::condition_variable m_requestReady;
+    std::condition_variable m_replyReady;
+    std::deque<TileRequest> m_requests;
+    std::deque<TileReply> m_replies;
+    std::thread m_thread;
+};
+
+#ifndef _WIN32
+class ProcessTileLink : public TileLink
+{
+public:
+    ProcessTileLink(const std::function<TileWorker*()>& makeWorker);
+    virtual ~ProcessTileLink() override;
+
+    virtual void Send(const TileRequest* requests, size_t count) override;
+
+    virtual TileReply Receive() override;
+
+private:
+    int m_socket;
+    int m_pid;
+};
+#endif
\ No newline at end of file
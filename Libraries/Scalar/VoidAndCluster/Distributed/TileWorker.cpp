@@ -0,0 +1,186 @@
+#include "TileWorker.h"
+
+#include <algorithm>
+#include <cfloat>
+
+#include "Utils/PixelCoords.h"
+#include "VoidAndCluster/SliceCache/SliceCacheFuncs.h"
+
+namespace
+{
+    Dimensions TileDims(const Dimensions& dims, size_t numSlices)
+    {
+        Dimensions ret = { dims.x, dims.y, numSlices, 1 };
+        return ret;
+    }
+}
+
+TileWorker::TileWorker(const Dimensions& dims, size_t firstSlice, size_t numSlices, SymmetricKernel kernelX, SymmetricKernel kernelY, SymmetricKernel kernelZ, SymmetricKernel kernelW) :
+    m_dims(dims),
+    m_firstSlice(firstSlice),
+    m_numSlices(numSlices),
+    m_firstPixel(firstSlice * dims.x * dims.y),
+    m_energy(numSlices * dims.x * dims.y, 0.0f),
+    m_pixelOn(numSlices * dims.x * dims.y, false),
+    m_cache(TileDims(dims, numSlices)),
+    m_kernelX(kernelX),
+    m_kernelY(kernelY),
+    m_kernelZ(kernelZ),
+    m_kernelW(kernelW)
+{
+
+}
+
+bool TileWorker::Handle(const TileRequest& request, TileReply& reply)
+{
+    switch (request.command)
+    {
+        case TileCommand::SplatOn: Splat<true>(request.pixelIndex); return false;
+        case TileCommand::SplatOff: Splat<false>(request.pixelIndex); return false;
+        case TileCommand::SetPixelOn: SetPixelOn(request.pixelIndex, true); return false;
+        case TileCommand::SetPixelOff: SetPixelOn(request.pixelIndex, false); return false;
+        case TileCommand::SetAllEnergyToZero:
+        {
+            std::fill(m_energy.begin(), m_energy.end(), 0.0f);
+            std::fill(m_cache.dirtyMax.begin(), m_cache.dirtyMax.end(), true);
+            std::fill(m_cache.dirtyMin.begin(), m_cache.dirtyMin.end(), true);
+            return false;
+        }
+        case TileCommand::InvertAllPixels:
+        {
+            m_pixelOn.FlipAll();
+            std::fill(m_cache.dirtyMax.begin(), m_cache.dirtyMax.end(), true);
+            std::fill(m_cache.dirtyMin.begin(), m_cache.dirtyMin.end(), true);
+            return false;
+        }
+        case TileCommand::TightestCluster: reply = TightestCluster(); return true;
+        case TileCommand::LargestVoid: reply = LargestVoid(); return true;
+        default: return false;
+    }
+}
+
+template<bool ON>
+void TileWorker::SplatPixelInSlice(size_t globalSlice, size_t x, size_t y, float splatValue)
+{
+    size_t slice = globalSlice - m_firstSlice;
+    size_t localPixelIndex = (slice * m_dims.y + y) * m_dims.x + x;
+    SplatPixel<ON>(m_cache, m_energy, m_pixelOn, localPixelIndex, splatValue, slice);
+}
+
+template<bool ON>
+void TileWorker::SplatXYSlice(size_t globalSlice, const PixelCoords& center)
+{
+    for (int iy = m_kernelY.start(); iy <= m_kernelY.end(); ++iy)
+    {
+        float kernelY = m_kernelY[size_t(abs(iy))];
+        size_t y = CalcOffsetPixelCoord(center.y, iy, m_dims.y);
+        for (int ix = m_kernelX.start(); ix <= m_kernelX.end(); ++ix)
+        {
+            float kernelX = m_kernelX[size_t(abs(ix))];
+            SplatPixelInSlice<ON>(globalSlice, CalcOffsetPixelCoord(center.x, ix, m_dims.x), y, kernelX * kernelY);
+        }
+    }
+}
+
+template<bool ON>
+void TileWorker::Splat(size_t pixelIndex)
+{
+    PixelCoords center = PixelIndexToPixelCoords(pixelIndex, m_dims);
+    auto inTile = [this](size_t globalSlice) { return globalSlice >= m_firstSlice && globalSlice < m_firstSlice + m_numSlices; };
+
+    size_t centerSlice = center.w * m_dims.z + center.z;
+    if (inTile(centerSlice))
+        SplatXYSlice<ON>(centerSlice, center);
+
+    for (int iz = m_kernelZ.start(); iz <= m_kernelZ.end(); ++iz)
+    {
+        size_t globalSlice = center.w * m_dims.z + CalcOffsetPixelCoord(center.z, iz, m_dims.z);
+        if (inTile(globalSlice))
+            SplatPixelInSlice<ON>(globalSlice, center.x, center.y, m_kernelZ[size_t(abs(iz))]);
+    }
+
+    for (int iw = m_kernelW.start(); iw <= m_kernelW.end(); ++iw)
+    {
+        size_t globalSlice = CalcOffsetPixelCoord(center.w, iw, m_dims.w) * m_dims.z + center.z;
+        if (inTile(globalSlice))
+            SplatPixelInSlice<ON>(globalSlice, center.x, center.y, m_kernelW[size_t(abs(iw))]);
+    }
+}
+
+void TileWorker::SetPixelOn(size_t pixelIndex, bool value)
+{
+    size_t localPixelIndex = pixelIndex - m_firstPixel;
+    m_pixelOn.Set(localPixelIndex, value);
+    size_t slice = localPixelIndex / m_cache.sliceSizeXY;
+    m_cache.dirtyMax[slice] = true;
+    m_cache.dirtyMin[slice] = true;
+}
+
+TileReply TileWorker::TightestCluster()
+{
+    TileReply reply = { 0, -FLT_MAX, 0 };
+    for (size_t slice = 0; slice < m_numSlices; slice++)
+    {
+        if (m_cache.dirtyMax[slice])
+        {
+            size_t sliceTightestClusterIndex = 0;
+            float sliceMaxEnergy = -FLT_MAX;
+            ForEachPixelInXYSlice<true>(m_cache, m_pixelOn, slice,
+                [&](size_t i)
+                {
+                    if (m_energy[i] > sliceMaxEnergy)
+                    {
+                        sliceMaxEnergy = m_energy[i];
+                        sliceTightestClusterIndex = i;
+                    }
+                }
+            );
+            m_cache.maxValue[slice] = sliceMaxEnergy;
+            m_cache.maxValueIndex[slice] = sliceTightestClusterIndex;
+            m_cache.dirtyMax[slice] = false;
+        }
+
+        // Slices are visited in pixel order, so the first of equal energies wins
+        if (m_cache.maxValue[slice] > reply.energy)
+        {
+            reply.energy = m_cache.maxValue[slice];
+            reply.pixelIndex = m_firstPixel + m_cache.maxValueIndex[slice];
+            reply.found = 1;
+        }
+    }
+    return reply;
+}
+
+TileReply TileWorker::LargestVoid()
+{
+    TileReply reply = { 0, FLT_MAX, 0 };
+    for (size_t slice = 0; slice < m_numSlices; slice++)
+    {
+        if (m_cache.dirtyMin[slice])
+        {
+            size_t sliceLargestVoidIndex = 0;
+            float sliceMinEnergy = FLT_MAX;
+            ForEachPixelInXYSlice<false>(m_cache, m_pixelOn, slice,
+                [&](size_t i)
+                {
+                    if (m_energy[i] < sliceMinEnergy)
+                    {
+                        sliceMinEnergy = m_energy[i];
+                        sliceLargestVoidIndex = i;
+                    }
+                }
+            );
+            m_cache.minValue[slice] = sliceMinEnergy;
+            m_cache.minValueIndex[slice] = sliceLargestVoidIndex;
+            m_cache.dirtyMin[slice] = false;
+        }
+
+        if (m_cache.minValue[slice] < reply.energy)
+        {
+            reply.energy = m_cache.minValue[slice];
+            reply.pixelIndex = m_firstPixel + m_cache.minValueIndex[slice];
+            reply.found = 1;
+        }
+    }
+    return reply;
+}
\ No newline at end of file
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdint>
+
+#include "ArenaAllocator.h"
+#include "Kernel/SymmetricKernel.h"
+#include "Utils/Dimensions.h"
+#include "Utils/PixelBitset.h"
+#include "VoidAndCluster/SliceCache/SliceCacheImpl.h"
+
+// Commands from the coordinator to a tile. Pixel indices are global.
+enum class TileCommand : uint32_t
+{
+    SplatOn,
+    SplatOff,
+    SetPixelOn,
+    SetPixelOff,
+    SetAllEnergyToZero,
+    InvertAllPixels,
+    TightestCluster,    // Replies with the tile's tightest cluster
+    LargestVoid,        // Replies with the tile's largest void
+    Quit
+};
+
+// Plain data so it can go over a socket as is
+struct TileRequest
+{
+    TileCommand command;
+    uint32_t padding;
+    uint64_t pixelIndex;
+};
+
+struct TileReply
+{
+    uint64_t pixelIndex;
+    float energy;
+    uint32_t found;     // 0 if the tile had no on pixels (clusters) or no off pixels (voids)
+};
+
+// One tile of a 2Dx1Dx1D void and cluster, owning a contiguous range of XY slices (slice = w * dims.z + z).
+// A splat is sent to every tile as its center pixel, and each tile applies the taps that land in its own slices.
+// That's all the halo exchange needed: a pixel index per splat instead of kernel radius wide energy borders.
+// Taps are applied in the same order as SliceCacheImpl, so the energies are bit identical to it.
+class TileWorker
+{
+public:
+    TileWorker(const Dimensions& dims, size_t firstSlice, size_t numSlices, SymmetricKernel kernelX, SymmetricKernel kernelY, SymmetricKernel kernelZ, SymmetricKernel kernelW);
+
+    // Returns true if the request has a reply
+    bool Handle(const TileRequest& request, TileReply& reply);
+
+private:
+    template<bool ON>
+    void Splat(size_t pixelIndex);
+
+    template<bool ON>
+    void SplatXYSlice(size_t globalSlice, const PixelCoords& center);
+
+    template<bool ON>
+    void SplatPixelInSlice(size_t globalSlice, size_t x, size_t y, float splatValue);
+
+    void SetPixelOn(size_t pixelIndex, bool value);
+    TileReply TightestCluster();
+    TileReply LargestVoid();
+
+    Dimensions m_dims;
+    size_t m_firstSlice;
+    size_t m_numSlices;
+    size_t m_firstPixel;
+
+    ArenaVector<float> m_energy;
+    PixelBitset m_pixelOn;
+    SliceCacheData2Dx1Dx1D m_cache;
+
+    SymmetricKernel m_kernelX;
+    SymmetricKernel m_kernelY;
+    SymmetricKernel m_kernelZ;
+    SymmetricKernel m_kernelW;
+};
\ No newline at end of file
@@ -0,0 +1,305 @@
+#include "FixedPointController2Dx1Dx1D.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "Utils/PixelCoords.h"
+#include "VoidAndCluster/SliceCache/SliceCacheFuncs.h"
+
+namespace
+{
+    double KernelSum(const SymmetricKernel& kernel)
+    {
+        double sum = 0.0;
+        for (int i = kernel.start(); i <= kernel.end(); ++i)
+            sum += kernel[size_t(abs(i))];
+        return sum;
+    }
+
+    // Every on pixel adds each of its taps to at most one pixel, so no pixel can hold more than the sum of all taps.
+    // Take the most fraction bits that keep that sum, plus rounding, within half of EnergyT's range.
+    template<typename EnergyT>
+    int CalcFractionBits(const SymmetricKernel& kernelX, const SymmetricKernel& kernelY, const SymmetricKernel& kernelZ, const SymmetricKernel& kernelW)
+    {
+        const int digits = std::numeric_limits<EnergyT>::digits;
+        double maxEnergy = KernelSum(kernelX) * KernelSum(kernelY) + KernelSum(kernelZ) + KernelSum(kernelW);
+        double numTaps = double((kernelX.end() - kernelX.start() + 1) * (kernelY.end() - kernelY.start() + 1) + (kernelZ.end() - kernelZ.start() + 1) + (kernelW.end() - kernelW.start() + 1));
+
+        int fractionBits = digits - 1;
+        while (fractionBits > 0 && std::ldexp(maxEnergy, fractionBits) + numTaps > std::ldexp(1.0, digits - 1))
+            fractionBits--;
+        return fractionBits;
+    }
+
+    template<typename EnergyT>
+    EnergyT Quantize(double value, int fractionBits)
+    {
+        return EnergyT(std::llround(std::ldexp(value, fractionBits)));
+    }
+
+    template<typename EnergyT>
+    std::vector<EnergyT> QuantizeKernel(const SymmetricKernel& kernel, int fractionBits)
+    {
+        std::vector<EnergyT> ret;
+        for (int i = kernel.start(); i <= kernel.end(); ++i)
+            ret.push_back(Quantize<EnergyT>(kernel[size_t(abs(i))], fractionBits));
+        return ret;
+    }
+
+    template<typename EnergyT>
+    std::vector<EnergyT> QuantizeKernelXY(const SymmetricKernel& kernelX, const SymmetricKernel& kernelY, int fractionBits)
+    {
+        std::vector<EnergyT> ret;
+        for (int iy = kernelY.start(); iy <= kernelY.end(); ++iy)
+        {
+            for (int ix = kernelX.start(); ix <= kernelX.end(); ++ix)
+                ret.push_back(Quantize<EnergyT>(double(kernelX[size_t(abs(ix))]) * double(kernelY[size_t(abs(iy))]), fractionBits));
+        }
+        return ret;
+    }
+
+    inline size_t CoordsToXYSlice(const PixelCoords& coords, const Dimensions& dims)
+    {
+        return (coords.w * dims.z) + coords.z;
+    }
+}
+
+template<typename EnergyT>
+FixedPointSliceCacheData<EnergyT>::FixedPointSliceCacheData(const Dimensions& dimensions) :
+    sliceSizeXY(dimensions.x * dimensions.y),
+    numSlicesXY(dimensions.z * dimensions.w),
+    dirtyMax(numSlicesXY, true),
+    maxValue(numSlicesXY, 0),
+    maxValueIndex(numSlicesXY, 0),
+    dirtyMin(numSlicesXY, true),
+    minValue(numSlicesXY, 0),
+    minValueIndex(numSlicesXY, 0)
+{
+    InitXYSliceTables(*this, dimensions);
+}
+
+template<typename EnergyT>
+FixedPointController2Dx1Dx1D<EnergyT>::FixedPointController2Dx1Dx1D(STBNData& data, SymmetricKernel kernelX, SymmetricKernel kernelY, SymmetricKernel kernelZ, SymmetricKernel kernelW) :
+    m_data(data),
+    m_energy(data.numPixels, 0),
+    m_cache(data.dimensions),
+    m_fractionBits(CalcFractionBits<EnergyT>(kernelX, kernelY, kernelZ, kernelW)),
+    m_tapsXY(QuantizeKernelXY<EnergyT>(kernelX, kernelY, m_fractionBits)),
+    m_tapsZ(QuantizeKernel<EnergyT>(kernelZ, m_fractionBits)),
+    m_tapsW(QuantizeKernel<EnergyT>(kernelW, m_fractionBits)),
+    m_kernelX(kernelX),
+    m_kernelY(kernelY),
+    m_kernelZ(kernelZ),
+    m_kernelW(kernelW)
+{
+
+}
+
+template<typename EnergyT>
+STBNData& FixedPointController2Dx1Dx1D<EnergyT>::GetSTBNData()
+{
+    return m_data;
+}
+
+template<typename EnergyT>
+size_t FixedPointController2Dx1Dx1D<EnergyT>::GetPixelOnCount() const
+{
+    return m_data.pixelOn.Count();
+}
+
+template<typename EnergyT>
+size_t FixedPointController2Dx1Dx1D<EnergyT>::GetTightestCluster()
+{
+    size_t clusterPixelIndex = 0;
+    EnergyT maxEnergy = std::numeric_limits<EnergyT>::lowest();
+
+    for (size_t sliceXYIndex = 0; sliceXYIndex < m_cache.numSlicesXY; sliceXYIndex++)
+    {
+        if (m_cache.dirtyMax[sliceXYIndex])
+        {
+            size_t sliceTightestClusterIndex = 0;
+            EnergyT sliceMaxEnergy = std::numeric_limits<EnergyT>::lowest();
+            ForEachPixelInXYSlice<true>(m_cache, m_data.pixelOn, sliceXYIndex,
+                [&](size_t i)
+                {
+                    if (m_energy[i] > sliceMaxEnergy)
+                    {
+                        sliceMaxEnergy = m_energy[i];
+                        sliceTightestClusterIndex = i;
+                    }
+                }
+            );
+            m_cache.maxValue[sliceXYIndex] = sliceMaxEnergy;
+            m_cache.maxValueIndex[sliceXYIndex] = sliceTightestClusterIndex;
+            m_cache.dirtyMax[sliceXYIndex] = false;
+        }
+
+        EnergyT sliceMaxEnergy = m_cache.maxValue[sliceXYIndex];
+        size_t sliceTightestClusterIndex = m_cache.maxValueIndex[sliceXYIndex];
+        if (sliceMaxEnergy > maxEnergy || (sliceMaxEnergy == maxEnergy && sliceTightestClusterIndex < clusterPixelIndex))
+        {
+            maxEnergy = sliceMaxEnergy;
+            clusterPixelIndex = sliceTightestClusterIndex;
+        }
+    }
+
+    return clusterPixelIndex;
+}
+
+template<typename EnergyT>
+size_t FixedPointController2Dx1Dx1D<EnergyT>::GetLargestVoid()
+{
+    size_t voidPixelIndex = 0;
+    EnergyT minEnergy = std::numeric_limits<EnergyT>::max();
+
+    for (size_t sliceXYIndex = 0; sliceXYIndex < m_cache.numSlicesXY; sliceXYIndex++)
+    {
+        if (m_cache.dirtyMin[sliceXYIndex])
+        {
+            size_t sliceLargestVoidIndex = 0;
+            EnergyT sliceMinEnergy = std::numeric_limits<EnergyT>::max();
+            ForEachPixelInXYSlice<false>(m_cache, m_data.pixelOn, sliceXYIndex,
+                [&](size_t i)
+                {
+                    if (m_energy[i] < sliceMinEnergy)
+                    {
+                        sliceMinEnergy = m_energy[i];
+                        sliceLargestVoidIndex = i;
+                    }
+                }
+            );
+            m_cache.minValue[sliceXYIndex] = sliceMinEnergy;
+            m_cache.minValueIndex[sliceXYIndex] = sliceLargestVoidIndex;
+            m_cache.dirtyMin[sliceXYIndex] = false;
+        }
+
+        EnergyT sliceMinEnergy = m_cache.minValue[sliceXYIndex];
+        size_t sliceLargestVoidIndex = m_cache.minValueIndex[sliceXYIndex];
+        if (sliceMinEnergy < minEnergy || (sliceMinEnergy == minEnergy && sliceLargestVoidIndex < voidPixelIndex))
+        {
+            minEnergy = sliceMinEnergy;
+            voidPixelIndex = sliceLargestVoidIndex;
+        }
+    }
+
+    return voidPixelIndex;
+}
+
+template<typename EnergyT>
+template<bool ON>
+void FixedPointController2Dx1Dx1D<EnergyT>::Splat(const PixelCoords& pixelCoords)
+{
+    const Dimensions& dims = m_data.dimensions;
+
+    // XY
+    PixelCoords coords = pixelCoords;
+    size_t xySlice = CoordsToXYSlice(pixelCoords, dims);
+    const EnergyT* tapXY = m_tapsXY.data();
+    for (int iy = m_kernelY.start(); iy <= m_kernelY.end(); ++iy)
+    {
+        coords.y = CalcOffsetPixelCoord(pixelCoords.y, iy, dims.y);
+        for (int ix = m_kernelX.start(); ix <= m_kernelX.end(); ++ix)
+        {
+            coords.x = CalcOffsetPixelCoord(pixelCoords.x, ix, dims.x);
+            SplatPixel<ON>(m_cache, m_energy, m_data.pixelOn, PixelCoordsToPixelIndex(coords, dims), *tapXY++, xySlice);
+        }
+    }
+
+    // Z
+    coords = pixelCoords;
+    for (int iz = m_kernelZ.start(); iz <= m_kernelZ.end(); ++iz)
+    {
+        coords.z = CalcOffsetPixelCoord(pixelCoords.z, iz, dims.z);
+        SplatPixel<ON>(m_cache, m_energy, m_data.pixelOn, PixelCoordsToPixelIndex(coords, dims), m_tapsZ[size_t(iz - m_kernelZ.start())], CoordsToXYSlice(coords, dims));
+    }
+
+    // W
+    coords = pixelCoords;
+    for (int iw = m_kernelW.start(); iw <= m_kernelW.end(); ++iw)
+    {
+        coords.w = CalcOffsetPixelCoord(pixelCoords.w, iw, dims.w);
+        SplatPixel<ON>(m_cache, m_energy, m_data.pixelOn, PixelCoordsToPixelIndex(coords, dims), m_tapsW[size_t(iw - m_kernelW.start())], CoordsToXYSlice(coords, dims));
+    }
+}
+
+template<typename EnergyT>
+void FixedPointController2Dx1Dx1D<EnergyT>::SplatOn(const PixelCoords& pixelCoords)
+{
+    Splat<true>(pixelCoords);
+}
+
+template<typename EnergyT>
+void FixedPointController2Dx1Dx1D<EnergyT>::SplatOff(const PixelCoords& pixelCoords)
+{
+    Splat<false>(pixelCoords);
+}
+
+template<typename EnergyT>
+void FixedPointController2Dx1Dx1D<EnergyT>::SetPixelOn(size_t pixelIndex, bool value)
+{
+    m_data.pixelOn.Set(pixelIndex, value);
+    size_t xySlice = CoordsToXYSlice(PixelIndexToPixelCoords(pixelIndex, m_data.dimensions), m_data.dimensions);
+    m_cache.dirtyMax[xySlice] = true;
+    m_cache.dirtyMin[xySlice] = true;
+}
+
+template<typename EnergyT>
+void FixedPointController2Dx1Dx1D<EnergyT>::SetPixelRank(size_t pixelIndex, size_t rank)
+{
+    m_data.pixelRank[pixelIndex] = rank;
+}
+
+template<typename EnergyT>
+void FixedPointController2Dx1Dx1D<EnergyT>::SetAllEnergyToZero()
+{
+    std::fill(m_energy.begin(), m_energy.end(), EnergyT(0));
+    std::fill(m_cache.dirtyMax.begin(), m_cache.dirtyMax.end(), true);
+    std::fill(m_cache.dirtyMin.begin(), m_cache.dirtyMin.end(), true);
+}
+
+template<typename EnergyT>
+void FixedPointController2Dx1Dx1D<EnergyT>::InvertPixelOn(size_t pixelIndex)
+{
+    SetPixelOn(pixelIndex, !m_data.pixelOn[pixelIndex]);
+}
+
+template<typename EnergyT>
+void FixedPointController2Dx1Dx1D<EnergyT>::InvertAllPixels()
+{
+    m_data.pixelOn.FlipAll();
+    std::fill(m_cache.dirtyMax.begin(), m_cache.dirtyMax.end(), true);
+    std::fill(m_cache.dirtyMin.begin(), m_cache.dirtyMin.end(), true);
+}
+
+template<typename EnergyT>
+void FixedPointController2Dx1Dx1D<EnergyT>::SetPixelsOn(std::span<const size_t> pixelIndices, bool value)
+{
+    for (size_t pixelIndex : pixelIndices)
+        m_data.pixelOn.Set(pixelIndex, value);
+    DirtySlicesOfPixels(m_cache, m_data.dimensions, pixelIndices);
+}
+
+template<typename EnergyT>
+void FixedPointController2Dx1Dx1D<EnergyT>::SetRanks(std::span<const size_t> pixelIndices, size_t firstRank)
+{
+    for (size_t index = 0; index < pixelIndices.size(); ++index)
+        m_data.pixelRank[pixelIndices[index]] = firstRank + index;
+}
+
+template<typename EnergyT>
+const ArenaVector<EnergyT>& FixedPointController2Dx1Dx1D<EnergyT>::GetEnergy() const
+{
+    return m_energy;
+}
+
+template<typename EnergyT>
+int FixedPointController2Dx1Dx1D<EnergyT>::GetFractionBits() const
+{
+    return m_fractionBits;
+}
+
+template struct FixedPointSliceCacheData<int32_t>;
+template struct FixedPointSliceCacheData<int64_t>;
+template class FixedPointController2Dx1Dx1D<int32_t>;
+template class FixedPointController2Dx1Dx1D<int64_t>;
\ No newline at end of file
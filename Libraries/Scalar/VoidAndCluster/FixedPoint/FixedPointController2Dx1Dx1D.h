@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "VoidAndCluster/VCController.h"
+
+#include "ArenaAllocator.h"
+#include "Kernel/SymmetricKernel.h"
+#include "Utils/Dimensions.h"
+
+// Per XY slice min/max cache over integer energies, laid out like SliceCacheData2Dx1Dx1D
+template<typename EnergyT>
+struct FixedPointSliceCacheData
+{
+    FixedPointSliceCacheData(const Dimensions& dimensions);
+
+    size_t              sliceSizeXY;
+    size_t              numSlicesXY;
+
+    std::vector<size_t> sliceBasePixelIndex;
+    std::vector<size_t> slicePixelOffsets;
+
+    std::vector<bool>    dirtyMax;
+    std::vector<EnergyT> maxValue;
+    std::vector<size_t>  maxValueIndex;
+
+    std::vector<bool>    dirtyMin;
+    std::vector<EnergyT> minValue;
+    std::vector<size_t>  minValueIndex;
+};
+
+// 2Dx1Dx1D slice cached controller that keeps energy as fixed point integers instead of floats.
+// Kernel taps are quantized once, with as many fraction bits as EnergyT has room for after the largest
+// possible energy, so integer sums never overflow. Integer addition is associative, so splats can be applied
+// in any order or split across threads and give the same energy, and SplatOff exactly undoes SplatOn.
+// Quantization makes ties more likely than with floats. They go to the lowest pixel index, as in every engine,
+// but the ranks won't generally match the float engines.
+// The energy lives in the controller; STBNData::energy isn't used.
+template<typename EnergyT>
+class FixedPointController2Dx1Dx1D : public VCController
+{
+public:
+    FixedPointController2Dx1Dx1D(STBNData& data, SymmetricKernel kernelX, SymmetricKernel kernelY, SymmetricKernel kernelZ, SymmetricKernel kernelW);
+
+    virtual STBNData& GetSTBNData() override;
+
+    virtual size_t GetPixelOnCount() const override;
+
+    virtual size_t GetTightestCluster() override;
+
+    virtual size_t GetLargestVoid() override;
+
+    virtual void SplatOn(const PixelCoords& pixelCoords) override;
+
+    virtual void SplatOff(const PixelCoords& pixelCoords) override;
+
+    virtual void SetPixelOn(size_t pixelIndex, bool value) override;
+
+    virtual void SetPixelRank(size_t pixelIndex, size_t rank) override;
+
+    virtual void SetAllEnergyToZero() override;
+
+    virtual void InvertPixelOn(size_t pixelIndex) override;
+    virtual void InvertAllPixels() override;
+
+    virtual void SetPixelsOn(std::span<const size_t> pixelIndices, bool value) override;
+
+    virtual void SetRanks(std::span<const size_t> pixelIndices, size_t firstRank) override;
+
+    const ArenaVector<EnergyT>& GetEnergy() const;
+
+    // Number of fraction bits in the fixed point energy
+    int GetFractionBits() const;
+
+private:
+    template<bool ON>
+    void Splat(const PixelCoords& pixelCoords);
+
+    STBNData& m_data;
+    ArenaVector<EnergyT> m_energy;
+    FixedPointSliceCacheData<EnergyT> m_cache;
+
+    int m_fractionBits;
+
+    // Quantized taps, indexed by kernel offset - start. XY is the outer product, y major.
+    std::vector<EnergyT> m_tapsXY;
+    std::vector<EnergyT> m_tapsZ;
+    std::vector<EnergyT> m_tapsW;
+
+    SymmetricKernel m_kernelX;
+    SymmetricKernel m_kernelY;
+    SymmetricKernel m_kernelZ;
+    SymmetricKernel m_kernelW;
+};
+
+extern template class FixedPointController2Dx1Dx1D<int32_t>;
+extern template class FixedPointController2Dx1Dx1D<int64_t>;
\ No newline at end of file
@@ -1,13 +1,15 @@
 #include "ReferenceController2Dx1Dx1D.h"
 
 #include "ReferenceFuncs.h"
+#include "VoidAndCluster/VCStats.h"
 
 ReferenceController2Dx1Dx1D::ReferenceController2Dx1Dx1D(STBNData& data, SymmetricKernel kernelX, SymmetricKernel kernelY, SymmetricKernel kernelZ, SymmetricKernel kernelW) :
     m_data(data),
     m_kernelX(kernelX),
     m_kernelY(kernelY),
     m_kernelZ(kernelZ),
-    m_kernelW(kernelW)
+    m_kernelW(kernelW),
+    m_stats(nullptr)
 {
 
 }
@@ -29,16 +31,29 @@ size_t ReferenceController2Dx1Dx1D::GetPixelOnCount() const
 
 size_t ReferenceController2Dx1Dx1D::GetTightestCluster()
 {
+#if VC_STATS()
+    // Every query scans the whole volume
+    if (m_stats)
+        m_stats->Current().pixelsScanned += m_data.numPixels;
+#endif
     return ReferenceFuncs::GetTightestCluster(m_data);
 }
 
 size_t ReferenceController2Dx1Dx1D::GetLargestVoid()
 {
+#if VC_STATS()
+    if (m_stats)
+        m_stats->Current().pixelsScanned += m_data.numPixels;
+#endif
     return ReferenceFuncs::GetLargestVoid(m_data);
 }
 
 void ReferenceController2Dx1Dx1D::SplatOn(const PixelCoords& pixelCoords)
 {
+#if VC_STATS()
+    if (m_stats)
+        m_stats->Current().splatTaps += NumKernelTaps(m_kernelY) * NumKernelTaps(m_kernelX) + NumKernelTaps(m_kernelZ) + NumKernelTaps(m_kernelW);
+#endif
     ReferenceFuncs::SplatOn2D(m_data, pixelCoords, 1, m_kernelY, 0, m_kernelX);
     ReferenceFuncs::SplatOn1D(m_data, pixelCoords, 2, m_kernelZ);
     ReferenceFuncs::SplatOn1D(m_data, pixelCoords, 3, m_kernelW);
@@ -46,6 +61,10 @@ void ReferenceController2Dx1Dx1D::SplatOn(const PixelCoords& pixelCoords)
 
 void ReferenceController2Dx1Dx1D::SplatOff(const PixelCoords& pixelCoords)
 {
+#if VC_STATS()
+    if (m_stats)
+        m_stats->Current().splatTaps += NumKernelTaps(m_kernelY) * NumKernelTaps(m_kernelX) + NumKernelTaps(m_kernelZ) + NumKernelTaps(m_kernelW);
+#endif
     ReferenceFuncs::SplatOff2D(m_data, pixelCoords, 1, m_kernelY, 0, m_kernelX);
     ReferenceFuncs::SplatOff1D(m_data, pixelCoords, 2, m_kernelZ);
     ReferenceFuncs::SplatOff1D(m_data, pixelCoords, 3, m_kernelW);
@@ -69,4 +88,24 @@ void ReferenceController2Dx1Dx1D::SetAllEnergyToZero()
 void ReferenceController2Dx1Dx1D::InvertPixelOn(size_t pixelIndex)
 {
     ReferenceFuncs::InvertPixelOn(m_data, pixelIndex);
+}
+
+void ReferenceController2Dx1Dx1D::InvertAllPixels()
+{
+    ReferenceFuncs::InvertAllPixels(m_data);
+}
+
+void ReferenceController2Dx1Dx1D::SetPixelsOn(std::span<const size_t> pixelIndices, bool value)
+{
+    ReferenceFuncs::SetPixelsOn(m_data, pixelIndices, value);
+}
+
+void ReferenceController2Dx1Dx1D::SetRanks(std::span<const size_t> pixelIndices, size_t firstRank)
+{
+    ReferenceFuncs::SetRanks(m_data, pixelIndices, firstRank);
+}
+
+void ReferenceController2Dx1Dx1D::SetStats(VCStats* stats)
+{
+    m_stats = stats;
 }
\ No newline at end of file
@@ -29,6 +29,13 @@ public:
     virtual void SetAllEnergyToZero() override final;
 
     virtual void InvertPixelOn(size_t pixelIndex) override final;
+    virtual void InvertAllPixels() override final;
+
+    virtual void SetPixelsOn(std::span<const size_t> pixelIndices, bool value) override final;
+
+    virtual void SetRanks(std::span<const size_t> pixelIndices, size_t firstRank) override final;
+
+    virtual void SetStats(VCStats* stats) override final;
 
 private:
     STBNData& m_data;
@@ -37,4 +44,6 @@ private:
     SymmetricKernel m_kernelY;
     SymmetricKernel m_kernelZ;
     SymmetricKernel m_kernelW;
+
+    VCStats* m_stats;
 };
\ No newline at end of file
@@ -1,13 +1,15 @@
 #include "ReferenceController2Dx2D.h"
 
 #include "ReferenceFuncs.h"
+#include "VoidAndCluster/VCStats.h"
 
 ReferenceController2Dx2D::ReferenceController2Dx2D(STBNData& data, SymmetricKernel kernelX, SymmetricKernel kernelY, SymmetricKernel kernelZ, SymmetricKernel kernelW) :
     m_data(data),
     m_kernelX(kernelX),
     m_kernelY(kernelY),
     m_kernelZ(kernelZ),
-    m_kernelW(kernelW)
+    m_kernelW(kernelW),
+    m_stats(nullptr)
 {
 
 }
@@ -29,22 +31,39 @@ size_t ReferenceController2Dx2D::GetPixelOnCount() const
 
 size_t ReferenceController2Dx2D::GetTightestCluster()
 {
+#if VC_STATS()
+    // Every query scans the whole volume
+    if (m_stats)
+        m_stats->Current().pixelsScanned += m_data.numPixels;
+#endif
     return ReferenceFuncs::GetTightestCluster(m_data);
 }
 
 size_t ReferenceController2Dx2D::GetLargestVoid()
 {
+#if VC_STATS()
+    if (m_stats)
+        m_stats->Current().pixelsScanned += m_data.numPixels;
+#endif
     return ReferenceFuncs::GetLargestVoid(m_data);
 }
 
 void ReferenceController2Dx2D::SplatOn(const PixelCoords& pixelCoords)
 {
+#if VC_STATS()
+    if (m_stats)
+        m_stats->Current().splatTaps += NumKernelTaps(m_kernelY) * NumKernelTaps(m_kernelX) + NumKernelTaps(m_kernelW) * NumKernelTaps(m_kernelZ);
+#endif
     ReferenceFuncs::SplatOn2D(m_data, pixelCoords, 1, m_kernelY, 0, m_kernelX);
     ReferenceFuncs::SplatOn2D(m_data, pixelCoords, 3, m_kernelW, 2, m_kernelZ);
 }
 
 void ReferenceController2Dx2D::SplatOff(const PixelCoords& pixelCoords)
 {
+#if VC_STATS()
+    if (m_stats)
+        m_stats->Current().splatTaps += NumKernelTaps(m_kernelY) * NumKernelTaps(m_kernelX) + NumKernelTaps(m_kernelW) * NumKernelTaps(m_kernelZ);
+#endif
     ReferenceFuncs::SplatOff2D(m_data, pixelCoords, 1, m_kernelY, 0, m_kernelX);
     ReferenceFuncs::SplatOff2D(m_data, pixelCoords, 3, m_kernelW, 2, m_kernelZ);
 }
@@ -67,4 +86,24 @@ void ReferenceController2Dx2D::SetAllEnergyToZero()
 void ReferenceController2Dx2D::InvertPixelOn(size_t pixelIndex)
 {
     ReferenceFuncs::InvertPixelOn(m_data, pixelIndex);
+}
+
+void ReferenceController2Dx2D::InvertAllPixels()
+{
+    ReferenceFuncs::InvertAllPixels(m_data);
+}
+
+void ReferenceController2Dx2D::SetPixelsOn(std::span<const size_t> pixelIndices, bool value)
+{
+    ReferenceFuncs::SetPixelsOn(m_data, pixelIndices, value);
+}
+
+void ReferenceController2Dx2D::SetRanks(std::span<const size_t> pixelIndices, size_t firstRank)
+{
+    ReferenceFuncs::SetRanks(m_data, pixelIndices, firstRank);
+}
+
+void ReferenceController2Dx2D::SetStats(VCStats* stats)
+{
+    m_stats = stats;
 }
\ No newline at end of file
@@ -9,13 +9,7 @@ namespace ReferenceFuncs
 
 size_t GetPixelOnCount(const STBNData& data)
 {
-    size_t ret = 0;
-    for (bool b : data.pixelOn)
-    {
-        if (b)
-            ret++;
-    }
-    return ret;
+    return data.pixelOn.Count();
 }
 
 size_t GetTightestCluster(const STBNData& data)
@@ -23,17 +17,16 @@ size_t GetTightestCluster(const STBNData& data)
     size_t clusterPixelIndex = 0;
     float maxEnergy = -FLT_MAX;
 
-    for (size_t pixelIndex = 0; pixelIndex < data.numPixels; ++pixelIndex)
-    {
-        if (!data.pixelOn[pixelIndex])
-            continue;
-
-        if (data.energy[pixelIndex] > maxEnergy)
+    data.pixelOn.ForEachBit<true>(
+        [&](size_t pixelIndex)
         {
-            maxEnergy = data.energy[pixelIndex];
-            clusterPixelIndex = pixelIndex;
+            if (data.energy[pixelIndex] > maxEnergy)
+            {
+                maxEnergy = data.energy[pixelIndex];
+                clusterPixelIndex = pixelIndex;
+            }
         }
-    }
+    );
 
     return clusterPixelIndex;
 }
@@ -43,23 +36,22 @@ size_t GetLargestVoid(const STBNData& data)
     size_t voidPixelIndex = 0;
     float minEnergy = FLT_MAX;
 
-    for (size_t pixelIndex = 0; pixelIndex < data.numPixels; ++pixelIndex)
-    {
-        if (data.pixelOn[pixelIndex])
-            continue;
-
-        if (data.energy[pixelIndex] < minEnergy)
+    data.pixelOn.ForEachBit<false>(
+        [&](size_t pixelIndex)
         {
-            minEnergy = data.energy[pixelIndex];
-            voidPixelIndex = pixelIndex;
+            if (data.energy[pixelIndex] < minEnergy)
+            {
+                minEnergy = data.energy[pixelIndex];
+                voidPixelIndex = pixelIndex;
+            }
         }
-    }
+    );
 
     return voidPixelIndex;
 }
 
 template<bool ON>
-void Splat1DReference(std::vector<float>& energy, Dimensions dimensions, PixelCoords pixelCoords, size_t dimension, const SymmetricKernel& kernel)
+void Splat1DReference(ArenaVector<float>& energy, Dimensions dimensions, PixelCoords pixelCoords, size_t dimension, const SymmetricKernel& kernel)
 {
     PixelCoords coords = pixelCoords;
     auto dims = dimensions.dim[dimension];
@@ -87,7 +79,7 @@ void SplatOff1D(STBNData& data, const PixelCoords& pixelCoords, size_t dimension
 }
 
 template<bool ON>
-void Splat2DReference(std::vector<float>& energy, Dimensions dimensions, PixelCoords pixelCoords, size_t outerDimensionIndex, const SymmetricKernel& outerKernel, size_t innerDimensionIndex, const SymmetricKernel& innerKernel)
+void Splat2DReference(ArenaVector<float>& energy, Dimensions dimensions, PixelCoords pixelCoords, size_t outerDimensionIndex, const SymmetricKernel& outerKernel, size_t innerDimensionIndex, const SymmetricKernel& innerKernel)
 {
     PixelCoords newPixelCoords = pixelCoords;
     size_t outerDimensionSize = dimensions.dim[outerDimensionIndex];
@@ -124,7 +116,7 @@ void SplatOff2D(STBNData& data, const PixelCoords& pixelCoords, size_t outerDime
 
 void SetPixelOn(STBNData& data, size_t pixelIndex, bool value)
 {
-    data.pixelOn[pixelIndex] = value;
+    data.pixelOn.Set(pixelIndex, value);
 }
 
 void SetPixelRank(STBNData& data,size_t pixelIndex, size_t rank)
@@ -139,7 +131,24 @@ void SetAllEnergyToZero(STBNData& data)
 
 void InvertPixelOn(STBNData& data,size_t pixelIndex)
 {
-    data.pixelOn[pixelIndex] = !data.pixelOn[pixelIndex];
+    data.pixelOn.Flip(pixelIndex);
+}
+
+void InvertAllPixels(STBNData& data)
+{
+    data.pixelOn.FlipAll();
+}
+
+void SetPixelsOn(STBNData& data, std::span<const size_t> pixelIndices, bool value)
+{
+    for (size_t pixelIndex : pixelIndices)
+        data.pixelOn.Set(pixelIndex, value);
+}
+
+void SetRanks(STBNData& data, std::span<const size_t> pixelIndices, size_t firstRank)
+{
+    for (size_t index = 0; index < pixelIndices.size(); ++index)
+        data.pixelRank[pixelIndices[index]] = firstRank + index;
 }
 
 }
\ No newline at end of file
@@ -4,6 +4,8 @@ union PixelCoords;
 struct STBNData;
 class SymmetricKernel;
 
+#include <span>
+
 namespace ReferenceFuncs
 {
 
@@ -27,4 +29,10 @@ void SetAllEnergyToZero(STBNData& data);
 
 void InvertPixelOn(STBNData& data, size_t pixelIndex);
 
+void InvertAllPixels(STBNData& data);
+
+void SetPixelsOn(STBNData& data, std::span<const size_t> pixelIndices, bool value);
+
+void SetRanks(STBNData& data, std::span<const size_t> pixelIndices, size_t firstRank);
+
 }
\ No newline at end of file
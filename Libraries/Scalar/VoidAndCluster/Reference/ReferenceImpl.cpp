@@ -91,4 +91,19 @@ void ReferenceImpl2Dx1Dx1D::SetAllEnergyToZero()
 void ReferenceImpl2Dx1Dx1D::InvertPixelOn(size_t pixelIndex)
 {
     ReferenceFuncs::InvertPixelOn(m_data, pixelIndex);
+}
+
+void ReferenceImpl2Dx1Dx1D::InvertAllPixels()
+{
+    ReferenceFuncs::InvertAllPixels(m_data);
+}
+
+void ReferenceImpl2Dx1Dx1D::SetPixelsOn(std::span<const size_t> pixelIndices, bool value)
+{
+    ReferenceFuncs::SetPixelsOn(m_data, pixelIndices, value);
+}
+
+void ReferenceImpl2Dx1Dx1D::SetRanks(std::span<const size_t> pixelIndices, size_t firstRank)
+{
+    ReferenceFuncs::SetRanks(m_data, pixelIndices, firstRank);
 }
\ No newline at end of file
@@ -4,7 +4,7 @@
 
 SliceCacheController2Dx2D::SliceCacheController2Dx2D(STBNData& data, SymmetricKernel kernelX, SymmetricKernel kernelY, SymmetricKernel kernelZ, SymmetricKernel kernelW) :
     m_data(data),
-    m_impl(data),
+    m_impl(data, SliceCacheImpl::MakeWeightsXY(kernelY, kernelX)),
     m_kernelX(kernelX),
     m_kernelY(kernelY),
     m_kernelZ(kernelZ),
@@ -63,4 +63,24 @@ void SliceCacheController2Dx2D::SetAllEnergyToZero()
 void SliceCacheController2Dx2D::InvertPixelOn(size_t pixelIndex)
 {
     m_impl.InvertPixelOn(pixelIndex);
+}
+
+void SliceCacheController2Dx2D::InvertAllPixels()
+{
+    m_impl.InvertAllPixels();
+}
+
+void SliceCacheController2Dx2D::SetPixelsOn(std::span<const size_t> pixelIndices, bool value)
+{
+    m_impl.SetPixelsOn(pixelIndices, value);
+}
+
+void SliceCacheController2Dx2D::SetRanks(std::span<const size_t> pixelIndices, size_t firstRank)
+{
+    m_impl.SetRanks(pixelIndices, firstRank);
+}
+
+void SliceCacheController2Dx2D::SetStats(VCStats* stats)
+{
+    m_impl.SetStats(stats);
 }
\ No newline at end of file
@@ -29,6 +29,13 @@ public:
     virtual void SetAllEnergyToZero() override;
 
     virtual void InvertPixelOn(size_t pixelIndex) override;
+    virtual void InvertAllPixels() override;
+
+    virtual void SetPixelsOn(std::span<const size_t> pixelIndices, bool value) override;
+
+    virtual void SetRanks(std::span<const size_t> pixelIndices, size_t firstRank) override;
+
+    virtual void SetStats(VCStats* stats) override;
 
 private:
     STBNData& m_data;
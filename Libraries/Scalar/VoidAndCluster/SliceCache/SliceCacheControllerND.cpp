@@ -0,0 +1,375 @@
+#include "SliceCacheControllerND.h"
+
+#include <algorithm>
+#include <cfloat>
+
+#include "SliceCacheFuncs.h"
+#include "Utils/PixelCoords.h"
+
+namespace
+{
+    const unsigned int c_allDims = (1 << 4) - 1;
+
+    size_t LowestDim(unsigned int dimBits)
+    {
+        size_t dim = 0;
+        while (dim < 4 && !(dimBits & (1 << dim)))
+            ++dim;
+        return dim;
+    }
+
+    size_t GroupSize(const Dimensions& dims, unsigned int dimBits)
+    {
+        size_t size = 1;
+        for (size_t dim = 0; dim < 4; ++dim)
+        {
+            if (dimBits & (1 << dim))
+                size *= dims.dim[dim];
+        }
+        return size;
+    }
+
+    // A mask has a bit set for each dimension that must match, so a group splats across the others.
+    // Groups are splatted in the order of their lowest dimension, which matches the reference controllers.
+    std::vector<unsigned int> MasksToSplatDims(const std::vector<unsigned int>& masks)
+    {
+        std::vector<unsigned int> ret;
+        for (unsigned int mask : masks)
+            ret.push_back(~mask & c_allDims);
+
+        std::sort(ret.begin(), ret.end(),
+            [](unsigned int a, unsigned int b)
+            {
+                return LowestDim(a) < LowestDim(b);
+            }
+        );
+        return ret;
+    }
+
+    // Largest group by pixel count, earliest one wins ties
+    unsigned int ChooseSliceDims(const Dimensions& dims, const std::vector<unsigned int>& splatDims)
+    {
+        unsigned int ret = 0;
+        size_t retSize = 0;
+        for (unsigned int dimBits : splatDims)
+        {
+            size_t size = GroupSize(dims, dimBits);
+            if (size > retSize)
+            {
+                ret = dimBits;
+                retSize = size;
+            }
+        }
+        return ret;
+    }
+}
+
+SliceCacheDataND::SliceCacheDataND(const Dimensions& dimensions, unsigned int sliceDims) :
+    sliceSize(GroupSize(dimensions, sliceDims)),
+    numSlices(GroupSize(dimensions, ~sliceDims & c_allDims)),
+    dirtyMax(numSlices, true),
+    maxValue(numSlices),
+    maxValueIndex(numSlices),
+    dirtyMin(numSlices, true),
+    minValue(numSlices),
+    minValueIndex(numSlices)
+{
+    size_t nextSliceStride = 1;
+    for (size_t dim = 0; dim < 4; ++dim)
+    {
+        if (sliceDims & (1 << dim))
+        {
+            sliceStride[dim] = 0;
+        }
+        else
+        {
+            sliceStride[dim] = nextSliceStride;
+            nextSliceStride *= dimensions.dim[dim];
+        }
+    }
+
+    // Pixel indices are a sum of a term per coordinate in every layout, so a pixel index is the
+    // base index of its slice (the coordinates outside the slice) plus an offset (the coordinates inside it)
+    slicePixelOffsets.reserve(sliceSize);
+    sliceBasePixelIndex.resize(numSlices);
+    PixelCoords coords;
+    for (coords.w = 0; coords.w < dimensions.w; ++coords.w)
+    {
+        for (coords.z = 0; coords.z < dimensions.z; ++coords.z)
+        {
+            for (coords.y = 0; coords.y < dimensions.y; ++coords.y)
+            {
+                for (coords.x = 0; coords.x < dimensions.x; ++coords.x)
+                {
+                    bool sliceOrigin = true;
+                    bool baseOrigin = true;
+                    size_t slice = 0;
+                    for (size_t dim = 0; dim < 4; ++dim)
+                    {
+                        if (sliceDims & (1 << dim))
+                            sliceOrigin = sliceOrigin && coords[dim] == 0;
+                        else
+                            baseOrigin = baseOrigin && coords[dim] == 0;
+                        slice += coords[dim] * sliceStride[dim];
+                    }
+
+                    if (baseOrigin)
+                        slicePixelOffsets.push_back(PixelCoordsToPixelIndex(coords, dimensions));
+                    if (sliceOrigin)
+                        sliceBasePixelIndex[slice] = PixelCoordsToPixelIndex(coords, dimensions);
+                }
+            }
+        }
+    }
+    std::sort(slicePixelOffsets.begin(), slicePixelOffsets.end());
+}
+
+SliceCacheControllerND::SliceCacheControllerND(STBNData& data, const std::vector<unsigned int>& masks, SymmetricKernel kernelX, SymmetricKernel kernelY, SymmetricKernel kernelZ, SymmetricKernel kernelW) :
+    m_data(data),
+    m_splatDims(MasksToSplatDims(masks)),
+    m_sliceDims(ChooseSliceDims(data.dimensions, m_splatDims)),
+    m_cache(data.dimensions, m_sliceDims),
+    m_kernels({ kernelX, kernelY, kernelZ, kernelW })
+{
+
+}
+
+STBNData& SliceCacheControllerND::GetSTBNData()
+{
+    return m_data;
+}
+
+size_t SliceCacheControllerND::GetPixelOnCount() const
+{
+    return m_data.pixelOn.Count();
+}
+
+size_t SliceCacheControllerND::GetTightestCluster()
+{
+    size_t clusterPixelIndex = 0;
+    float maxEnergy = -FLT_MAX;
+
+    for (size_t slice = 0; slice < m_cache.numSlices; slice++)
+    {
+        size_t sliceTightestClusterIndex = 0;
+        float sliceMaxEnergy = -FLT_MAX;
+
+        // Take the cached value if it's clean
+        if (!m_cache.dirtyMax[slice])
+        {
+            sliceTightestClusterIndex = m_cache.maxValueIndex[slice];
+            sliceMaxEnergy = m_cache.maxValue[slice];
+        }
+        // Otherwise compute it here
+        else
+        {
+            size_t basePixelIndex = m_cache.sliceBasePixelIndex[slice];
+            for (size_t offset : m_cache.slicePixelOffsets)
+            {
+                size_t i = basePixelIndex + offset;
+                if (!m_data.pixelOn[i])
+                    continue;
+
+                if (m_data.energy[i] > sliceMaxEnergy)
+                {
+                    sliceMaxEnergy = m_data.energy[i];
+                    sliceTightestClusterIndex = i;
+                }
+            }
+            // Update cache
+            m_cache.maxValue[slice] = sliceMaxEnergy;
+            m_cache.maxValueIndex[slice] = sliceTightestClusterIndex;
+            m_cache.dirtyMax[slice] = false;
+        }
+
+        // Slices aren't in pixel index order when the cache group isn't XY, so break ties on the index like a full scan would
+        if (sliceMaxEnergy > maxEnergy || (sliceMaxEnergy == maxEnergy && sliceTightestClusterIndex < clusterPixelIndex))
+        {
+            maxEnergy = sliceMaxEnergy;
+            clusterPixelIndex = sliceTightestClusterIndex;
+        }
+    }
+
+    return clusterPixelIndex;
+}
+
+size_t SliceCacheControllerND::GetLargestVoid()
+{
+    size_t voidPixelIndex = 0;
+    float minEnergy = FLT_MAX;
+
+    for (size_t slice = 0; slice < m_cache.numSlices; slice++)
+    {
+        size_t sliceLargestVoidIndex = 0;
+        float sliceMinEnergy = FLT_MAX;
+
+        // Take the cached value if it's clean
+        if (!m_cache.dirtyMin[slice])
+        {
+            sliceLargestVoidIndex = m_cache.minValueIndex[slice];
+            sliceMinEnergy = m_cache.minValue[slice];
+        }
+        // Otherwise compute it here
+        else
+        {
+            size_t basePixelIndex = m_cache.sliceBasePixelIndex[slice];
+            for (size_t offset : m_cache.slicePixelOffsets)
+            {
+                size_t i = basePixelIndex + offset;
+                if (m_data.pixelOn[i])
+                    continue;
+
+                if (m_data.energy[i] < sliceMinEnergy)
+                {
+                    sliceMinEnergy = m_data.energy[i];
+                    sliceLargestVoidIndex = i;
+                }
+            }
+            // Update cache
+            m_cache.minValue[slice] = sliceMinEnergy;
+            m_cache.minValueIndex[slice] = sliceLargestVoidIndex;
+            m_cache.dirtyMin[slice] = false;
+        }
+
+        if (sliceMinEnergy < minEnergy || (sliceMinEnergy == minEnergy && sliceLargestVoidIndex < voidPixelIndex))
+        {
+            minEnergy = sliceMinEnergy;
+            voidPixelIndex = sliceLargestVoidIndex;
+        }
+    }
+
+    return voidPixelIndex;
+}
+
+size_t SliceCacheControllerND::CoordsToSlice(const PixelCoords& coords) const
+{
+    return coords.x * m_cache.sliceStride[0] + coords.y * m_cache.sliceStride[1] + coords.z * m_cache.sliceStride[2] + coords.w * m_cache.sliceStride[3];
+}
+
+template<bool ON>
+void SliceCacheControllerND::Splat(const PixelCoords& pixelCoords, unsigned int splatDims)
+{
+    // Dimensions of the group, innermost first
+    size_t groupDims[4];
+    int offsets[4];
+    size_t numGroupDims = 0;
+    for (size_t dim = 0; dim < 4; ++dim)
+    {
+        if (splatDims & (1 << dim))
+        {
+            groupDims[numGroupDims] = dim;
+            offsets[numGroupDims] = m_kernels[dim].start();
+            numGroupDims++;
+        }
+    }
+
+    const Dimensions& dims = m_data.dimensions;
+    PixelCoords coords = pixelCoords;
+
+    // Nested loop over the group's kernel offsets, outermost dimension slowest
+    while (true)
+    {
+        float splatValue = m_kernels[groupDims[0]][size_t(abs(offsets[0]))];
+        coords[groupDims[0]] = CalcOffsetPixelCoord(pixelCoords[groupDims[0]], offsets[0], dims.dim[groupDims[0]]);
+        for (size_t i = 1; i < numGroupDims; ++i)
+        {
+            splatValue *= m_kernels[groupDims[i]][size_t(abs(offsets[i]))];
+            coords[groupDims[i]] = CalcOffsetPixelCoord(pixelCoords[groupDims[i]], offsets[i], dims.dim[groupDims[i]]);
+        }
+
+        size_t pixelIndex = PixelCoordsToPixelIndex(coords, dims);
+        SplatPixel<ON>(m_cache, m_data.energy, m_data.pixelOn, pixelIndex, splatValue, CoordsToSlice(coords));
+
+        size_t i = 0;
+        while (i < numGroupDims && ++offsets[i] > m_kernels[groupDims[i]].end())
+        {
+            offsets[i] = m_kernels[groupDims[i]].start();
+            i++;
+        }
+        if (i == numGroupDims)
+            break;
+    }
+}
+
+void SliceCacheControllerND::SplatOn(const PixelCoords& pixelCoords)
+{
+    for (unsigned int splatDims : m_splatDims)
+        Splat<true>(pixelCoords, splatDims);
+}
+
+void SliceCacheControllerND::SplatOff(const PixelCoords& pixelCoords)
+{
+    for (unsigned int splatDims : m_splatDims)
+        Splat<false>(pixelCoords, splatDims);
+}
+
+void SliceCacheControllerND::SetPixelOn(size_t pixelIndex, bool value)
+{
+    m_data.pixelOn.Set(pixelIndex, value);
+    size_t slice = CoordsToSlice(PixelIndexToPixelCoords(pixelIndex, m_data.dimensions));
+    m_cache.dirtyMin[slice] = true;
+    m_cache.dirtyMax[slice] = true;
+}
+
+void SliceCacheControllerND::SetPixelRank(size_t pixelIndex, size_t rank)
+{
+    m_data.pixelRank[pixelIndex] = rank;
+}
+
+void SliceCacheControllerND::SetAllEnergyToZero()
+{
+    std::fill(m_data.energy.begin(), m_data.energy.end(), 0.0f);
+    std::fill(m_cache.dirtyMin.begin(), m_cache.dirtyMin.end(), true);
+    std::fill(m_cache.dirtyMax.begin(), m_cache.dirtyMax.end(), true);
+}
+
+void SliceCacheControllerND::InvertPixelOn(size_t pixelIndex)
+{
+    m_data.pixelOn.Flip(pixelIndex);
+    size_t slice = CoordsToSlice(PixelIndexToPixelCoords(pixelIndex, m_data.dimensions));
+    m_cache.dirtyMin[slice] = true;
+    m_cache.dirtyMax[slice] = true;
+}
+
+void SliceCacheControllerND::InvertAllPixels()
+{
+    m_data.pixelOn.FlipAll();
+    std::fill(m_cache.dirtyMin.begin(), m_cache.dirtyMin.end(), true);
+    std::fill(m_cache.dirtyMax.begin(), m_cache.dirtyMax.end(), true);
+}
+
+void SliceCacheControllerND::SetPixelsOn(std::span<const size_t> pixelIndices, bool value)
+{
+    for (size_t pixelIndex : pixelIndices)
+        m_data.pixelOn.Set(pixelIndex, value);
+
+    if (pixelIndices.size() >= m_cache.numSlices)
+    {
+        std::fill(m_cache.dirtyMin.begin(), m_cache.dirtyMin.end(), true);
+        std::fill(m_cache.dirtyMax.begin(), m_cache.dirtyMax.end(), true);
+        return;
+    }
+
+    for (size_t pixelIndex : pixelIndices)
+    {
+        size_t slice = CoordsToSlice(PixelIndexToPixelCoords(pixelIndex, m_data.dimensions));
+        m_cache.dirtyMin[slice] = true;
+        m_cache.dirtyMax[slice] = true;
+    }
+}
+
+void SliceCacheControllerND::SetRanks(std::span<const size_t> pixelIndices, size_t firstRank)
+{
+    for (size_t index = 0; index < pixelIndices.size(); ++index)
+        m_data.pixelRank[pixelIndices[index]] = firstRank + index;
+}
+
+const std::vector<unsigned int>& SliceCacheControllerND::GetSplatDims() const
+{
+    return m_splatDims;
+}
+
+unsigned int SliceCacheControllerND::GetSliceDims() const
+{
+    return m_sliceDims;
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <vector>
+
+#include "VoidAndCluster/VCController.h"
+
+#include "Kernel/SymmetricKernel.h"
+#include "Utils/Dimensions.h"
+
+// Slices are the pixels which only differ in the dimensions of the cache group.
+// They aren't necessarily contiguous in memory, so each slice is its base pixel index plus a shared list of offsets.
+struct SliceCacheDataND
+{
+    SliceCacheDataND(const Dimensions& dimensions, unsigned int sliceDims);
+
+    size_t              sliceSize;
+    size_t              numSlices;
+    size_t              sliceStride[4];         // Slice index step per coordinate, 0 for the dimensions inside a slice
+
+    std::vector<size_t> slicePixelOffsets;      // Ascending, so a slice scan visits pixels in index order
+    std::vector<size_t> sliceBasePixelIndex;
+
+    std::vector<bool>   dirtyMax;
+    std::vector<float>  maxValue;
+    std::vector<size_t> maxValueIndex;
+
+    std::vector<bool>   dirtyMin;
+    std::vector<float>  minValue;
+    std::vector<size_t> minValueIndex;
+};
+
+// Slice cached controller for any grouping of the 4 dimensions, described by BlueNoiseTexturesND group masks.
+// Each group splats a separable kernel across its own dimensions. The cache is keyed by the largest group.
+class SliceCacheControllerND : public VCController
+{
+public:
+    SliceCacheControllerND(STBNData& data, const std::vector<unsigned int>& masks, SymmetricKernel kernelX, SymmetricKernel kernelY, SymmetricKernel kernelZ, SymmetricKernel kernelW);
+
+    virtual STBNData& GetSTBNData() override;
+
+    virtual size_t GetPixelOnCount() const override;
+
+    virtual size_t GetTightestCluster() override;
+
+    virtual size_t GetLargestVoid() override;
+
+    virtual void SplatOn(const PixelCoords& pixelCoords) override;
+
+    virtual void SplatOff(const PixelCoords& pixelCoords) override;
+
+    virtual void SetPixelOn(size_t pixelIndex, bool value) override;
+
+    virtual void SetPixelRank(size_t pixelIndex, size_t rank) override;
+
+    virtual void SetAllEnergyToZero() override;
+
+    virtual void InvertPixelOn(size_t pixelIndex) override;
+    virtual void InvertAllPixels() override;
+
+    virtual void SetPixelsOn(std::span<const size_t> pixelIndices, bool value) override;
+
+    virtual void SetRanks(std::span<const size_t> pixelIndices, size_t firstRank) override;
+
+    const std::vector<unsigned int>& GetSplatDims() const;
+
+    unsigned int GetSliceDims() const;
+
+private:
+    template<bool ON>
+    void Splat(const PixelCoords& pixelCoords, unsigned int splatDims);
+
+    size_t CoordsToSlice(const PixelCoords& coords) const;
+
+    STBNData& m_data;
+
+    std::vector<unsigned int> m_splatDims;  // Bit per dimension a group splats across, in splat order
+    unsigned int m_sliceDims;
+
+    SliceCacheDataND m_cache;
+
+    std::vector<SymmetricKernel> m_kernels;
+};
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <algorithm>
+#include <span>
+#include <vector>
+
+#include "ArenaAllocator.h"
+#include "Utils/PixelBitset.h"
+#include "Utils/PixelCoords.h"
+
+// Per pixel helpers shared by the slice cache engines.
+// CacheT needs per slice dirtyMin/minValue/minValueIndex and dirtyMax/maxValue/maxValueIndex.
+
+inline size_t CalcOffsetPixelCoord(size_t coord, int offset, size_t width)
+{
+    return (size_t)((((int)coord) + offset + (int)width) % width);
+}
+
+// Fills in sliceBasePixelIndex and slicePixelOffsets of an XY slice cache when the layout isn't linear.
+// They stay empty for the linear layout, where each XY slice is contiguous.
+template<typename CacheT>
+inline void InitXYSliceTables(CacheT& cache, const Dimensions& dims)
+{
+    if (dims.layout == PixelLayout::Linear)
+        return;
+
+    cache.sliceBasePixelIndex.resize(dims.z * dims.w);
+    for (size_t w = 0; w < dims.w; ++w)
+    {
+        for (size_t z = 0; z < dims.z; ++z)
+            cache.sliceBasePixelIndex[w * dims.z + z] = PixelCoordsToPixelIndex({ 0, 0, z, w }, dims);
+    }
+
+    cache.slicePixelOffsets.reserve(dims.x * dims.y);
+    for (size_t y = 0; y < dims.y; ++y)
+    {
+        for (size_t x = 0; x < dims.x; ++x)
+            cache.slicePixelOffsets.push_back(PixelCoordsToPixelIndex({ x, y, 0, 0 }, dims));
+    }
+    std::sort(cache.slicePixelOffsets.begin(), cache.slicePixelOffsets.end());
+}
+
+// Calls lambda(pixelIndex) for each pixel of an XY slice whose on bit is ON, in ascending pixel index order.
+// Contiguous slices are walked a pixelOn word at a time, skipping words with no matching pixels.
+template<bool ON, typename CacheT, typename LAMBDA>
+inline void ForEachPixelInXYSlice(const CacheT& cache, const PixelBitset& pixelOn, size_t sliceXYIndex, const LAMBDA& lambda)
+{
+    if (cache.slicePixelOffsets.empty())
+    {
+        size_t startPixelIndex = sliceXYIndex * cache.sliceSizeXY;
+        pixelOn.ForEachBit<ON>(startPixelIndex, startPixelIndex + cache.sliceSizeXY, lambda);
+    }
+    else
+    {
+        size_t basePixelIndex = cache.sliceBasePixelIndex[sliceXYIndex];
+        for (size_t offset : cache.slicePixelOffsets)
+        {
+            if (pixelOn[basePixelIndex + offset] == ON)
+                lambda(basePixelIndex + offset);
+        }
+    }
+}
+
+// Dirties the XY slices that hold any of the pixels. Past one pixel per slice it's cheaper to dirty them all.
+template<typename CacheT>
+inline void DirtySlicesOfPixels(CacheT& cache, const Dimensions& dims, std::span<const size_t> pixelIndices)
+{
+    if (pixelIndices.size() >= cache.numSlicesXY)
+    {
+        std::fill(cache.dirtyMax.begin(), cache.dirtyMax.end(), true);
+        std::fill(cache.dirtyMin.begin(), cache.dirtyMin.end(), true);
+        return;
+    }
+
+    for (size_t pixelIndex : pixelIndices)
+    {
+        PixelCoords coords = PixelIndexToPixelCoords(pixelIndex, dims);
+        size_t xySlice = coords.w * dims.z + coords.z;
+        cache.dirtyMax[xySlice] = true;
+        cache.dirtyMin[xySlice] = true;
+    }
+}
+
+// EnergyT is float, or an integer type for the fixed point engines
+template<bool ON, typename CacheT, typename EnergyT>
+inline void SplatPixel(CacheT& cache, ArenaVector<EnergyT>& energy, const PixelBitset& pixelOn, size_t pixelIndex, EnergyT splatValue, size_t slice)
+{
+    if (ON)
+    {
+        // Only dirty min if we're adding to the min
+        if (!cache.dirtyMin[slice] && !pixelOn[pixelIndex] && (energy[pixelIndex] == cache.minValue[slice]))
+        {
+            cache.dirtyMin[slice] = true;
+        }
+        energy[pixelIndex] += splatValue;// kernel[abs(iz)];
+        // Only update max if we're adding to the max. Ties go to the lower index, like a full scan.
+        if (!cache.dirtyMax[slice] && pixelOn[pixelIndex] && (energy[pixelIndex] > cache.maxValue[slice] || (energy[pixelIndex] == cache.maxValue[slice] && pixelIndex < cache.maxValueIndex[slice])))
+        {
+            cache.maxValue[slice] = energy[pixelIndex];
+            cache.maxValueIndex[slice] = pixelIndex;
+        }
+    }
+    else
+    {
+        // Only dirty max if we're subtracing from the max
+        if (!cache.dirtyMax[slice] && pixelOn[pixelIndex] && (energy[pixelIndex] == cache.maxValue[slice]))
+        {
+            cache.dirtyMax[slice] = true;
+        }
+        energy[pixelIndex] -= splatValue;// kernel[abs(iz)];
+        // Update min if it's the new min and the cache isn't dirty
+        if (!cache.dirtyMin[slice] && !pixelOn[pixelIndex] && (energy[pixelIndex] < cache.minValue[slice] || (energy[pixelIndex] == cache.minValue[slice] && pixelIndex < cache.minValueIndex[slice])))
+        {
+            cache.minValue[slice] = energy[pixelIndex];
+            cache.minValueIndex[slice] = pixelIndex;
+        }
+    }
+}
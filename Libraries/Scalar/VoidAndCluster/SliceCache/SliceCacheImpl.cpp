@@ -1,6 +1,9 @@
 #include "SliceCacheImpl.h"
 
+#include <algorithm>
+
 #include "Kernel/SymmetricKernel.h"
+#include "SliceCacheFuncs.h"
 #include "Utils/PixelCoords.h"
 
 SliceCacheData2Dx1Dx1D::SliceCacheData2Dx1Dx1D(const Dimensions& dimensions) :
@@ -14,7 +17,7 @@ SliceCacheData2Dx1Dx1D::SliceCacheData2Dx1Dx1D(const Dimensions& dimensions) :
     minValue(numSlicesXY, FLT_MAX),
     minValueIndex(numSlicesXY, 0)
 {
-
+    InitXYSliceTables(*this, dims);
 }
 
 STBNData& SliceCacheImpl::GetSTBNData()
@@ -22,22 +25,20 @@ STBNData& SliceCacheImpl::GetSTBNData()
     return m_data;
 }
 
-SliceCacheImpl::SliceCacheImpl(STBNData& data) :
+SliceCacheImpl::SliceCacheImpl(STBNData& data, std::vector<float> weightsXY) :
     m_data(data),
-    m_cache(data.dimensions)
+    m_cache(data.dimensions),
+    m_splatRow(GetSelectedSplatRowFuncs()),
+    m_sliceScan(GetSelectedSliceScanFuncs()),
+    m_weightsXY(std::move(weightsXY)),
+    m_stats(nullptr)
 {
 
 }
 
 size_t SliceCacheImpl::GetPixelOnCount() const
 {
-    size_t ret = 0;
-    for (bool b : m_data.pixelOn)
-    {
-        if (b)
-            ret++;
-    }
-    return ret;
+    return m_data.pixelOn.Count();
 }
 
 size_t SliceCacheImpl::GetTightestCluster() const
@@ -53,24 +54,42 @@ size_t SliceCacheImpl::GetTightestCluster() const
         // Take the cached value if it's clean
         if (!m_cache.dirtyMax[sliceXYIndex])
         {
+#if VC_STATS()
+            if (m_stats)
+                m_stats->Current().maxCacheHits++;
+#endif
             sliceTightestClusterIndex = m_cache.maxValueIndex[sliceXYIndex];
             sliceMaxEnergy = m_cache.maxValue[sliceXYIndex];
         }
         // Otherwise compute it here
         else
         {
-            size_t startPixelIndex = sliceXYIndex * m_cache.sliceSizeXY;
-            size_t endPixelIndex = startPixelIndex + m_cache.sliceSizeXY;
-            for (size_t i = startPixelIndex; i < endPixelIndex; i++)
+#if VC_STATS()
+            if (m_stats)
             {
-                if (!m_data.pixelOn[i])
-                    continue;
-
-                if (m_data.energy[i] > sliceMaxEnergy)
-                {
-                    sliceMaxEnergy = m_data.energy[i];
-                    sliceTightestClusterIndex = i;
-                }
+                m_stats->Current().maxCacheMisses++;
+                m_stats->Current().slicesRescanned++;
+                m_stats->Current().pixelsScanned += m_cache.sliceSizeXY;
+            }
+#endif
+            // Contiguous slices use the vector scan
+            if (m_cache.slicePixelOffsets.empty())
+            {
+                size_t startPixelIndex = sliceXYIndex * m_cache.sliceSizeXY;
+                m_sliceScan.max(m_data.energy.data(), m_data.pixelOn, startPixelIndex, startPixelIndex + m_cache.sliceSizeXY, sliceMaxEnergy, sliceTightestClusterIndex);
+            }
+            else
+            {
+                ForEachPixelInXYSlice<true>(m_cache, m_data.pixelOn, sliceXYIndex,
+                    [&](size_t i)
+                    {
+                        if (m_data.energy[i] > sliceMaxEnergy)
+                        {
+                            sliceMaxEnergy = m_data.energy[i];
+                            sliceTightestClusterIndex = i;
+                        }
+                    }
+                );
             }
             // Update cache
             m_cache.maxValue[sliceXYIndex] = sliceMaxEnergy;
@@ -78,7 +97,8 @@ size_t SliceCacheImpl::GetTightestCluster() const
             m_cache.dirtyMax[sliceXYIndex] = false;
         }
 
-        if (sliceMaxEnergy > maxEnergy)
+        // Slices aren't in pixel index order in a bricked layout, so break ties on the index like a full scan would
+        if (sliceMaxEnergy > maxEnergy || (sliceMaxEnergy == maxEnergy && sliceTightestClusterIndex < clusterPixelIndex))
         {
             maxEnergy = sliceMaxEnergy;
             clusterPixelIndex = sliceTightestClusterIndex;
@@ -101,24 +121,42 @@ size_t SliceCacheImpl::GetLargestVoid() const
         // Take the cached value if it's clean
         if (!m_cache.dirtyMin[sliceXYIndex])
         {
+#if VC_STATS()
+            if (m_stats)
+                m_stats->Current().minCacheHits++;
+#endif
             sliceLargestVoidIndex = m_cache.minValueIndex[sliceXYIndex];
             sliceMinEnergy = m_cache.minValue[sliceXYIndex];
         }
         // Otherwise compute it here
         else
         {
-            size_t startPixelIndex = sliceXYIndex * m_cache.sliceSizeXY;
-            size_t endPixelIndex = startPixelIndex + m_cache.sliceSizeXY;
-            for (size_t i = startPixelIndex; i < endPixelIndex; i++)
+#if VC_STATS()
+            if (m_stats)
+            {
+                m_stats->Current().minCacheMisses++;
+                m_stats->Current().slicesRescanned++;
+                m_stats->Current().pixelsScanned += m_cache.sliceSizeXY;
+            }
+#endif
+            // Contiguous slices use the vector scan
+            if (m_cache.slicePixelOffsets.empty())
+            {
+                size_t startPixelIndex = sliceXYIndex * m_cache.sliceSizeXY;
+                m_sliceScan.min(m_data.energy.data(), m_data.pixelOn, startPixelIndex, startPixelIndex + m_cache.sliceSizeXY, sliceMinEnergy, sliceLargestVoidIndex);
+            }
+            else
             {
-                if (m_data.pixelOn[i])
-                    continue;
-
-                if (m_data.energy[i] < sliceMinEnergy)
-                {
-                    sliceMinEnergy = m_data.energy[i];
-                    sliceLargestVoidIndex = i;
-                }
+                ForEachPixelInXYSlice<false>(m_cache, m_data.pixelOn, sliceXYIndex,
+                    [&](size_t i)
+                    {
+                        if (m_data.energy[i] < sliceMinEnergy)
+                        {
+                            sliceMinEnergy = m_data.energy[i];
+                            sliceLargestVoidIndex = i;
+                        }
+                    }
+                );
             }
             // Update cache
             m_cache.minValue[sliceXYIndex] = sliceMinEnergy;
@@ -126,7 +164,7 @@ size_t SliceCacheImpl::GetLargestVoid() const
             m_cache.dirtyMin[sliceXYIndex] = false;
         }
 
-        if (sliceMinEnergy < minEnergy)
+        if (sliceMinEnergy < minEnergy || (sliceMinEnergy == minEnergy && sliceLargestVoidIndex < voidPixelIndex))
         {
             minEnergy = sliceMinEnergy;
             voidPixelIndex = sliceLargestVoidIndex;
@@ -136,53 +174,13 @@ size_t SliceCacheImpl::GetLargestVoid() const
     return voidPixelIndex;
 }
 
-inline size_t CalcOffsetPixelCoord(size_t coord, int offset, size_t width)
-{
-    return (size_t)((((int)coord) + offset + (int)width) % width);
-}
-
 inline size_t CoordsToXYSlice(const PixelCoords& coords, const Dimensions& dims)
 {
     return (coords.w * dims.z) + coords.z;
 }
 
 template<bool ON>
-inline void SplatPixel(SliceCacheData2Dx1Dx1D& cache, std::vector<float>& energy, std::vector<bool>& pixelOn, size_t pixelIndex, float splatValue, size_t xySlice)
-{
-    if (ON)
-    {
-        // Only dirty min if we're adding to the min
-        if (!cache.dirtyMin[xySlice] && !pixelOn[pixelIndex] && (energy[pixelIndex] == cache.minValue[xySlice]))
-        {
-            cache.dirtyMin[xySlice] = true;
-        }
-        energy[pixelIndex] += splatValue;// kernel[abs(iz)];
-        // Only update max if we're adding to the max
-        if (!cache.dirtyMax[xySlice] && pixelOn[pixelIndex] && (energy[pixelIndex] > cache.maxValue[xySlice]))
-        {
-            cache.maxValue[xySlice] = energy[pixelIndex];
-            cache.maxValueIndex[xySlice] = pixelIndex;
-        }
-    }
-    else
-    {
-        // Only dirty max if we're subtracing from the max
-        if (!cache.dirtyMax[xySlice] && pixelOn[pixelIndex] && (energy[pixelIndex] == cache.maxValue[xySlice]))
-        {
-            cache.dirtyMax[xySlice] = true;
-        }
-        energy[pixelIndex] -= splatValue;// kernel[abs(iz)];
-        // Update min if it's the new min and the cache isn't dirty
-        if (!cache.dirtyMin[xySlice] && !pixelOn[pixelIndex] && (energy[pixelIndex] < cache.minValue[xySlice]))
-        {
-            cache.minValue[xySlice] = energy[pixelIndex];
-            cache.minValueIndex[xySlice] = pixelIndex;
-        }
-    }
-}
-
-template<bool ON>
-void SplatZ(SliceCacheData2Dx1Dx1D& cache, std::vector<float>& energy, std::vector<bool>& pixelOn, const Dimensions& dimensions, const PixelCoords& pixelCoords, const SymmetricKernel& kernel)
+void SplatZ(SliceCacheData2Dx1Dx1D& cache, ArenaVector<float>& energy, const PixelBitset& pixelOn, const Dimensions& dimensions, const PixelCoords& pixelCoords, const SymmetricKernel& kernel)
 {
     PixelCoords coords = pixelCoords;
 
@@ -201,16 +199,24 @@ void SplatZ(SliceCacheData2Dx1Dx1D& cache, std::vector<float>& energy, std::vect
 
 void SliceCacheImpl::SplatOnZ(const PixelCoords& pixelCoords, const SymmetricKernel& kernel)
 {
+#if VC_STATS()
+    if (m_stats)
+        m_stats->Current().splatTaps += NumKernelTaps(kernel);
+#endif
     SplatZ<true>(m_cache, m_data.energy, m_data.pixelOn, m_data.dimensions, pixelCoords, kernel);
 }
 
 void SliceCacheImpl::SplatOffZ(const PixelCoords& pixelCoords, const SymmetricKernel& kernel)
 {
+#if VC_STATS()
+    if (m_stats)
+        m_stats->Current().splatTaps += NumKernelTaps(kernel);
+#endif
     SplatZ<false>(m_cache, m_data.energy, m_data.pixelOn, m_data.dimensions, pixelCoords, kernel);
 }
 
 template<bool ON>
-void SplatW(SliceCacheData2Dx1Dx1D& cache, std::vector<float>& energy, const Dimensions& dimensions, const PixelCoords& pixelCoords, const SymmetricKernel& kernel)
+void SplatW(SliceCacheData2Dx1Dx1D& cache, ArenaVector<float>& energy, const Dimensions& dimensions, const PixelCoords& pixelCoords, const SymmetricKernel& kernel)
 {
     PixelCoords coords = pixelCoords;
 
@@ -238,16 +244,24 @@ void SplatW(SliceCacheData2Dx1Dx1D& cache, std::vector<float>& energy, const Dim
 
 void SliceCacheImpl::SplatOnW(const PixelCoords& pixelCoords, const SymmetricKernel& kernel)
 {
+#if VC_STATS()
+    if (m_stats)
+        m_stats->Current().splatTaps += NumKernelTaps(kernel);
+#endif
     SplatW<true>(m_cache, m_data.energy, m_data.dimensions, pixelCoords, kernel);
 }
 
 void SliceCacheImpl::SplatOffW(const PixelCoords& pixelCoords, const SymmetricKernel& kernel)
 {
+#if VC_STATS()
+    if (m_stats)
+        m_stats->Current().splatTaps += NumKernelTaps(kernel);
+#endif
     SplatW<false>(m_cache, m_data.energy, m_data.dimensions, pixelCoords, kernel);
 }
 
 template<bool ON>
-void SplatXY(SliceCacheData2Dx1Dx1D& cache, std::vector<float>& energy, std::vector<bool>& pixelOn, const Dimensions& dimensions, PixelCoords pixelCoords, const SymmetricKernel& outerKernel, const SymmetricKernel& innerKernel)
+void SplatXY(SliceCacheData2Dx1Dx1D& cache, ArenaVector<float>& energy, const PixelBitset& pixelOn, const Dimensions& dimensions, PixelCoords pixelCoords, const SymmetricKernel& outerKernel, const SymmetricKernel& innerKernel)
 {
     PixelCoords newCoords = pixelCoords;
     auto xySlice = CoordsToXYSlice(pixelCoords, dimensions);
@@ -268,18 +282,79 @@ void SplatXY(SliceCacheData2Dx1Dx1D& cache, std::vector<float>& energy, std::vec
     }
 }
 
+// Same taps as SplatXY, but each kernel row is one or two contiguous runs of energy (two if it wraps around X)
+// handed to a row function, which can do the adds and cache updates a vector at a time.
+void SplatXYRows(SliceCacheData2Dx1Dx1D& cache, ArenaVector<float>& energy, const PixelBitset& pixelOn, const Dimensions& dimensions, PixelCoords pixelCoords, const SymmetricKernel& outerKernel, const SymmetricKernel& innerKernel, const float* weights, SplatRowFunc splatRow)
+{
+    auto xySlice = CoordsToXYSlice(pixelCoords, dimensions);
+    SplatRowCache rowCache = { cache.dirtyMin[xySlice], cache.minValue[xySlice], cache.minValueIndex[xySlice], cache.dirtyMax[xySlice], cache.maxValue[xySlice], cache.maxValueIndex[xySlice] };
+
+    size_t width = size_t(innerKernel.end() - innerKernel.start() + 1);
+    size_t startX = CalcOffsetPixelCoord(pixelCoords.x, innerKernel.start(), dimensions.x);
+    size_t firstRunCount = std::min(width, dimensions.x - startX);
+    for (int iy = outerKernel.start(); iy <= outerKernel.end(); ++iy)
+    {
+        size_t y = CalcOffsetPixelCoord(pixelCoords.y, iy, dimensions.y);
+        size_t rowPixelIndex = xySlice * cache.sliceSizeXY + y * dimensions.x;
+        const float* rowWeights = weights + size_t(iy - outerKernel.start()) * width;
+
+        splatRow(energy.data(), rowWeights, firstRunCount, pixelOn, rowPixelIndex + startX, rowCache);
+        if (firstRunCount < width)
+            splatRow(energy.data(), rowWeights + firstRunCount, width - firstRunCount, pixelOn, rowPixelIndex, rowCache);
+    }
+
+    cache.dirtyMin[xySlice] = rowCache.dirtyMin;
+    cache.minValue[xySlice] = rowCache.minValue;
+    cache.minValueIndex[xySlice] = rowCache.minValueIndex;
+    cache.dirtyMax[xySlice] = rowCache.dirtyMax;
+    cache.maxValue[xySlice] = rowCache.maxValue;
+    cache.maxValueIndex[xySlice] = rowCache.maxValueIndex;
+}
+
+bool SliceCacheImpl::CanSplatXYRows(const SymmetricKernel& innerKernel) const
+{
+    return !m_weightsXY.empty() && m_cache.slicePixelOffsets.empty() && size_t(innerKernel.end() - innerKernel.start() + 1) <= m_data.dimensions.x;
+}
+
+std::vector<float> SliceCacheImpl::MakeWeightsXY(const SymmetricKernel& outerKernel, const SymmetricKernel& innerKernel)
+{
+    // Same product as SplatXY, so the energies don't change
+    std::vector<float> weights;
+    weights.reserve(NumKernelTaps(outerKernel) * NumKernelTaps(innerKernel));
+    for (int iy = outerKernel.start(); iy <= outerKernel.end(); ++iy)
+    {
+        for (int ix = innerKernel.start(); ix <= innerKernel.end(); ++ix)
+            weights.push_back(innerKernel[size_t(abs(ix))] * outerKernel[size_t(abs(iy))]);
+    }
+    return weights;
+}
+
 void SliceCacheImpl::SplatOnXY(const PixelCoords& pixelCoords, const SymmetricKernel& outerKernel, const SymmetricKernel& innerKernel)
 {
-    SplatXY<true>(m_cache, m_data.energy, m_data.pixelOn, m_data.dimensions, pixelCoords, outerKernel, innerKernel);
+#if VC_STATS()
+    if (m_stats)
+        m_stats->Current().splatTaps += NumKernelTaps(outerKernel) * NumKernelTaps(innerKernel);
+#endif
+    if (CanSplatXYRows(innerKernel))
+        SplatXYRows(m_cache, m_data.energy, m_data.pixelOn, m_data.dimensions, pixelCoords, outerKernel, innerKernel, m_weightsXY.data(), m_splatRow.on);
+    else
+        SplatXY<true>(m_cache, m_data.energy, m_data.pixelOn, m_data.dimensions, pixelCoords, outerKernel, innerKernel);
 }
 
 void SliceCacheImpl::SplatOffXY(const PixelCoords& pixelCoords, const SymmetricKernel& outerKernel, const SymmetricKernel& innerKernel)
 {
-    SplatXY<false>(m_cache, m_data.energy, m_data.pixelOn, m_data.dimensions, pixelCoords, outerKernel, innerKernel);
+#if VC_STATS()
+    if (m_stats)
+        m_stats->Current().splatTaps += NumKernelTaps(outerKernel) * NumKernelTaps(innerKernel);
+#endif
+    if (CanSplatXYRows(innerKernel))
+        SplatXYRows(m_cache, m_data.energy, m_data.pixelOn, m_data.dimensions, pixelCoords, outerKernel, innerKernel, m_weightsXY.data(), m_splatRow.off);
+    else
+        SplatXY<false>(m_cache, m_data.energy, m_data.pixelOn, m_data.dimensions, pixelCoords, outerKernel, innerKernel);
 }
 
 template<bool ON>
-void SplatZW(SliceCacheData2Dx1Dx1D& cache, std::vector<float>& energy, std::vector<bool>& pixelOn, const Dimensions& dimensions, PixelCoords pixelCoords, const SymmetricKernel& outerKernel, const SymmetricKernel& innerKernel)
+void SplatZW(SliceCacheData2Dx1Dx1D& cache, ArenaVector<float>& energy, const PixelBitset& pixelOn, const Dimensions& dimensions, PixelCoords pixelCoords, const SymmetricKernel& outerKernel, const SymmetricKernel& innerKernel)
 {
     PixelCoords newCoords = pixelCoords;
     for (int iw = outerKernel.start(); iw <= outerKernel.end(); ++iw)
@@ -302,17 +377,25 @@ void SplatZW(SliceCacheData2Dx1Dx1D& cache, std::vector<float>& energy, std::vec
 
 void SliceCacheImpl::SplatOnZW(const PixelCoords& pixelCoords, const SymmetricKernel& outerKernel, const SymmetricKernel& innerKernel)
 {
+#if VC_STATS()
+    if (m_stats)
+        m_stats->Current().splatTaps += NumKernelTaps(outerKernel) * NumKernelTaps(innerKernel);
+#endif
     SplatZW<true>(m_cache, m_data.energy, m_data.pixelOn, m_data.dimensions, pixelCoords, outerKernel, innerKernel);
 }
 
 void SliceCacheImpl::SplatOffZW(const PixelCoords& pixelCoords, const SymmetricKernel& outerKernel, const SymmetricKernel& innerKernel)
 {
+#if VC_STATS()
+    if (m_stats)
+        m_stats->Current().splatTaps += NumKernelTaps(outerKernel) * NumKernelTaps(innerKernel);
+#endif
     SplatZW<false>(m_cache, m_data.energy, m_data.pixelOn, m_data.dimensions, pixelCoords, outerKernel, innerKernel);
 }
 
 void SliceCacheImpl::SetPixelOn(size_t pixelIndex, bool value)
 {
-    m_data.pixelOn[pixelIndex] = value;
+    m_data.pixelOn.Set(pixelIndex, value);
     auto xySlice = CoordsToXYSlice(PixelIndexToPixelCoords(pixelIndex, m_data.dimensions), m_data.dimensions);
     m_cache.dirtyMax[xySlice] = true;
     m_cache.dirtyMin[xySlice] = true;
@@ -333,4 +416,34 @@ void SliceCacheImpl::SetAllEnergyToZero()
 void SliceCacheImpl::InvertPixelOn(size_t pixelIndex)
 {
     SetPixelOn(pixelIndex, !m_data.pixelOn[pixelIndex]);
+}
+
+void SliceCacheImpl::InvertAllPixels()
+{
+    m_data.pixelOn.FlipAll();
+    std::fill(m_cache.dirtyMax.begin(), m_cache.dirtyMax.end(), true);
+    std::fill(m_cache.dirtyMin.begin(), m_cache.dirtyMin.end(), true);
+}
+
+void SliceCacheImpl::SetPixelsOn(std::span<const size_t> pixelIndices, bool value)
+{
+    for (size_t pixelIndex : pixelIndices)
+        m_data.pixelOn.Set(pixelIndex, value);
+    DirtySlicesOfPixels(m_cache, m_data.dimensions, pixelIndices);
+}
+
+void SliceCacheImpl::SetRanks(std::span<const size_t> pixelIndices, size_t firstRank)
+{
+    for (size_t index = 0; index < pixelIndices.size(); ++index)
+        m_data.pixelRank[pixelIndices[index]] = firstRank + index;
+}
+
+void SliceCacheImpl::SetStats(VCStats* stats)
+{
+    m_stats = stats;
+}
+
+CPUISA SliceCacheImpl::GetSplatRowISA() const
+{
+    return m_splatRow.isa;
 }
\ No newline at end of file
@@ -7,7 +7,10 @@ class SymmetricKernel;
 
 #include "Utils/Dimensions.h"
 #include "STBNData.h"
+#include "SliceScan.h"
+#include "SplatRow.h"
 #include "VoidAndCluster/VCImpl.h"
+#include "VoidAndCluster/VCStats.h"
 
 struct SliceCacheData2Dx1Dx1D
 {
@@ -17,6 +20,11 @@ struct SliceCacheData2Dx1Dx1D
     size_t              sliceSizeXY;
     size_t              numSlicesXY;
 
+    // Only filled in when the layout isn't linear, which makes XY slices non-contiguous.
+    // A slice is then its base pixel index plus each of the ascending offsets.
+    std::vector<size_t> sliceBasePixelIndex;
+    std::vector<size_t> slicePixelOffsets;
+
     std::vector<bool>   dirtyMax;
     std::vector<float>  maxValue;
     std::vector<size_t> maxValueIndex;
@@ -29,7 +37,10 @@ struct SliceCacheData2Dx1Dx1D
 class SliceCacheImpl : public VCImpl
 {
 public:
-    SliceCacheImpl(STBNData& data);
+    // weightsXY is MakeWeightsXY() of the kernels the owner passes to every XY splat. It lets XY splats go a row at a time, and without it they go a tap at a time.
+    SliceCacheImpl(STBNData& data, std::vector<float> weightsXY = {});
+
+    static std::vector<float> MakeWeightsXY(const SymmetricKernel& outerKernel, const SymmetricKernel& innerKernel);
 
     virtual STBNData& GetSTBNData() override;
 
@@ -62,8 +73,28 @@ public:
     virtual void SetAllEnergyToZero() override;
 
     virtual void InvertPixelOn(size_t pixelIndex) override;
+    virtual void InvertAllPixels() override;
+
+    virtual void SetPixelsOn(std::span<const size_t> pixelIndices, bool value) override;
+
+    virtual void SetRanks(std::span<const size_t> pixelIndices, size_t firstRank) override;
+
+    virtual void SetStats(VCStats* stats) override;
+
+    CPUISA GetSplatRowISA() const;
 
 private:
+    // Whether XY splats can go a contiguous row at a time: there's a weight table, linear layout, and no row wraps onto itself
+    bool CanSplatXYRows(const SymmetricKernel& innerKernel) const;
+
     STBNData& m_data;
     mutable SliceCacheData2Dx1Dx1D m_cache;
+
+    const SplatRowFuncs& m_splatRow;
+    const SliceScanFuncs& m_sliceScan;
+
+    // Outer product of the XY kernels, a row of inner taps per outer tap
+    std::vector<float> m_weightsXY;
+
+    VCStats* m_stats;
 };
\ No newline at end of file
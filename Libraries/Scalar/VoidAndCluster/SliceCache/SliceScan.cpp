@@ -0,0 +1,162 @@
+#include "SliceScan.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#if STBN_X86()
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <immintrin.h>
+#endif
+#endif
+
+namespace
+{
+
+template<bool MAX>
+void SliceScanScalar(const float* energy, const PixelBitset& pixelOn, size_t begin, size_t end, float& bestValue, size_t& bestIndex)
+{
+    pixelOn.ForEachBit<MAX>(begin, end,
+        [&](size_t pixelIndex)
+        {
+            if (MAX ? (energy[pixelIndex] > bestValue) : (energy[pixelIndex] < bestValue))
+            {
+                bestValue = energy[pixelIndex];
+                bestIndex = pixelIndex;
+            }
+        }
+    );
+}
+
+// Folds the per lane best of the vector loop into the running best. Lanes keep their first best and every
+// lane index comes after the incoming best, so only a strictly better value replaces it and lane ties go to the lowest index.
+template<bool MAX, size_t LANES>
+void MergeLaneBest(const float* laneValue, const int32_t* laneIndex, size_t begin, float& bestValue, size_t& bestIndex)
+{
+    bool found = false;
+    float value = bestValue;
+    size_t index = bestIndex;
+    for (size_t lane = 0; lane < LANES; ++lane)
+    {
+        if (laneIndex[lane] < 0)
+            continue;
+        size_t pixelIndex = begin + size_t(laneIndex[lane]);
+        bool better = MAX ? (laneValue[lane] > value) : (laneValue[lane] < value);
+        if (better || (found && laneValue[lane] == value && pixelIndex < index))
+        {
+            found = true;
+            value = laneValue[lane];
+            index = pixelIndex;
+        }
+    }
+    bestValue = value;
+    bestIndex = index;
+}
+
+#if STBN_X86()
+
+// Lanes with no candidate pixels are skipped a whole vector at a time, like ForEachBit skips empty words.
+// Each compare and blend waits on the last one for the same vector, so four vectors of running bests are kept to overlap them.
+template<bool MAX>
+STBN_TARGET_AVX2
+void SliceScanAVX2(const float* energy, const PixelBitset& pixelOn, size_t begin, size_t end, float& bestValue, size_t& bestIndex)
+{
+    const __m256i bitSelect = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+    const __m256i laneOffsets = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+
+    __m256 laneBestValue[4];
+    __m256i laneBestIndex[4];
+    for (int vector = 0; vector < 4; ++vector)
+    {
+        laneBestValue[vector] = _mm256_set1_ps(MAX ? -INFINITY : INFINITY);
+        laneBestIndex[vector] = _mm256_set1_epi32(-1);
+    }
+
+    for (size_t i = begin; i < end; i += 32)
+    {
+        size_t numPixels = std::min(end - i, size_t(32));
+        uint32_t bits = pixelOn.GetBits(i, numPixels);
+        uint32_t candidates = MAX ? bits : (~bits & uint32_t((uint64_t(1) << numPixels) - 1));
+        if (candidates == 0)
+            continue;
+
+        for (int vector = 0; vector < 4; ++vector)
+        {
+            uint32_t vectorCandidates = (candidates >> (8 * vector)) & 0xff;
+            if (vectorCandidates == 0)
+                continue;
+
+            size_t offset = i + 8 * vector;
+            __m256i candidateMask = _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_set1_epi32(int(vectorCandidates)), bitSelect), bitSelect);
+            // Only the last vector of the range can run past the end of the energy
+            __m256 value = (offset + 8 <= end) ? _mm256_loadu_ps(energy + offset) : _mm256_maskload_ps(energy + offset, candidateMask);
+            __m256 better = _mm256_and_ps(_mm256_castsi256_ps(candidateMask), _mm256_cmp_ps(value, laneBestValue[vector], MAX ? _CMP_GT_OQ : _CMP_LT_OQ));
+            laneBestValue[vector] = _mm256_blendv_ps(laneBestValue[vector], value, better);
+            __m256i index = _mm256_add_epi32(_mm256_set1_epi32(int(offset - begin)), laneOffsets);
+            laneBestIndex[vector] = _mm256_castps_si256(_mm256_blendv_ps(_mm256_castsi256_ps(laneBestIndex[vector]), _mm256_castsi256_ps(index), better));
+        }
+    }
+
+    alignas(32) float laneValue[32];
+    alignas(32) int32_t laneIndex[32];
+    for (int vector = 0; vector < 4; ++vector)
+    {
+        _mm256_store_ps(laneValue + 8 * vector, laneBestValue[vector]);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(laneIndex + 8 * vector), laneBestIndex[vector]);
+    }
+    MergeLaneBest<MAX, 32>(laneValue, laneIndex, begin, bestValue, bestIndex);
+}
+
+template<bool MAX>
+STBN_TARGET_AVX512
+void SliceScanAVX512(const float* energy, const PixelBitset& pixelOn, size_t begin, size_t end, float& bestValue, size_t& bestIndex)
+{
+    const __m512i laneOffsets = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+
+    __m512 laneBestValue = _mm512_set1_ps(MAX ? -INFINITY : INFINITY);
+    __m512i laneBestIndex = _mm512_set1_epi32(-1);
+
+    for (size_t i = begin; i < end; i += 16)
+    {
+        size_t numLanes = std::min(end - i, size_t(16));
+        uint32_t bits = pixelOn.GetBits(i, numLanes);
+        __mmask16 candidates = __mmask16(MAX ? bits : (~bits & ((uint32_t(1) << numLanes) - 1)));
+        if (candidates == 0)
+            continue;
+
+        __m512 value = _mm512_maskz_loadu_ps(candidates, energy + i);
+        __mmask16 better = _mm512_mask_cmp_ps_mask(candidates, value, laneBestValue, MAX ? _CMP_GT_OQ : _CMP_LT_OQ);
+        laneBestValue = _mm512_mask_mov_ps(laneBestValue, better, value);
+        laneBestIndex = _mm512_mask_mov_epi32(laneBestIndex, better, _mm512_add_epi32(_mm512_set1_epi32(int(i - begin)), laneOffsets));
+    }
+
+    alignas(64) float laneValue[16];
+    alignas(64) int32_t laneIndex[16];
+    _mm512_store_ps(laneValue, laneBestValue);
+    _mm512_store_si512(laneIndex, laneBestIndex);
+    MergeLaneBest<MAX, 16>(laneValue, laneIndex, begin, bestValue, bestIndex);
+}
+
+#endif
+
+}
+
+SliceScanFuncs GetSliceScanFuncs(CPUISA isa)
+{
+#if STBN_X86()
+    static const ISADispatch<SliceScanFunc> max(&SliceScanScalar<true>, &SliceScanAVX2<true>, &SliceScanAVX512<true>);
+    static const ISADispatch<SliceScanFunc> min(&SliceScanScalar<false>, &SliceScanAVX2<false>, &SliceScanAVX512<false>);
+#else
+    static const ISADispatch<SliceScanFunc> max(&SliceScanScalar<true>, nullptr, nullptr);
+    static const ISADispatch<SliceScanFunc> min(&SliceScanScalar<false>, nullptr, nullptr);
+#endif
+    return { max.Resolve(isa), max.Get(isa), min.Get(isa) };
+}
+
+const SliceScanFuncs& GetSelectedSliceScanFuncs()
+{
+    static const SliceScanFuncs funcs = GetSliceScanFuncs(GetSelectedISA());
+    return funcs;
+}
\ No newline at end of file
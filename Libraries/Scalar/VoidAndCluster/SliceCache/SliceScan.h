@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstddef>
+
+#include "CPUDispatch.h"
+#include "Utils/PixelBitset.h"
+
+// Finds the highest energy on pixel (max) or the lowest energy off pixel (min) in [begin, end), for rescanning dirty slices.
+// bestValue and bestIndex come in as the best so far and are only replaced by a strictly better pixel,
+// and ties go to the lowest index, so every version gives the same answer as a pixel by pixel scan.
+using SliceScanFunc = void (*)(const float* energy, const PixelBitset& pixelOn, size_t begin, size_t end, float& bestValue, size_t& bestIndex);
+
+struct SliceScanFuncs
+{
+    CPUISA isa;
+    SliceScanFunc max;
+    SliceScanFunc min;
+};
+
+// The widest version at or below isa that this build and CPU can run
+SliceScanFuncs GetSliceScanFuncs(CPUISA isa);
+
+// The version for GetSelectedISA(), picked on first use
+const SliceScanFuncs& GetSelectedSliceScanFuncs();
\ No newline at end of file
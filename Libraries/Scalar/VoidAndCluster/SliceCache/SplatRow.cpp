@@ -0,0 +1,208 @@
+#include "SplatRow.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+
+#if STBN_X86()
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <immintrin.h>
+#endif
+#endif
+
+namespace
+{
+
+template<bool ON>
+void SplatRowScalar(float* energy, const float* weights, size_t count, const PixelBitset& pixelOn, size_t firstPixelIndex, SplatRowCache& cache)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        size_t pixelIndex = firstPixelIndex + i;
+        bool on = pixelOn[pixelIndex];
+        float& value = energy[pixelIndex];
+        if (ON)
+        {
+            if (!cache.dirtyMin && !on && (value == cache.minValue))
+                cache.dirtyMin = true;
+            value += weights[i];
+            if (!cache.dirtyMax && on && (value > cache.maxValue || (value == cache.maxValue && pixelIndex < cache.maxValueIndex)))
+            {
+                cache.maxValue = value;
+                cache.maxValueIndex = pixelIndex;
+            }
+        }
+        else
+        {
+            if (!cache.dirtyMax && on && (value == cache.maxValue))
+                cache.dirtyMax = true;
+            value -= weights[i];
+            if (!cache.dirtyMin && !on && (value < cache.minValue || (value == cache.minValue && pixelIndex < cache.minValueIndex)))
+            {
+                cache.minValue = value;
+                cache.minValueIndex = pixelIndex;
+            }
+        }
+    }
+}
+
+// Folds the per lane best of the vector loop into the cache. Lanes keep their first best, so ties go to the lowest index.
+template<bool ON, size_t LANES>
+void MergeLaneBest(const float* laneValue, const int32_t* laneIndex, size_t firstPixelIndex, SplatRowCache& cache)
+{
+    for (size_t lane = 0; lane < LANES; ++lane)
+    {
+        if (laneIndex[lane] < 0)
+            continue;
+        float value = laneValue[lane];
+        size_t pixelIndex = firstPixelIndex + size_t(laneIndex[lane]);
+        if (ON)
+        {
+            if (value > cache.maxValue || (value == cache.maxValue && pixelIndex < cache.maxValueIndex))
+            {
+                cache.maxValue = value;
+                cache.maxValueIndex = pixelIndex;
+            }
+        }
+        else
+        {
+            if (value < cache.minValue || (value == cache.minValue && pixelIndex < cache.minValueIndex))
+            {
+                cache.minValue = value;
+                cache.minValueIndex = pixelIndex;
+            }
+        }
+    }
+}
+
+#if STBN_X86()
+
+// Splatting on can only make the cached min (of off pixels) stale and the max (of on pixels) bigger, and off the reverse.
+// So each vector: compare against the value that could go stale, add, then keep a per lane best of the others.
+// The last partial vector is masked rather than left to scalar code, since kernel rows are often shorter than a vector.
+template<bool ON>
+STBN_TARGET_AVX2
+void SplatRowAVX2(float* energy, const float* weights, size_t count, const PixelBitset& pixelOn, size_t firstPixelIndex, SplatRowCache& cache)
+{
+    const __m256i bitSelect = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+    const __m256i laneOffsets = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+
+    bool& staleDirty = ON ? cache.dirtyMin : cache.dirtyMax;
+    const bool trackBest = ON ? !cache.dirtyMax : !cache.dirtyMin;
+    const __m256 staleValue = _mm256_set1_ps(ON ? cache.minValue : cache.maxValue);
+
+    __m256 bestValue = _mm256_set1_ps(ON ? -INFINITY : INFINITY);
+    __m256i bestIndex = _mm256_set1_epi32(-1);
+
+    for (size_t i = 0; i < count; i += 8)
+    {
+        size_t numLanes = std::min(count - i, size_t(8));
+        __m256i validMask = _mm256_cmpgt_epi32(_mm256_set1_epi32(int(numLanes)), laneOffsets);
+        __m256i bits = _mm256_set1_epi32(int(pixelOn.GetBits(firstPixelIndex + i, numLanes)));
+        __m256i onMask = _mm256_cmpeq_epi32(_mm256_and_si256(bits, bitSelect), bitSelect);
+        __m256i offMask = _mm256_andnot_si256(onMask, validMask);
+        // The pixels whose cached value can go stale, and the ones that can become the new best
+        __m256 staleMask = _mm256_castsi256_ps(ON ? offMask : onMask);
+        __m256 bestMask = _mm256_castsi256_ps(ON ? onMask : offMask);
+
+        float* row = energy + firstPixelIndex + i;
+        __m256 value = _mm256_maskload_ps(row, validMask);
+        if (!staleDirty && _mm256_movemask_ps(_mm256_and_ps(staleMask, _mm256_cmp_ps(value, staleValue, _CMP_EQ_OQ))))
+            staleDirty = true;
+
+        __m256 weight = _mm256_maskload_ps(weights + i, validMask);
+        value = ON ? _mm256_add_ps(value, weight) : _mm256_sub_ps(value, weight);
+        _mm256_maskstore_ps(row, validMask, value);
+
+        if (trackBest)
+        {
+            __m256 better = _mm256_and_ps(bestMask, _mm256_cmp_ps(value, bestValue, ON ? _CMP_GT_OQ : _CMP_LT_OQ));
+            bestValue = _mm256_blendv_ps(bestValue, value, better);
+            __m256i index = _mm256_add_epi32(_mm256_set1_epi32(int(i)), laneOffsets);
+            bestIndex = _mm256_castps_si256(_mm256_blendv_ps(_mm256_castsi256_ps(bestIndex), _mm256_castsi256_ps(index), better));
+        }
+    }
+
+    if (trackBest)
+    {
+        alignas(32) float laneValue[8];
+        alignas(32) int32_t laneIndex[8];
+        _mm256_store_ps(laneValue, bestValue);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(laneIndex), bestIndex);
+        MergeLaneBest<ON, 8>(laneValue, laneIndex, firstPixelIndex, cache);
+    }
+}
+
+template<bool ON>
+STBN_TARGET_AVX512
+void SplatRowAVX512(float* energy, const float* weights, size_t count, const PixelBitset& pixelOn, size_t firstPixelIndex, SplatRowCache& cache)
+{
+    const __m512i laneOffsets = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+
+    bool& staleDirty = ON ? cache.dirtyMin : cache.dirtyMax;
+    const bool trackBest = ON ? !cache.dirtyMax : !cache.dirtyMin;
+    const __m512 staleValue = _mm512_set1_ps(ON ? cache.minValue : cache.maxValue);
+
+    __m512 bestValue = _mm512_set1_ps(ON ? -INFINITY : INFINITY);
+    __m512i bestIndex = _mm512_set1_epi32(-1);
+
+    for (size_t i = 0; i < count; i += 16)
+    {
+        size_t numLanes = std::min(count - i, size_t(16));
+        __mmask16 validMask = __mmask16((uint32_t(1) << numLanes) - 1);
+        __mmask16 onMask = __mmask16(pixelOn.GetBits(firstPixelIndex + i, numLanes));
+        __mmask16 offMask = __mmask16(~onMask & validMask);
+        __mmask16 staleMask = ON ? offMask : onMask;
+        __mmask16 bestMask = ON ? onMask : offMask;
+
+        float* row = energy + firstPixelIndex + i;
+        __m512 value = _mm512_maskz_loadu_ps(validMask, row);
+        if (!staleDirty && _mm512_mask_cmp_ps_mask(staleMask, value, staleValue, _CMP_EQ_OQ))
+            staleDirty = true;
+
+        __m512 weight = _mm512_maskz_loadu_ps(validMask, weights + i);
+        value = ON ? _mm512_add_ps(value, weight) : _mm512_sub_ps(value, weight);
+        _mm512_mask_storeu_ps(row, validMask, value);
+
+        if (trackBest)
+        {
+            __mmask16 better = _mm512_mask_cmp_ps_mask(bestMask, value, bestValue, ON ? _CMP_GT_OQ : _CMP_LT_OQ);
+            bestValue = _mm512_mask_mov_ps(bestValue, better, value);
+            bestIndex = _mm512_mask_mov_epi32(bestIndex, better, _mm512_add_epi32(_mm512_set1_epi32(int(i)), laneOffsets));
+        }
+    }
+
+    if (trackBest)
+    {
+        alignas(64) float laneValue[16];
+        alignas(64) int32_t laneIndex[16];
+        _mm512_store_ps(laneValue, bestValue);
+        _mm512_store_si512(laneIndex, bestIndex);
+        MergeLaneBest<ON, 16>(laneValue, laneIndex, firstPixelIndex, cache);
+    }
+}
+
+#endif
+
+}
+
+SplatRowFuncs GetSplatRowFuncs(CPUISA isa)
+{
+#if STBN_X86()
+    static const ISADispatch<SplatRowFunc> on(&SplatRowScalar<true>, &SplatRowAVX2<true>, &SplatRowAVX512<true>);
+    static const ISADispatch<SplatRowFunc> off(&SplatRowScalar<false>, &SplatRowAVX2<false>, &SplatRowAVX512<false>);
+#else
+    static const ISADispatch<SplatRowFunc> on(&SplatRowScalar<true>, nullptr, nullptr);
+    static const ISADispatch<SplatRowFunc> off(&SplatRowScalar<false>, nullptr, nullptr);
+#endif
+    return { on.Resolve(isa), on.Get(isa), off.Get(isa) };
+}
+
+const SplatRowFuncs& GetSelectedSplatRowFuncs()
+{
+    static const SplatRowFuncs funcs = GetSplatRowFuncs(GetSelectedISA());
+    return funcs;
+}
\ No newline at end of file
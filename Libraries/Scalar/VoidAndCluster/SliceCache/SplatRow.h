@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+
+#include "CPUDispatch.h"
+#include "Utils/PixelBitset.h"
+
+// The cache entries of one XY slice, copied out so the row kernels don't depend on the cache type
+struct SplatRowCache
+{
+    bool    dirtyMin;
+    float   minValue;
+    size_t  minValueIndex;
+
+    bool    dirtyMax;
+    float   maxValue;
+    size_t  maxValueIndex;
+};
+
+// Adds (on) or subtracts (off) weights[i] to energy[firstPixelIndex + i] for i < count, and keeps the cache
+// exactly as SplatPixel would have going pixel by pixel, so the vector versions give bit identical results.
+using SplatRowFunc = void (*)(float* energy, const float* weights, size_t count, const PixelBitset& pixelOn, size_t firstPixelIndex, SplatRowCache& cache);
+
+struct SplatRowFuncs
+{
+    CPUISA isa;
+    SplatRowFunc on;
+    SplatRowFunc off;
+};
+
+// The widest version at or below isa that this build and CPU can run
+SplatRowFuncs GetSplatRowFuncs(CPUISA isa);
+
+// The version for GetSelectedISA(), picked on first use
+const SplatRowFuncs& GetSelectedSplatRowFuncs();
\ No newline at end of file
@@ -3,4 +3,9 @@
 VCController::~VCController()
 {
 	
+}
+
+void VCController::SetStats(VCStats* stats)
+{
+
 }
\ No newline at end of file
@@ -1,6 +1,9 @@
 #pragma once
 
 union PixelCoords;
+struct VCStats;
+
+#include <span>
 
 #include "STBNData.h"
 
@@ -28,4 +31,17 @@ public:
     virtual void SetAllEnergyToZero() = 0;
 
     virtual void InvertPixelOn(size_t pixelIndex) = 0;
+
+    // Bulk versions of the above, for when a phase touches many pixels at once.
+    // Engines do them in one pass with one cache invalidation instead of a virtual call and invalidation per pixel.
+    virtual void InvertAllPixels() = 0;
+
+    virtual void SetPixelsOn(std::span<const size_t> pixelIndices, bool value) = 0;
+
+    // pixelIndices[i] gets rank firstRank + i
+    virtual void SetRanks(std::span<const size_t> pixelIndices, size_t firstRank) = 0;
+
+    // Where engines that track scan and splat counters add them, when built with VC_STATS(). nullptr stops them.
+    // Engines without counters ignore it.
+    virtual void SetStats(VCStats* stats);
 };
\ No newline at end of file
@@ -3,4 +3,9 @@
 VCImpl::~VCImpl()
 {
 	
+}
+
+void VCImpl::SetStats(VCStats* stats)
+{
+
 }
\ No newline at end of file
@@ -2,8 +2,11 @@
 
 union PixelCoords;
 struct STBNData;
+struct VCStats;
 class SymmetricKernel;
 
+#include <span>
+
 class VCImpl
 {
 public:
@@ -34,4 +37,12 @@ public:
     virtual void SetAllEnergyToZero() = 0;
 
     virtual void InvertPixelOn(size_t pixelIndex) = 0;	
+
+    virtual void InvertAllPixels() = 0;
+
+    virtual void SetPixelsOn(std::span<const size_t> pixelIndices, bool value) = 0;
+
+    virtual void SetRanks(std::span<const size_t> pixelIndices, size_t firstRank) = 0;
+
+    virtual void SetStats(VCStats* stats);
 };
\ No newline at end of file
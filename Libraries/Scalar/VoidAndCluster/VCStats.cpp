@@ -0,0 +1,111 @@
+#include "VCStats.h"
+
+#include <algorithm>
+#include <bit>
+#include <fstream>
+
+#include "Kernel/SymmetricKernel.h"
+
+const char* VCPhaseToString(VCPhase phase)
+{
+    switch (phase)
+    {
+    case VCPhase::InitializeToWhiteNoise:
+        return "InitializeToWhiteNoise";
+    case VCPhase::ReorganizeToBlueNoise:
+        return "ReorganizeToBlueNoise";
+    case VCPhase::Phase1Part1:
+        return "Phase1Part1";
+    case VCPhase::Phase1Part2:
+        return "Phase1Part2";
+    case VCPhase::Phase2:
+        return "Phase2";
+    case VCPhase::Phase3Part1:
+        return "Phase3Part1";
+    case VCPhase::Phase3Part2:
+        return "Phase3Part2";
+    default:
+        return "Unknown";
+    }
+}
+
+void LatencyHistogram::Add(std::chrono::steady_clock::duration duration)
+{
+    uint64_t ns = uint64_t(std::max(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count(), std::chrono::nanoseconds::rep(0)));
+    size_t bucket = (ns == 0) ? 0 : size_t(std::bit_width(ns) - 1);
+    buckets[std::min(bucket, c_numBuckets - 1)]++;
+    count++;
+    totalNs += ns;
+    maxNs = std::max(maxNs, ns);
+}
+
+size_t NumKernelTaps(const SymmetricKernel& kernel)
+{
+    return size_t(kernel.end() - kernel.start() + 1);
+}
+
+namespace
+{
+
+double Ratio(size_t numerator, size_t denominator)
+{
+    return (denominator > 0) ? double(numerator) / double(denominator) : 0.0;
+}
+
+void WriteHistogram(const LatencyHistogram& histogram, std::ostream& stream)
+{
+    // Trailing empty buckets are left off
+    size_t numBuckets = LatencyHistogram::c_numBuckets;
+    while (numBuckets > 0 && histogram.buckets[numBuckets - 1] == 0)
+        numBuckets--;
+
+    stream << "{ \"count\": " << histogram.count
+        << ", \"totalNs\": " << histogram.totalNs
+        << ", \"meanNs\": " << Ratio(size_t(histogram.totalNs), histogram.count)
+        << ", \"maxNs\": " << histogram.maxNs
+        << ", \"log2NsBuckets\": [";
+    for (size_t bucket = 0; bucket < numBuckets; ++bucket)
+        stream << (bucket > 0 ? ", " : "") << histogram.buckets[bucket];
+    stream << "] }";
+}
+
+}
+
+void WriteVCStatsJSON(const VCStats& stats, std::ostream& stream)
+{
+    stream << "{\n    \"phases\": [\n";
+    for (size_t phaseIndex = 0; phaseIndex < (size_t)VCPhase::Count; ++phaseIndex)
+    {
+        const VCPhaseStats& phase = stats.phases[phaseIndex];
+        stream << "        {\n";
+        stream << "            \"phase\": \"" << VCPhaseToString(VCPhase(phaseIndex)) << "\",\n";
+        stream << "            \"tightestClusterQueries\": " << phase.tightestClusterQueries << ",\n";
+        stream << "            \"largestVoidQueries\": " << phase.largestVoidQueries << ",\n";
+        stream << "            \"slicesRescanned\": " << phase.slicesRescanned << ",\n";
+        stream << "            \"pixelsScanned\": " << phase.pixelsScanned << ",\n";
+        stream << "            \"dirtyMaxHitRate\": " << Ratio(phase.maxCacheHits, phase.maxCacheHits + phase.maxCacheMisses) << ",\n";
+        stream << "            \"dirtyMinHitRate\": " << Ratio(phase.minCacheHits, phase.minCacheHits + phase.minCacheMisses) << ",\n";
+        stream << "            \"splatsOn\": " << phase.splatsOn << ",\n";
+        stream << "            \"splatsOff\": " << phase.splatsOff << ",\n";
+        stream << "            \"splatTaps\": " << phase.splatTaps << ",\n";
+        stream << "            \"tightestClusterLatency\": ";
+        WriteHistogram(phase.tightestClusterLatency, stream);
+        stream << ",\n            \"largestVoidLatency\": ";
+        WriteHistogram(phase.largestVoidLatency, stream);
+        stream << ",\n            \"splatOnLatency\": ";
+        WriteHistogram(phase.splatOnLatency, stream);
+        stream << ",\n            \"splatOffLatency\": ";
+        WriteHistogram(phase.splatOffLatency, stream);
+        stream << "\n        }" << (phaseIndex + 1 < (size_t)VCPhase::Count ? "," : "") << "\n";
+    }
+    stream << "    ]\n}\n";
+}
+
+bool SaveVCStatsJSON(const VCStats& stats, const char* fileName)
+{
+    std::ofstream file(fileName);
+    if (!file)
+        return false;
+    WriteVCStatsJSON(stats, file);
+    return bool(file);
+}
\ No newline at end of file
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+class SymmetricKernel;
+
+// Per phase engine counters and query latency histograms, for telling whether an engine and sigma combination
+// is bound by scanning or by splatting. The hooks cost a clock read per query and splat, so they are compiled out
+// unless VC_STATS() is true, either here or by building with -D"VC_STATS()=true".
+#ifndef VC_STATS
+#define VC_STATS() false
+#endif
+
+enum class VCPhase
+{
+    InitializeToWhiteNoise,
+    ReorganizeToBlueNoise,
+    Phase1Part1,
+    Phase1Part2,
+    Phase2,
+    Phase3Part1,
+    Phase3Part2,
+    Count
+};
+
+const char* VCPhaseToString(VCPhase phase);
+
+// Bucket b counts the calls that took [2^b, 2^(b+1)) nanoseconds. Bucket 0 also has the 0ns ones.
+struct LatencyHistogram
+{
+    static const size_t c_numBuckets = 40;
+
+    size_t buckets[c_numBuckets] = {};
+    size_t count = 0;
+    uint64_t totalNs = 0;
+    uint64_t maxNs = 0;
+
+    void Add(std::chrono::steady_clock::duration duration);
+};
+
+struct VCPhaseStats
+{
+    size_t tightestClusterQueries = 0;
+    size_t largestVoidQueries = 0;
+
+    // Filled in by engines that support it (the reference and slice cache engines).
+    // Engines without a cache count every query as a full scan.
+    size_t slicesRescanned = 0;
+    size_t pixelsScanned = 0;
+    size_t maxCacheHits = 0;        // Clean dirtyMax slices reused by cluster queries
+    size_t maxCacheMisses = 0;
+    size_t minCacheHits = 0;        // Clean dirtyMin slices reused by void queries
+    size_t minCacheMisses = 0;
+    size_t splatTaps = 0;           // Energy values written by splats
+
+    size_t splatsOn = 0;
+    size_t splatsOff = 0;
+
+    LatencyHistogram tightestClusterLatency;
+    LatencyHistogram largestVoidLatency;
+    LatencyHistogram splatOnLatency;
+    LatencyHistogram splatOffLatency;
+};
+
+struct VCStats
+{
+    VCPhase phase = VCPhase::InitializeToWhiteNoise;
+    VCPhaseStats phases[(size_t)VCPhase::Count];
+
+    VCPhaseStats& Current() { return phases[(size_t)phase]; }
+};
+
+// Energy values one splat of the kernel along its dimension writes
+size_t NumKernelTaps(const SymmetricKernel& kernel);
+
+void WriteVCStatsJSON(const VCStats& stats, std::ostream& stream);
+
+bool SaveVCStatsJSON(const VCStats& stats, const char* fileName);
\ No newline at end of file
@@ -1,6 +1,10 @@
 #include "VoidAndCluster.h"
 
+#include <algorithm>
+#include <vector>
+
 #include "STBNRandom.h"
+#include "Trace.h"
 #include "Utils/PixelCoords.h"
 
 VoidAndClusterProgressData::VoidAndClusterProgressData() :
@@ -30,9 +34,15 @@ VoidAndCluster::VoidAndCluster(float initialBinaryPatternDensity, VCController*
     m_numPixels(CalcNumPixels(updater->GetSTBNData())),
     m_data(updater->GetSTBNData()),
     m_updater(updater),
-    m_initialBinaryPatternDensity(initialBinaryPatternDensity)
+    m_initialBinaryPatternDensity(initialBinaryPatternDensity),
+    m_maxRank(m_numPixels)
 {
+    m_updater->SetStats(&m_stats);
+}
 
+VoidAndCluster::~VoidAndCluster()
+{
+    m_updater->SetStats(nullptr);
 }
 
 size_t VoidAndCluster::GetNumPixels() const
@@ -40,8 +50,20 @@ size_t VoidAndCluster::GetNumPixels() const
     return m_numPixels;
 }
 
+void VoidAndCluster::SetMaxRank(size_t maxRank)
+{
+    m_maxRank = std::min(maxRank, m_numPixels);
+}
+
+size_t VoidAndCluster::GetMaxRank() const
+{
+    return m_maxRank;
+}
+
 void VoidAndCluster::InitializeToWhiteNoise()
 {
+    TraceSpan span("InitializeToWhiteNoise", "VoidAndCluster");
+    m_stats.phase = VCPhase::InitializeToWhiteNoise;
     // generate an initial set of on pixels, with a max density of m_initialBinaryPatternDensity
     // If we get duplicate random numbers, we won't get the full targetCount of on pixels, but that is ok.
     m_pd.startedInitializeToWhiteNoise = true;
@@ -57,19 +79,39 @@ void VoidAndCluster::InitializeToWhiteNoise()
     m_pd.initializeToWhiteNoiseEndTime = std::chrono::steady_clock::now();
 }
 
+void VoidAndCluster::InitializeFromPattern(std::span<const size_t> onPixels)
+{
+    TraceSpan span("InitializeFromPattern", "VoidAndCluster");
+    m_stats.phase = VCPhase::InitializeToWhiteNoise;
+    m_pd.startedInitializeToWhiteNoise = true;
+    m_pd.initializeToWhiteNoiseStartTime = std::chrono::steady_clock::now();
+    m_pd.initializeToWhiteNoiseTargetCount = onPixels.size();
+    for (m_pd.initializeToWhiteNoiseCurrentIndex = 0; m_pd.initializeToWhiteNoiseCurrentIndex < m_pd.initializeToWhiteNoiseTargetCount; ++m_pd.initializeToWhiteNoiseCurrentIndex)
+    {
+        size_t pixelIndex = onPixels[m_pd.initializeToWhiteNoiseCurrentIndex];
+        if (m_data.pixelOn[pixelIndex])
+            continue;
+        m_updater->SetPixelOn(pixelIndex, true);
+        SplatEnergyOn(pixelIndex);
+    }
+    m_pd.initializeToWhiteNoiseEndTime = std::chrono::steady_clock::now();
+}
+
 void VoidAndCluster::ReorganizeToBlueNoise()
 {
+    TraceSpan span("ReorganizeToBlueNoise", "VoidAndCluster");
+    m_stats.phase = VCPhase::ReorganizeToBlueNoise;
     // Make these into blue noise distributed points by removing the point at the tightest
     // cluster and placing it into the largest void. Repeat until those are the same location.
     m_pd.reorganizeToBlueNoiseStartTime = std::chrono::steady_clock::now();
     m_pd.reorganizeToBlueNoiseIterationsSoFar = 0;
     while (1)
     {
-        size_t tightestClusterIndex = m_updater->GetTightestCluster();
+        size_t tightestClusterIndex = TightestCluster();
         m_updater->SetPixelOn(tightestClusterIndex, false);
         SplatEnergyOff(tightestClusterIndex);
 
-        size_t largestVoidIndex = m_updater->GetLargestVoid();
+        size_t largestVoidIndex = LargestVoid();
         m_updater->SetPixelOn(largestVoidIndex, true);
         SplatEnergyOn(largestVoidIndex);
 
@@ -84,6 +126,8 @@ void VoidAndCluster::ReorganizeToBlueNoise()
 
 void VoidAndCluster::Phase1Part1()
 {
+    TraceSpan span("Phase1Part1", "VoidAndCluster");
+    m_stats.phase = VCPhase::Phase1Part1;
     // Make the initial pattern progressive.
     // Find the tightest cluster and remove it. The rank for that pixel
     // is the number of ones left in the pattern.
@@ -93,32 +137,47 @@ void VoidAndCluster::Phase1Part1()
     m_pd.phase1Part1OnesCountRemaining = m_updater->GetPixelOnCount();
     m_pd.phase1Part1OnesCountTotal = m_pd.phase1Part1OnesCountRemaining;
 
+    // Ranks aren't read until Phase1Part2, so they are set in one go at the end
+    std::vector<size_t> removedPixels;
+    removedPixels.reserve(m_pd.phase1Part1OnesCountTotal);
     while (m_pd.phase1Part1OnesCountRemaining > 0)
     {
-        size_t tightestClusterIndex = m_updater->GetTightestCluster();
+        size_t tightestClusterIndex = TightestCluster();
 
         m_pd.phase1Part1OnesCountRemaining--;
 
         m_updater->SetPixelOn(tightestClusterIndex, false);
-        m_updater->SetPixelRank(tightestClusterIndex, m_pd.phase1Part1OnesCountRemaining);
+        removedPixels.push_back(tightestClusterIndex);
 
         SplatEnergyOff(tightestClusterIndex);
     }
+
+    // The last pixel removed has rank 0
+    std::reverse(removedPixels.begin(), removedPixels.end());
+    m_updater->SetRanks(removedPixels, 0);
     m_pd.phase1Part1EndTime = std::chrono::steady_clock::now();
 }
 
 void VoidAndCluster::Phase1Part2()
 {
+    TraceSpan span("Phase1Part2", "VoidAndCluster");
+    m_stats.phase = VCPhase::Phase1Part2;
     // restore the "on" states
     m_pd.phase1Part2StartTime = std::chrono::steady_clock::now();
-    for (m_pd.phase1Part2PixelIndex = 0; m_pd.phase1Part2PixelIndex < m_numPixels; ++m_pd.phase1Part2PixelIndex)
+    std::vector<size_t> rankedPixels;
+    for (size_t pixelIndex = 0; pixelIndex < m_numPixels; ++pixelIndex)
     {
-        if (m_data.pixelRank[m_pd.phase1Part2PixelIndex] < m_numPixels)
-        {
-            m_updater->SetPixelOn(m_pd.phase1Part2PixelIndex, true);
-            SplatEnergyOn(m_pd.phase1Part2PixelIndex);
-        }
+        if (m_data.pixelRank[pixelIndex] < m_numPixels)
+            rankedPixels.push_back(pixelIndex);
+    }
+    m_updater->SetPixelsOn(rankedPixels, true);
+
+    for (size_t pixelIndex : rankedPixels)
+    {
+        m_pd.phase1Part2PixelIndex = pixelIndex;
+        SplatEnergyOn(pixelIndex);
     }
+    m_pd.phase1Part2PixelIndex = m_numPixels;
 
     m_pd.phase1Part2EndTime = std::chrono::steady_clock::now();
 }
@@ -131,68 +190,98 @@ void VoidAndCluster::Phase1()
 
 void VoidAndCluster::Phase2()
 {
+    TraceSpan span("Phase2", "VoidAndCluster");
+    m_stats.phase = VCPhase::Phase2;
     // Add new samples until half are ones.
     // Do this by repeatedly inserting a one into the largest void, and the
     // rank is the number of ones before you added it.
     m_pd.phase2StartTime = std::chrono::steady_clock::now();
 
+    // Stopping at m_maxRank still leaves phase2OnesCountCurrent == phase2OnesCountTotal for the progress reporter
     m_pd.phase2OnesCountCurrent = m_updater->GetPixelOnCount();
-    m_pd.phase2OnesCountTotal = m_numPixels / 2;
+    m_pd.phase2OnesCountTotal = std::max(std::min(m_numPixels / 2, m_maxRank), m_pd.phase2OnesCountCurrent);
 
+    const size_t firstRank = m_pd.phase2OnesCountCurrent;
+    std::vector<size_t> addedPixels;
+    addedPixels.reserve(m_pd.phase2OnesCountTotal - std::min(firstRank, m_pd.phase2OnesCountTotal));
     while (m_pd.phase2OnesCountCurrent < m_pd.phase2OnesCountTotal)
     {
-        size_t largestVoidIndex = m_updater->GetLargestVoid();
+        size_t largestVoidIndex = LargestVoid();
 
         m_updater->SetPixelOn(largestVoidIndex, true);
-        m_updater->SetPixelRank(largestVoidIndex, m_pd.phase2OnesCountCurrent);
+        addedPixels.push_back(largestVoidIndex);
 
         SplatEnergyOn(largestVoidIndex);
 
         m_pd.phase2OnesCountCurrent++;
     }
+    m_updater->SetRanks(addedPixels, firstRank);
 
     m_pd.phase2EndTime = std::chrono::steady_clock::now();
 }
 
 void VoidAndCluster::Phase3Part1()
 {
+    TraceSpan span("Phase3Part1", "VoidAndCluster");
+    m_stats.phase = VCPhase::Phase3Part1;
     // Reverse the meaning of zeros and ones.
 // Remove the tightest cluster and give it the rank of the number of zeros in the binary pattern before you removed it.
 // Go until there are no more ones
     m_pd.phase3Part1StartTime = std::chrono::steady_clock::now();
     m_updater->SetAllEnergyToZero();
-    for (m_pd.phase3Part1PixelCountCurrent = 0; m_pd.phase3Part1PixelCountCurrent < m_numPixels; ++m_pd.phase3Part1PixelCountCurrent)
-    {
-        m_updater->InvertPixelOn(m_pd.phase3Part1PixelCountCurrent);
-        if (m_data.pixelOn[m_pd.phase3Part1PixelCountCurrent])
-            SplatEnergyOn(m_pd.phase3Part1PixelCountCurrent);
-    }
+    m_updater->InvertAllPixels();
+    m_data.pixelOn.ForEachBit<true>(
+        [this](size_t pixelIndex)
+        {
+            m_pd.phase3Part1PixelCountCurrent = pixelIndex;
+            SplatEnergyOn(pixelIndex);
+        }
+    );
+    m_pd.phase3Part1PixelCountCurrent = m_numPixels;
     m_pd.phase3Part1EndTime = std::chrono::steady_clock::now();
 }
 
 void VoidAndCluster::Phase3Part2()
 {
+    TraceSpan span("Phase3Part2", "VoidAndCluster");
+    m_stats.phase = VCPhase::Phase3Part2;
     m_pd.phase3Part2StartTime = std::chrono::steady_clock::now();
-    m_pd.phase3Part2OnesCountTotal = m_updater->GetPixelOnCount();
+    // Only remove as many as there are ranks left below m_maxRank
+    const size_t onesCount = m_updater->GetPixelOnCount();
+    const size_t firstRank = m_numPixels - onesCount;
+    m_pd.phase3Part2OnesCountTotal = std::min(onesCount, m_maxRank - std::min(m_maxRank, firstRank));
     m_pd.phase3Part2OnesCountRemaining = m_pd.phase3Part2OnesCountTotal;
 
+    std::vector<size_t> removedPixels;
+    removedPixels.reserve(m_pd.phase3Part2OnesCountTotal);
     while (m_pd.phase3Part2OnesCountRemaining > 0)
     {
-        size_t tightestClusterIndex = m_updater->GetTightestCluster();
+        size_t tightestClusterIndex = TightestCluster();
 
         m_updater->SetPixelOn(tightestClusterIndex, false);
-        m_updater->SetPixelRank(tightestClusterIndex, m_numPixels - m_pd.phase3Part2OnesCountRemaining);
+        removedPixels.push_back(tightestClusterIndex);
 
         m_pd.phase3Part2OnesCountRemaining--;
 
         SplatEnergyOff(tightestClusterIndex);
     }
+    m_updater->SetRanks(removedPixels, firstRank);
 
     m_pd.phase3Part2EndTime = std::chrono::steady_clock::now();
 }
 
 void VoidAndCluster::Phase3()
 {
+    if (m_maxRank <= m_numPixels / 2)
+    {
+        // Nothing left to rank. Mark both parts done so the progress reporter finishes.
+        m_pd.phase3Part1StartTime = m_pd.phase3Part1EndTime = std::chrono::steady_clock::now();
+        m_pd.phase3Part2StartTime = m_pd.phase3Part2EndTime = m_pd.phase3Part1EndTime;
+        m_pd.phase3Part2OnesCountTotal = 0;
+        m_pd.phase3Part1PixelCountCurrent = m_numPixels;
+        m_pd.phase3Part2OnesCountRemaining = 0;
+        return;
+    }
     Phase3Part1();
     Phase3Part2();
 }
@@ -207,14 +296,59 @@ const VoidAndClusterProgressData& VoidAndCluster::GetProgressData() const
     return m_pd;
 }
 
+const VCStats& VoidAndCluster::GetStats() const
+{
+    return m_stats;
+}
+
+size_t VoidAndCluster::TightestCluster()
+{
+#if VC_STATS()
+    auto start = std::chrono::steady_clock::now();
+    size_t ret = m_updater->GetTightestCluster();
+    m_stats.Current().tightestClusterLatency.Add(std::chrono::steady_clock::now() - start);
+    m_stats.Current().tightestClusterQueries++;
+    return ret;
+#else
+    return m_updater->GetTightestCluster();
+#endif
+}
+
+size_t VoidAndCluster::LargestVoid()
+{
+#if VC_STATS()
+    auto start = std::chrono::steady_clock::now();
+    size_t ret = m_updater->GetLargestVoid();
+    m_stats.Current().largestVoidLatency.Add(std::chrono::steady_clock::now() - start);
+    m_stats.Current().largestVoidQueries++;
+    return ret;
+#else
+    return m_updater->GetLargestVoid();
+#endif
+}
+
 void VoidAndCluster::SplatEnergyOn(size_t pixelIndex)
 {
     const PixelCoords pixelCoords = PixelIndexToPixelCoords(pixelIndex, m_data.dimensions);
+#if VC_STATS()
+    auto start = std::chrono::steady_clock::now();
     m_updater->SplatOn(pixelCoords);
+    m_stats.Current().splatOnLatency.Add(std::chrono::steady_clock::now() - start);
+    m_stats.Current().splatsOn++;
+#else
+    m_updater->SplatOn(pixelCoords);
+#endif
 }
 
 void VoidAndCluster::SplatEnergyOff(size_t pixelIndex)
 {
     const PixelCoords pixelCoords = PixelIndexToPixelCoords(pixelIndex, m_data.dimensions);
+#if VC_STATS()
+    auto start = std::chrono::steady_clock::now();
+    m_updater->SplatOff(pixelCoords);
+    m_stats.Current().splatOffLatency.Add(std::chrono::steady_clock::now() - start);
+    m_stats.Current().splatsOff++;
+#else
     m_updater->SplatOff(pixelCoords);
+#endif
 }
\ No newline at end of file
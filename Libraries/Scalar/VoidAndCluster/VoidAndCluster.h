@@ -1,8 +1,10 @@
 #pragma once
 
 #include <chrono>
+#include <span>
 
 #include "VCController.h"
+#include "VCStats.h"
 
 struct VoidAndClusterProgressData
 {
@@ -46,11 +48,21 @@ class VoidAndCluster
 {
 public:
     VoidAndCluster(float initialBinaryPatternDensity, VCController* updater);
+    ~VoidAndCluster();
     VoidAndCluster(const VoidAndCluster&) = delete;
     VoidAndCluster& operator=(const VoidAndCluster&) = delete;
 
     size_t GetNumPixels() const;
+
+    // Only ranks below maxRank get assigned. Phase 2 and Phase 3 stop, or are skipped, once they are,
+    // and the other pixels are left with a rank of GetNumPixels(). Phase 1 always runs in full.
+    void SetMaxRank(size_t maxRank);
+    size_t GetMaxRank() const;
+
     void InitializeToWhiteNoise();
+    // Seeds the initial binary pattern with the given on pixels instead of white noise, e.g. from a coarser solve.
+    // Uses the same progress data as InitializeToWhiteNoise.
+    void InitializeFromPattern(std::span<const size_t> onPixels);
     void ReorganizeToBlueNoise();
     void Phase1();
     void Phase2();
@@ -59,15 +71,22 @@ public:
     const STBNData& GetSTBNData() const;
     const VoidAndClusterProgressData& GetProgressData() const;
 
+    // All zero unless built with VC_STATS()
+    const VCStats& GetStats() const;
+
 private:
     size_t m_numPixels;
     STBNData& m_data;
     VCController* m_updater;
 
     float m_initialBinaryPatternDensity;
+    size_t m_maxRank;
 
     VoidAndClusterProgressData m_pd;
+    VCStats m_stats;
 
+    inline size_t TightestCluster();
+    inline size_t LargestVoid();
     inline void SplatEnergyOn(size_t pixelIndex);
     inline void SplatEnergyOff(size_t pixelIndex);
 
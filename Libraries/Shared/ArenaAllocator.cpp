@@ -0,0 +1,180 @@
+#include "ArenaAllocator.h"
+
+#include <cstdlib>
+#include <map>
+#include <mutex>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <Windows.h>
+#elif defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace
+{
+    enum class PageKind
+    {
+        Regular,
+        TransparentHuge,
+        ExplicitHuge
+    };
+
+    struct LargeAllocation
+    {
+        size_t mappedBytes;
+        PageKind pageKind;
+    };
+
+    std::mutex s_mutex;
+    std::map<void*, LargeAllocation> s_largeAllocations;
+    HugePageArenaStats s_stats;
+
+    size_t RoundUp(size_t value, size_t multiple)
+    {
+        return ((value + multiple - 1) / multiple) * multiple;
+    }
+
+    void* MapLarge(size_t bytes, LargeAllocation& allocation)
+    {
+#if defined(_WIN32)
+        // Large pages need the "Lock pages in memory" privilege, so this usually falls back
+        size_t largePageSize = GetLargePageMinimum();
+        if (largePageSize > 0)
+        {
+            allocation.mappedBytes = RoundUp(bytes, largePageSize);
+            void* ret = VirtualAlloc(nullptr, allocation.mappedBytes, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+            if (ret)
+            {
+                allocation.pageKind = PageKind::ExplicitHuge;
+                return ret;
+            }
+        }
+        allocation.mappedBytes = bytes;
+        allocation.pageKind = PageKind::Regular;
+        return VirtualAlloc(nullptr, bytes, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+#elif defined(__linux__)
+        allocation.mappedBytes = RoundUp(bytes, HugePageArena::c_hugePageSize);
+
+        // Reserved huge pages. Fails straight away if none are configured.
+        void* ret = mmap(nullptr, allocation.mappedBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (ret != MAP_FAILED)
+        {
+            allocation.pageKind = PageKind::ExplicitHuge;
+            return ret;
+        }
+
+        // Regular pages, aligned to a huge page so transparent huge pages can back all of it
+        size_t overallocatedBytes = allocation.mappedBytes + HugePageArena::c_hugePageSize;
+        char* mapped = static_cast<char*>(mmap(nullptr, overallocatedBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+        if (mapped == MAP_FAILED)
+            return nullptr;
+
+        char* aligned = reinterpret_cast<char*>(RoundUp(reinterpret_cast<size_t>(mapped), HugePageArena::c_hugePageSize));
+        size_t headBytes = aligned - mapped;
+        size_t tailBytes = overallocatedBytes - headBytes - allocation.mappedBytes;
+        if (headBytes > 0)
+            munmap(mapped, headBytes);
+        if (tailBytes > 0)
+            munmap(aligned + allocation.mappedBytes, tailBytes);
+
+        allocation.pageKind = (madvise(aligned, allocation.mappedBytes, MADV_HUGEPAGE) == 0) ? PageKind::TransparentHuge : PageKind::Regular;
+        return aligned;
+#else
+        allocation.mappedBytes = RoundUp(bytes, HugePageArena::c_alignment);
+        allocation.pageKind = PageKind::Regular;
+        return std::aligned_alloc(HugePageArena::c_alignment, allocation.mappedBytes);
+#endif
+    }
+
+    void UnmapLarge(void* p, const LargeAllocation& allocation)
+    {
+#if defined(_WIN32)
+        VirtualFree(p, 0, MEM_RELEASE);
+#elif defined(__linux__)
+        munmap(p, allocation.mappedBytes);
+#else
+        std::free(p);
+#endif
+    }
+}
+
+namespace HugePageArena
+{
+
+void* Allocate(size_t bytes)
+{
+    if (bytes == 0)
+        bytes = 1;
+
+    if (bytes < c_hugePageSize)
+    {
+#if defined(_WIN32)
+        return _aligned_malloc(bytes, c_alignment);
+#else
+        return std::aligned_alloc(c_alignment, RoundUp(bytes, c_alignment));
+#endif
+    }
+
+    LargeAllocation allocation;
+    void* ret = MapLarge(bytes, allocation);
+    if (!ret)
+        return nullptr;
+
+    std::lock_guard<std::mutex> lock(s_mutex);
+    s_largeAllocations[ret] = allocation;
+    s_stats.largeAllocations++;
+    s_stats.largeAllocationBytes += bytes;
+    if (allocation.pageKind == PageKind::ExplicitHuge)
+        s_stats.explicitHugePageAllocations++;
+    else if (allocation.pageKind == PageKind::TransparentHuge)
+        s_stats.transparentHugePageAllocations++;
+    return ret;
+}
+
+void Free(void* p, size_t bytes)
+{
+    if (!p)
+        return;
+
+    if (bytes == 0)
+        bytes = 1;
+
+    if (bytes < c_hugePageSize)
+    {
+#if defined(_WIN32)
+        _aligned_free(p);
+#else
+        std::free(p);
+#endif
+        return;
+    }
+
+    LargeAllocation allocation;
+    {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        auto it = s_largeAllocations.find(p);
+        if (it == s_largeAllocations.end())
+            return;
+        allocation = it->second;
+        s_largeAllocations.erase(it);
+    }
+    UnmapLarge(p, allocation);
+}
+
+HugePageArenaStats GetStats()
+{
+    std::lock_guard<std::mutex> lock(s_mutex);
+    return s_stats;
+}
+
+std::string GetStatsString()
+{
+    HugePageArenaStats stats = GetStats();
+    char buffer[256];
+    sprintf_s(buffer, "Huge pages: %zu of %zu large allocations (%.1f MB) got reserved huge pages, %zu were advised to use transparent huge pages",
+        stats.explicitHugePageAllocations, stats.largeAllocations, float(stats.largeAllocationBytes) / (1024.0f * 1024.0f), stats.transparentHugePageAllocations);
+    return buffer;
+}
+
+}
\ No newline at end of file
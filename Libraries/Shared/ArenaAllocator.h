@@ -0,0 +1,88 @@
+#pragma once
+
+#include <algorithm>
+#include <new>
+#include <string>
+#include <vector>
+
+// Storage for the big per pixel arrays.
+// Allocations of at least c_hugePageSize get their own mapping, backed by 2MB huge pages when the OS hands them out
+// (MAP_HUGETLB or MEM_LARGE_PAGES), else advised for transparent huge pages, else regular pages.
+// Smaller allocations come from the regular heap. Everything is c_alignment aligned.
+struct HugePageArenaStats
+{
+    size_t largeAllocations = 0;
+    size_t largeAllocationBytes = 0;
+    size_t explicitHugePageAllocations = 0;     // Backed by reserved huge pages
+    size_t transparentHugePageAllocations = 0;  // Advised to use transparent huge pages, which the kernel may or may not do
+};
+
+namespace HugePageArena
+{
+    static const size_t c_hugePageSize = 2 * 1024 * 1024;
+    static const size_t c_alignment = 64;
+
+    void* Allocate(size_t bytes);
+
+    void Free(void* p, size_t bytes);
+
+    // Totals since the start of the run
+    HugePageArenaStats GetStats();
+
+    // One line summary for reporting
+    std::string GetStatsString();
+}
+
+template<typename T>
+struct ArenaAllocator
+{
+    using value_type = T;
+
+    ArenaAllocator() = default;
+
+    template<typename U>
+    ArenaAllocator(const ArenaAllocator<U>&)
+    {
+    }
+
+    T* allocate(size_t count)
+    {
+        void* ret = HugePageArena::Allocate(count * sizeof(T));
+        if (!ret)
+            throw std::bad_alloc();
+        return static_cast<T*>(ret);
+    }
+
+    void deallocate(T* p, size_t count)
+    {
+        HugePageArena::Free(p, count * sizeof(T));
+    }
+};
+
+template<typename T, typename U>
+bool operator==(const ArenaAllocator<T>&, const ArenaAllocator<U>&)
+{
+    return true;
+}
+
+template<typename T, typename U>
+bool operator!=(const ArenaAllocator<T>&, const ArenaAllocator<U>&)
+{
+    return false;
+}
+
+template<typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+// Comparisons against regular vectors, mostly for tests
+template<typename T>
+bool operator==(const ArenaVector<T>& a, const std::vector<T>& b)
+{
+    return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin());
+}
+
+template<typename T>
+bool operator==(const std::vector<T>& a, const ArenaVector<T>& b)
+{
+    return b == a;
+}
\ No newline at end of file
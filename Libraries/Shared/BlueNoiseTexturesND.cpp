@@ -1,5 +1,7 @@
 #include "BlueNoiseTexturesND.h"
 
+#include <algorithm>
+
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
 
@@ -19,21 +21,7 @@ void BlueNoiseTexturesND::Init(const std::vector<int>& _dims, const std::vector<
     pixels.resize(pixelCount);
 
     // make the masks
-    if (groups.size() == 0)
-        groups.resize(dims.size(), 0);
-    std::unordered_set<int> uniqueGroupNumbers;
-    for (int g : groups)
-        uniqueGroupNumbers.insert(g);
-    for (int group : uniqueGroupNumbers)
-    {
-        unsigned int mask = 0;
-        for (size_t index = 0; index < dims.size(); ++index)
-        {
-            if (groups[index] != group)
-                mask |= (1 << index);
-        }
-        masks.push_back(mask);
-    }
+    masks = MakeGroupMasks(groups, dims.size());
 
     // calculate energy radii so we don't have to consider all pixels for energy changes
     energyEmitMin.resize(dims.size());
@@ -58,6 +46,33 @@ void BlueNoiseTexturesND::Init(const std::vector<int>& _dims, const std::vector<
     }
 }
 
+std::vector<unsigned int> BlueNoiseTexturesND::MakeGroupMasks(std::vector<int> groups, size_t numDims)
+{
+    if (groups.size() == 0)
+        groups.resize(numDims, 0);
+
+    // One mask per unique group, ordered by the first dimension in the group
+    std::vector<int> uniqueGroupNumbers;
+    for (int g : groups)
+    {
+        if (std::find(uniqueGroupNumbers.begin(), uniqueGroupNumbers.end(), g) == uniqueGroupNumbers.end())
+            uniqueGroupNumbers.push_back(g);
+    }
+
+    std::vector<unsigned int> ret;
+    for (int group : uniqueGroupNumbers)
+    {
+        unsigned int mask = 0;
+        for (size_t index = 0; index < numDims; ++index)
+        {
+            if (groups[index] != group)
+                mask |= (1 << index);
+        }
+        ret.push_back(mask);
+    }
+    return ret;
+}
+
 std::vector<int> BlueNoiseTexturesND::GetDims() const
 {
     return dims;
@@ -73,6 +88,11 @@ const std::vector<Pixel>& BlueNoiseTexturesND::GetPixels() const
     return pixels;
 }
 
+const std::vector<unsigned int>& BlueNoiseTexturesND::GetMasks() const
+{
+    return masks;
+}
+
 // pattern of calculating pixel index
 // x
 // y * width + x
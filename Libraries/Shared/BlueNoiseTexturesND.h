@@ -1,6 +1,5 @@
 #pragma once
 
-#include <unordered_set>
 #include <vector>
 
 #include "STBNMath.h"
@@ -43,9 +42,13 @@ public:
 
     void Init(const std::vector<int>& _dims, const std::vector<float>& _sigmas, std::vector<int> groups);
 
+    // Builds one mask per group, in the order the groups first appear in the dimensions.
+    static std::vector<unsigned int> MakeGroupMasks(std::vector<int> groups, size_t numDims);
+
     std::vector<int> GetDims() const;
     std::vector<Pixel>& GetPixels();
     const std::vector<Pixel>& GetPixels() const;
+    const std::vector<unsigned int>& GetMasks() const;
 
     size_t GetPixelIndex(const std::vector<int>& indices) const;
 
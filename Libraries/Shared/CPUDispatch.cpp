@@ -0,0 +1,103 @@
+#include "CPUDispatch.h"
+
+#include <cstdlib>
+#include <cstring>
+
+#if STBN_X86()
+#if defined(_MSC_VER)
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+#endif
+
+namespace
+{
+
+#if STBN_X86()
+bool CPUSupports(CPUISA isa)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7)
+        return false;
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx)
+        return false;
+    // The OS has to save the upper register halves (and the AVX-512 mask and upper registers) on context switches
+    unsigned long long xcr0 = _xgetbv(0);
+    __cpuidex(info, 7, 0);
+    if (isa == CPUISA::AVX2)
+        return ((xcr0 & 0x6) == 0x6) && (info[1] & (1 << 5)) != 0;
+    if (isa == CPUISA::AVX512)
+        return ((xcr0 & 0xe6) == 0xe6) && (info[1] & (1 << 16)) != 0;
+    return isa == CPUISA::Scalar;
+#else
+    // These check OS support too
+    __builtin_cpu_init();
+    if (isa == CPUISA::AVX2)
+        return __builtin_cpu_supports("avx2");
+    if (isa == CPUISA::AVX512)
+        return __builtin_cpu_supports("avx512f");
+    return isa == CPUISA::Scalar;
+#endif
+}
+#endif
+
+CPUISA ISACapFromEnvironment()
+{
+    const char* value = std::getenv("STBN_ISA");
+    if (!value)
+        return CPUISA::AVX512;
+    if (strcmp(value, "scalar") == 0)
+        return CPUISA::Scalar;
+    if (strcmp(value, "avx2") == 0)
+        return CPUISA::AVX2;
+    return CPUISA::AVX512;
+}
+
+CPUISA SelectISA()
+{
+    CPUISA cap = ISACapFromEnvironment();
+    for (int index = int(cap); index > 0; --index)
+    {
+        if (IsISASupported(CPUISA(index)))
+            return CPUISA(index);
+    }
+    return CPUISA::Scalar;
+}
+
+}
+
+bool IsISASupported(CPUISA isa)
+{
+    if (isa == CPUISA::Scalar)
+        return true;
+#if STBN_X86()
+    static const bool supported[] = { true, CPUSupports(CPUISA::AVX2), CPUSupports(CPUISA::AVX512) };
+    return (isa < CPUISA::Count) && supported[int(isa)];
+#else
+    return false;
+#endif
+}
+
+CPUISA GetSelectedISA()
+{
+    static const CPUISA isa = SelectISA();
+    return isa;
+}
+
+const char* ISAToString(CPUISA isa)
+{
+    switch (isa)
+    {
+    case CPUISA::AVX2:
+        return "AVX2";
+    case CPUISA::AVX512:
+        return "AVX-512";
+    default:
+        return "Scalar";
+    }
+}
\ No newline at end of file
@@ -0,0 +1,74 @@
+#pragma once
+
+// Runtime selection between ISA specific versions of hot kernels, so one binary built without -march flags
+// still runs the widest vector code each machine has.
+
+// Narrowest first
+enum class CPUISA
+{
+    Scalar,
+    AVX2,
+    AVX512,
+    Count
+};
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define STBN_X86() true
+#else
+#define STBN_X86() false
+#endif
+
+// Lets a function use an ISA's intrinsics without compiling the whole project for it.
+// MSVC allows any intrinsic anywhere, GCC and clang need the function marked.
+#if defined(_MSC_VER) && !defined(__clang__)
+#define STBN_TARGET_AVX2
+#define STBN_TARGET_AVX512
+#else
+#define STBN_TARGET_AVX2 __attribute__((target("avx2")))
+#define STBN_TARGET_AVX512 __attribute__((target("avx512f")))
+#endif
+
+// Whether this build has code for the ISA, and the CPU and OS can run it
+bool IsISASupported(CPUISA isa);
+
+// The widest supported ISA, capped by the STBN_ISA environment variable (scalar, avx2 or avx512) if it's set.
+// Decided once, on the first call.
+CPUISA GetSelectedISA();
+
+const char* ISAToString(CPUISA isa);
+
+// ifunc style table of one kernel's versions. Versions that weren't built are nullptr.
+template<typename FUNC>
+class ISADispatch
+{
+public:
+    ISADispatch(FUNC scalar, FUNC avx2, FUNC avx512) :
+        m_funcs{ scalar, avx2, avx512 }
+    {
+
+    }
+
+    // The widest version at or below isa that exists and is supported
+    CPUISA Resolve(CPUISA isa) const
+    {
+        for (int index = int(isa); index > 0; --index)
+        {
+            if (m_funcs[index] && IsISASupported(CPUISA(index)))
+                return CPUISA(index);
+        }
+        return CPUISA::Scalar;
+    }
+
+    FUNC Get(CPUISA isa) const
+    {
+        return m_funcs[int(Resolve(isa))];
+    }
+
+    FUNC Get() const
+    {
+        return Get(GetSelectedISA());
+    }
+
+private:
+    FUNC m_funcs[int(CPUISA::Count)];
+};
\ No newline at end of file
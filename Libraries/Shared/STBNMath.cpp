@@ -0,0 +1,70 @@
+#include "STBNMath.h"
+
+#include <algorithm>
+#include <cstdint>
+
+#include "STBNMathAVX2.h"
+
+namespace
+{
+
+void FastExpBatchScalar(const float* x, float* out, size_t count)
+{
+    c_fastExpLUT.LookupBatch(x, out, count);
+}
+
+#if STBN_X86()
+
+STBN_TARGET_AVX2
+void FastExpBatchAVX2(const float* x, float* out, size_t count)
+{
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+        _mm256_storeu_ps(out + i, FastExpAVX2(_mm256_loadu_ps(x + i)));
+    c_fastExpLUT.LookupBatch(x + i, out + i, count - i);
+}
+
+STBN_TARGET_AVX512
+void FastExpBatchAVX512(const float* x, float* out, size_t count)
+{
+    const float* table = c_fastExpLUT.m_LUT.data();
+    const __m512 minimum = _mm512_set1_ps(FastExpLUT::c_minimum);
+    const __m512 maximum = _mm512_set1_ps(FastExpLUT::c_maximum);
+    const __m512 bucketWidth = _mm512_set1_ps(FastExpLUT::c_bucketWidth);
+    const __m512i lastBucket = _mm512_set1_epi32(int(c_fastExpLUT.m_LUT.size()) - 2);
+    const __m512 one = _mm512_set1_ps(1.0f);
+
+    // The tail goes through masked loads and stores instead of a scalar loop
+    for (size_t i = 0; i < count; i += 16)
+    {
+        size_t numLanes = std::min(count - i, size_t(16));
+        __mmask16 lanes = __mmask16((uint32_t(1) << numLanes) - 1);
+        __m512 value = _mm512_min_ps(_mm512_max_ps(_mm512_maskz_loadu_ps(lanes, x + i), minimum), maximum);
+        __m512 position = _mm512_div_ps(_mm512_sub_ps(value, minimum), bucketWidth);
+        __m512i bucketIndex = _mm512_min_epi32(_mm512_cvttps_epi32(position), lastBucket);
+        __m512 t = _mm512_sub_ps(position, _mm512_cvtepi32_ps(bucketIndex));
+        __m512 a = _mm512_i32gather_ps(bucketIndex, table, 4);
+        __m512 b = _mm512_i32gather_ps(bucketIndex, table + 1, 4);
+        _mm512_mask_storeu_ps(out + i, lanes, _mm512_add_ps(_mm512_mul_ps(a, _mm512_sub_ps(one, t)), _mm512_mul_ps(b, t)));
+    }
+}
+
+#endif
+
+}
+
+FastExpBatchFunc GetFastExpBatch(CPUISA isa)
+{
+#if STBN_X86()
+    static const ISADispatch<FastExpBatchFunc> dispatch(&FastExpBatchScalar, &FastExpBatchAVX2, &FastExpBatchAVX512);
+#else
+    static const ISADispatch<FastExpBatchFunc> dispatch(&FastExpBatchScalar, nullptr, nullptr);
+#endif
+    return dispatch.Get(isa);
+}
+
+void FastExpBatch(const float* x, float* out, size_t count)
+{
+    static const FastExpBatchFunc func = GetFastExpBatch(GetSelectedISA());
+    func(x, out, count);
+}
\ No newline at end of file
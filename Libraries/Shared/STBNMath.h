@@ -1,7 +1,14 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 
+#include "CPUDispatch.h"
+
 static const float C_PI = 3.14159265359f;
 static const float C_TWOPI = 2.0f*3.14159265359f;
 
@@ -22,16 +29,63 @@ T Lerp(const T& A, const T& B, float t)
     return A * (1.0f - t) + B * t;
 }
 
+// Cube root of x >= 0, to a relative error of about 1e-6. An exponent bit trick gets within a few percent,
+// then two Newton steps refine it. Several times faster than cbrtf() or powf(x, 1/3).
+inline float FastCbrt(float x)
+{
+    if (x <= 0.0f)
+        return 0.0f;
+    float y = std::bit_cast<float>(std::bit_cast<uint32_t>(x) / 3 + 709921077u);
+    y -= (y - x / (y * y)) * (1.0f / 3.0f);
+    y -= (y - x / (y * y)) * (1.0f / 3.0f);
+    return y;
+}
+
+// exp() that can run at compile time, for building tables. Halves x into [-0.5, 0.5], sums the Taylor series
+// there and squares the result back up, which keeps it within a few ulps of exp() over the table ranges used here.
+constexpr double ConstexprExp(double x)
+{
+    int halvings = 0;
+    while (x < -0.5 || x > 0.5)
+    {
+        x *= 0.5;
+        ++halvings;
+    }
+
+    double term = 1.0;
+    double sum = 1.0;
+    for (int i = 1; i < 20; ++i)
+    {
+        term *= x / double(i);
+        sum += term;
+    }
+
+    for (int i = 0; i < halvings; ++i)
+        sum *= sum;
+    return sum;
+}
+
+constexpr float ConstexprExpf(float x)
+{
+    return float(ConstexprExp(double(x)));
+}
+
+// fn sampled at c_bucketCount evenly spaced points over [c_minimumValue, c_maximumValue] and linearly interpolated
+// between them. Inputs outside the range are clamped to it. Given a constexpr fn the table is built at compile
+// time, so lookups don't go through a function local static's guard.
+// For bucket width h, the interpolation error is at most h^2 / 8 * max |fn''|.
 template <float c_minimumValue, float c_maximumValue, int c_bucketCount, typename TRET>
 struct FunctionLUT1Param
 {
-    using Fn = TRET(*)(float x);
+    static constexpr float c_minimum = c_minimumValue;
+    static constexpr float c_maximum = c_maximumValue;
+    static constexpr float c_bucketWidth = (c_maximumValue - c_minimumValue) / float(c_bucketCount - 1);
 
-    FunctionLUT1Param(Fn fn)
+    template <typename Fn>
+    constexpr FunctionLUT1Param(Fn fn) :
+        m_LUT()
     {
-        m_LUT.resize(c_bucketCount);
-
-        for (size_t i = 0; i < c_bucketCount; ++i)
+        for (int i = 0; i < c_bucketCount; ++i)
         {
             float percent = float(i) / float(c_bucketCount - 1);
             float x = percent * (c_maximumValue - c_minimumValue) + c_minimumValue;
@@ -39,25 +93,34 @@ struct FunctionLUT1Param
         }
     }
 
-    TRET Lookup(float x)
+    TRET Lookup(float x) const
     {
-        float percent = (x - c_minimumValue) / (c_maximumValue - c_minimumValue);
-        int bucketIndex = int(percent * float(c_bucketCount - 1));
-        return m_LUT[(size_t)bucketIndex];
+        float position = (Clamp(x, c_minimumValue, c_maximumValue) - c_minimumValue) / c_bucketWidth;
+        int bucketIndex = std::min(int(position), c_bucketCount - 2);
+        return Lerp(m_LUT[bucketIndex], m_LUT[bucketIndex + 1], position - float(bucketIndex));
     }
 
-    std::vector<TRET> m_LUT;
+    // Lookup() over an array. See FastExpBatch() for SIMD versions of the FastExp table.
+    void LookupBatch(const float* x, TRET* out, size_t count) const
+    {
+        for (size_t i = 0; i < count; ++i)
+            out[i] = Lookup(x[i]);
+    }
+
+    std::array<TRET, c_bucketCount> m_LUT;
 };
 
+// Bilinear version of FunctionLUT1Param. The error bound is the 1D one for each axis, added together.
 template <float c_minimumValueX, float c_maximumValueX, float c_minimumValueY, float c_maximumValueY, int c_bucketCountX, int c_bucketCountY, typename TRET>
 struct FunctionLUT2Param
 {
-    using Fn = TRET(*)(float x, float y);
+    static constexpr float c_bucketWidthX = (c_maximumValueX - c_minimumValueX) / float(c_bucketCountX - 1);
+    static constexpr float c_bucketWidthY = (c_maximumValueY - c_minimumValueY) / float(c_bucketCountY - 1);
 
-    FunctionLUT2Param(Fn fn)
+    template <typename Fn>
+    constexpr FunctionLUT2Param(Fn fn) :
+        m_LUT()
     {
-        m_LUT.resize(c_bucketCountX * c_bucketCountY);
-
         for (int iy = 0; iy < c_bucketCountY; ++iy)
         {
             float percentY = float(iy) / float(c_bucketCountY - 1);
@@ -73,22 +136,44 @@ struct FunctionLUT2Param
         }
     }
 
-    inline TRET Lookup(float x, float y)
+    TRET Lookup(float x, float y) const
     {
-        float percentX = (x - c_minimumValueX) / (c_maximumValueX - c_minimumValueX);
-        int ix = int(percentX * float(c_bucketCountX - 1));
+        float positionX = (Clamp(x, c_minimumValueX, c_maximumValueX) - c_minimumValueX) / c_bucketWidthX;
+        int ix = std::min(int(positionX), c_bucketCountX - 2);
+        float tx = positionX - float(ix);
+
+        float positionY = (Clamp(y, c_minimumValueY, c_maximumValueY) - c_minimumValueY) / c_bucketWidthY;
+        int iy = std::min(int(positionY), c_bucketCountY - 2);
+        float ty = positionY - float(iy);
 
-        float percentY = (y - c_minimumValueY) / (c_maximumValueY - c_minimumValueY);
-        int iy = int(percentY * float(c_bucketCountY - 1));
+        const TRET* row = &m_LUT[iy * c_bucketCountX + ix];
+        return Lerp(Lerp(row[0], row[1], tx), Lerp(row[c_bucketCountX], row[c_bucketCountX + 1], tx), ty);
+    }
 
-        return m_LUT[iy * c_bucketCountX + ix];
+    void LookupBatch(const float* x, const float* y, TRET* out, size_t count) const
+    {
+        for (size_t i = 0; i < count; ++i)
+            out[i] = Lookup(x[i], y[i]);
     }
 
-    std::vector<TRET> m_LUT;
+    std::array<TRET, c_bucketCountX * c_bucketCountY> m_LUT;
 };
 
-static float FastExp(float x)
+// exp(x) for x <= 0, as used for the value distance weights. Below the table range exp() is under 1.2e-7 and
+// the value at -16 is returned. The interpolation error is at most c_fastExpMaxError, since exp'' <= 1 here.
+using FastExpLUT = FunctionLUT1Param<-16.0f, 0.0f, 1024, float>;
+inline constexpr FastExpLUT c_fastExpLUT(ConstexprExpf);
+inline constexpr float c_fastExpMaxError = FastExpLUT::c_bucketWidth * FastExpLUT::c_bucketWidth / 8.0f + 1.2e-7f;
+
+inline float FastExp(float x)
 {
-    static FunctionLUT1Param<-5.0f, 0.0f, 100, float> lut([](float x) {return (float)exp(x); });
-    return lut.Lookup(x);
-}
\ No newline at end of file
+    return c_fastExpLUT.Lookup(x);
+}
+
+// FastExp() over an array, using the widest SIMD gather GetSelectedISA() allows. Gives the same results as FastExp().
+void FastExpBatch(const float* x, float* out, size_t count);
+
+using FastExpBatchFunc = void (*)(const float* x, float* out, size_t count);
+
+// The widest version at or below isa that this build and CPU can run
+FastExpBatchFunc GetFastExpBatch(CPUISA isa);
\ No newline at end of file
@@ -0,0 +1,65 @@
+#pragma once
+
+// AVX2 versions of the STBNMath.h approximations, for calling from STBN_TARGET_AVX2 functions.
+// Each does the same float operations as the scalar version, so they agree lane for lane.
+
+#include "STBNMath.h"
+
+#if STBN_X86()
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <immintrin.h>
+#endif
+
+STBN_TARGET_AVX2
+inline __m256 AbsAVX2(__m256 x)
+{
+    return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), x);
+}
+
+STBN_TARGET_AVX2
+inline __m256 FastCbrtAVX2(__m256 x)
+{
+    // The bit trick's unsigned divide by 3, as a multiply by 0xAAAAAAAB and a shift, for the even and odd lanes
+    const __m256i magic = _mm256_set1_epi32(int(0xAAAAAAABu));
+    __m256i bits = _mm256_castps_si256(x);
+    __m256i even = _mm256_srli_epi64(_mm256_mul_epu32(bits, magic), 33);
+    __m256i odd = _mm256_srli_epi64(_mm256_mul_epu32(_mm256_srli_epi64(bits, 32), magic), 33);
+    __m256i third = _mm256_blend_epi32(even, _mm256_slli_epi64(odd, 32), 0xAA);
+
+    const __m256 oneThird = _mm256_set1_ps(1.0f / 3.0f);
+    __m256 y = _mm256_castsi256_ps(_mm256_add_epi32(third, _mm256_set1_epi32(709921077)));
+    y = _mm256_sub_ps(y, _mm256_mul_ps(_mm256_sub_ps(y, _mm256_div_ps(x, _mm256_mul_ps(y, y))), oneThird));
+    y = _mm256_sub_ps(y, _mm256_mul_ps(_mm256_sub_ps(y, _mm256_div_ps(x, _mm256_mul_ps(y, y))), oneThird));
+    return _mm256_and_ps(y, _mm256_cmp_ps(x, _mm256_setzero_ps(), _CMP_GT_OQ));
+}
+
+STBN_TARGET_AVX2
+inline __m256 FastExpAVX2(__m256 x)
+{
+    const __m256 minimum = _mm256_set1_ps(FastExpLUT::c_minimum);
+    const __m256 maximum = _mm256_set1_ps(FastExpLUT::c_maximum);
+    const __m256i lastBucket = _mm256_set1_epi32(int(c_fastExpLUT.m_LUT.size()) - 2);
+    const float* table = c_fastExpLUT.m_LUT.data();
+
+    __m256 value = _mm256_min_ps(_mm256_max_ps(x, minimum), maximum);
+    __m256 position = _mm256_div_ps(_mm256_sub_ps(value, minimum), _mm256_set1_ps(FastExpLUT::c_bucketWidth));
+    __m256i bucketIndex = _mm256_min_epi32(_mm256_cvttps_epi32(position), lastBucket);
+    __m256 t = _mm256_sub_ps(position, _mm256_cvtepi32_ps(bucketIndex));
+    __m256 a = _mm256_i32gather_ps(table, bucketIndex, 4);
+    __m256 b = _mm256_i32gather_ps(table + 1, bucketIndex, 4);
+    return _mm256_add_ps(_mm256_mul_ps(a, _mm256_sub_ps(_mm256_set1_ps(1.0f), t)), _mm256_mul_ps(b, t));
+}
+
+STBN_TARGET_AVX2
+inline float HorizontalSumAVX2(__m256 x)
+{
+    __m128 sum = _mm_add_ps(_mm256_castps256_ps128(x), _mm256_extractf128_ps(x, 1));
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    sum = _mm_add_ss(sum, _mm_movehdup_ps(sum));
+    return _mm_cvtss_f32(sum);
+}
+
+#endif
\ No newline at end of file
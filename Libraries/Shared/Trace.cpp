@@ -0,0 +1,226 @@
+#include "Trace.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+struct TraceEvent
+{
+    char phase;             // B, E, C or M, as in the trace event format
+    const char* name;
+    const char* category;
+    double timestampUs;
+    uint32_t threadId;
+    double value;
+};
+
+const std::chrono::milliseconds c_flushInterval(100);
+
+std::atomic<bool> g_open(false);
+
+// Guards everything below. Only held briefly to append an event or swap out the buffer.
+std::mutex g_mutex;
+std::condition_variable g_flushWake;
+std::vector<TraceEvent> g_events;
+bool g_stopFlushing = false;
+std::thread g_flushThread;
+FILE* g_file = nullptr;
+bool g_firstEventWritten = false;
+std::chrono::steady_clock::time_point g_start;
+
+std::mutex g_internMutex;
+std::deque<std::string> g_interned;
+
+std::atomic<uint32_t> g_nextThreadId(1);
+
+uint32_t GetThreadId()
+{
+    thread_local uint32_t threadId = g_nextThreadId++;
+    return threadId;
+}
+
+void Record(char phase, const char* name, const char* category, double value)
+{
+    if (!g_open.load(std::memory_order_relaxed))
+        return;
+
+    TraceEvent event = { phase, name, category, 0.0, GetThreadId(), value };
+    std::lock_guard<std::mutex> lock(g_mutex);
+    if (!g_file)
+        return;
+    event.timestampUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - g_start).count();
+    g_events.push_back(event);
+}
+
+void WriteEscaped(std::string& out, const char* string)
+{
+    for (const char* c = string; *c; ++c)
+    {
+        if (*c == '"' || *c == '\\')
+            out += '\\';
+        if ((unsigned char)(*c) >= 0x20)
+            out += *c;
+    }
+}
+
+void WriteEvent(std::string& out, const TraceEvent& event)
+{
+    char number[64];
+    out += "{\"ph\":\"";
+    out += event.phase;
+    out += "\",\"pid\":1,\"tid\":";
+    out += std::to_string(event.threadId);
+
+    if (event.phase == 'M')
+    {
+        out += ",\"name\":\"thread_name\",\"args\":{\"name\":\"";
+        WriteEscaped(out, event.name);
+        out += "\"}}";
+        return;
+    }
+
+    snprintf(number, sizeof(number), "%.3f", event.timestampUs);
+    out += ",\"ts\":";
+    out += number;
+    out += ",\"name\":\"";
+    WriteEscaped(out, event.name);
+    out += "\"";
+    if (event.category)
+    {
+        out += ",\"cat\":\"";
+        WriteEscaped(out, event.category);
+        out += "\"";
+    }
+    if (event.phase == 'C')
+    {
+        snprintf(number, sizeof(number), "%.9g", event.value);
+        out += ",\"args\":{\"value\":";
+        out += number;
+        out += "}";
+    }
+    out += "}";
+}
+
+// Writes out the events. Only the flush thread, or Close once that has stopped, calls this.
+void WriteEvents(const std::vector<TraceEvent>& events)
+{
+    std::string out;
+    for (const TraceEvent& event : events)
+    {
+        out += g_firstEventWritten ? ",\n" : "\n";
+        g_firstEventWritten = true;
+        WriteEvent(out, event);
+    }
+    fwrite(out.data(), 1, out.size(), g_file);
+}
+
+void FlushThread()
+{
+    std::vector<TraceEvent> events;
+    std::unique_lock<std::mutex> lock(g_mutex);
+    while (!g_stopFlushing)
+    {
+        g_flushWake.wait_for(lock, c_flushInterval);
+        events.swap(g_events);
+        lock.unlock();
+        WriteEvents(events);
+        events.clear();
+        lock.lock();
+    }
+}
+
+}
+
+namespace Trace
+{
+    bool Open(const char* fileName)
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        if (g_file)
+            return false;
+        g_file = fopen(fileName, "wb");
+        if (!g_file)
+            return false;
+
+        fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", g_file);
+        g_firstEventWritten = false;
+        g_stopFlushing = false;
+        g_start = std::chrono::steady_clock::now();
+        g_flushThread = std::thread(FlushThread);
+        g_open = true;
+        return true;
+    }
+
+    void Close()
+    {
+        {
+            std::lock_guard<std::mutex> lock(g_mutex);
+            if (!g_file)
+                return;
+            g_open = false;
+            g_stopFlushing = true;
+        }
+        g_flushWake.notify_one();
+        g_flushThread.join();
+
+        // Anything recorded after the flush thread's last pass
+        std::lock_guard<std::mutex> lock(g_mutex);
+        WriteEvents(g_events);
+        g_events.clear();
+        fputs("\n]}\n", g_file);
+        fclose(g_file);
+        g_file = nullptr;
+    }
+
+    bool IsOpen()
+    {
+        return g_open.load(std::memory_order_relaxed);
+    }
+
+    void Begin(const char* name, const char* category)
+    {
+        Record('B', name, category, 0.0);
+    }
+
+    void End(const char* name, const char* category)
+    {
+        Record('E', name, category, 0.0);
+    }
+
+    void Counter(const char* name, double value)
+    {
+        Record('C', name, nullptr, value);
+    }
+
+    void SetThreadName(const char* name)
+    {
+        Record('M', name, nullptr, 0.0);
+    }
+
+    const char* Intern(const std::string& string)
+    {
+        std::lock_guard<std::mutex> lock(g_internMutex);
+        g_interned.push_back(string);
+        return g_interned.back().c_str();
+    }
+}
+
+TraceSpan::TraceSpan(const char* name, const char* category) :
+    m_name(name),
+    m_category(category)
+{
+    Trace::Begin(m_name, m_category);
+}
+
+TraceSpan::~TraceSpan()
+{
+    Trace::End(m_name, m_category);
+}
\ No newline at end of file
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <string>
+
+// Optional timeline of a run as Chrome trace event JSON, which loads in Perfetto (ui.perfetto.dev) and chrome://tracing.
+// Recording an event only appends it to an in memory buffer. A background thread formats and writes the buffer
+// out every so often, so the threads being traced never wait on the file.
+// Nothing is recorded unless a trace is open, and then the cost is a clock read and a short lock per event,
+// so it's meant for phases, stages and sampled counters rather than per pixel work.
+namespace Trace
+{
+    // Starts recording to fileName. Returns false if a trace is already open or the file can't be created.
+    bool Open(const char* fileName);
+
+    // Writes out everything recorded so far and finishes the file
+    void Close();
+
+    bool IsOpen();
+
+    // Names and categories are kept by pointer, so they have to outlive the trace: string literals, or Intern().
+    void Begin(const char* name, const char* category);
+    void End(const char* name, const char* category);
+
+    // Sampled value, shown as its own track
+    void Counter(const char* name, double value);
+
+    // Labels the calling thread's track
+    void SetThreadName(const char* name);
+
+    // A copy of the string that lives until the program exits
+    const char* Intern(const std::string& string);
+}
+
+// Begin on construction, End on destruction
+class TraceSpan
+{
+public:
+    TraceSpan(const char* name, const char* category);
+    ~TraceSpan();
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+private:
+    const char* m_name;
+    const char* m_category;
+};
\ No newline at end of file
@@ -13,6 +13,7 @@
 #include <string>
 #include <vector>
 
+#include "ArenaAllocator.h"
 #include "STBNMath.h"
 
 union Dimensions3D;
@@ -36,7 +37,7 @@ template<>
 void ToRGBA32(Float3 in, unsigned char* out);
 
 template<typename T>
-std::vector<unsigned char> ConvertCellsAndPDFToRGBA32Texture(const std::vector<T>& cells, const std::vector<float>& pdf, float pdfMin, float pdfMax)
+std::vector<unsigned char> ConvertCellsAndPDFToRGBA32Texture(const ArenaVector<T>& cells, const ArenaVector<float>& pdf, float pdfMin, float pdfMax)
 {
     std::vector<unsigned char> output(cells.size() * 4, 0);
     for (size_t index = 0; index < cells.size(); ++index)
@@ -17,7 +17,7 @@
 #include "RandomTextureGenerators/PDFStats.h"
 #include "ValueDistanceFunctions/Float3ValueDistanceFunctions.h"
 
-PDFStats CosineWeightedHemisphereFloat3RandomTextureGenerator::Generate(std::vector<Float3>& cells, std::vector<float>& pdf, pcg32_random_t& rng)
+PDFStats CosineWeightedHemisphereFloat3RandomTextureGenerator::Generate(ArenaVector<Float3>& cells, ArenaVector<float>& pdf, pcg32_random_t& rng)
 {
     PDFStats stats;
     for (size_t index = 0; index < cells.size(); ++index)
@@ -15,6 +15,8 @@
 
 #include "pcg_basic.h"
 
+#include "ArenaAllocator.h"
+
 union Float3;
 
 struct PDFStats;
@@ -22,6 +24,6 @@ struct PDFStats;
 class CosineWeightedHemisphereFloat3RandomTextureGenerator
 {
 public:
-    PDFStats Generate(std::vector<Float3>& cells, std::vector<float>& pdf, pcg32_random_t& rng);
+    PDFStats Generate(ArenaVector<Float3>& cells, ArenaVector<float>& pdf, pcg32_random_t& rng);
 
 };
\ No newline at end of file
@@ -15,13 +15,15 @@
 
 #include "pcg_basic.h"
 
+#include "ArenaAllocator.h"
+
 #include "RandomTextureGenerators/PDFStats.h"
 
 template<typename T, T(*RandomTGenerator)(pcg32_random_t& rng)>
 class DefaultRandomTextureGenerator
 {
 public:
-    PDFStats Generate(std::vector<T>& cells, std::vector<float>& pdf, pcg32_random_t& rng)
+    PDFStats Generate(ArenaVector<T>& cells, ArenaVector<float>& pdf, pcg32_random_t& rng)
     {
         PDFStats stats;
         for (size_t index = 0; index < cells.size(); ++index)
@@ -12,6 +12,7 @@
 
 #include <algorithm>
 
+#include "ArenaAllocator.h"
 #include "STBNMath.h"
 #include "STBNRandom.h"
 
@@ -28,7 +29,7 @@ public:
 
     }
 
-    PDFStats Generate(std::vector<T>& cells, std::vector<float>& pdf, pcg32_random_t& rng)
+    PDFStats Generate(ArenaVector<T>& cells, ArenaVector<float>& pdf, pcg32_random_t& rng)
     {
         PDFStats stats;
         for (size_t index = 0; index < cells.size(); ++index)
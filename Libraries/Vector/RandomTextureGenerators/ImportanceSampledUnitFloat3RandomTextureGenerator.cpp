@@ -25,7 +25,7 @@ ImportanceSampledUnitFloat3RandomTextureGenerator::ImportanceSampledUnitFloat3Ra
 
 }
 
-PDFStats ImportanceSampledUnitFloat3RandomTextureGenerator::Generate(std::vector<Float3>& cells, std::vector<float>& pdf, pcg32_random_t& rng)
+PDFStats ImportanceSampledUnitFloat3RandomTextureGenerator::Generate(ArenaVector<Float3>& cells, ArenaVector<float>& pdf, pcg32_random_t& rng)
 {
     PDFStats stats;
     for (size_t index = 0; index < cells.size(); ++index)
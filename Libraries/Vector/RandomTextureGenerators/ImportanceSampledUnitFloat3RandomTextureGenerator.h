@@ -16,6 +16,8 @@
 
 #include "pcg_basic.h"
 
+#include "ArenaAllocator.h"
+
 #include "ImportanceSampling/ImportanceSamplingData.h"
 #include "Types/Float3.h"
 
@@ -27,7 +29,7 @@ class ImportanceSampledUnitFloat3RandomTextureGenerator
 public:
     ImportanceSampledUnitFloat3RandomTextureGenerator(ImportanceSamplingData& isData);
 
-    PDFStats Generate(std::vector<Float3>& cells, std::vector<float>& pdf, pcg32_random_t& rng);
+    PDFStats Generate(ArenaVector<Float3>& cells, ArenaVector<float>& pdf, pcg32_random_t& rng);
 
 private:
     ImportanceSamplingData m_isData;
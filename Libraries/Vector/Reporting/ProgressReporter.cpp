@@ -10,6 +10,8 @@
 
 #include "ProgressReporter.h"
 
+#include "CPUDispatch.h"
+#include "Trace.h"
 #include "Utils/Dimensions3D.h"
 
 #include <chrono>
@@ -31,7 +33,8 @@ ProgressReporter::ProgressReporter(VectorSTBNProgressData& stbnProgress, SAProgr
     m_finishedSA(false),
     m_startedFileExport(false),
     m_finishedFileExport(false),
-    m_done(false)
+    m_done(false),
+    m_traceSampleSwapIndex(0)
 {
 
 }
@@ -101,8 +104,9 @@ std::string DurationToTimeStr(std::chrono::duration<float> duration)
 void ProgressReporter::CmdReporter()
 {
     std::stringstream ss;
-    ss << "Running SimulatedAnnealing on " << m_dims.x << "x" << m_dims.y << "x" << m_dims.z << "\n";
+    ss << "Running SimulatedAnnealing on " << m_dims.x << "x" << m_dims.y << "x" << m_dims.z << " (CPU dispatch: " << ISAToString(GetSelectedISA()) << ")\n";
     LogLine(ss.str());
+    Trace::SetThreadName("Progress reporter");
     while (IsInProgress())
     {
         UpdateCMD();
@@ -146,8 +150,11 @@ void ProgressReporter::UpdateCMD()
         {
             m_finishedSA = true;
             PrintNewline();
-            LogLine("Running simulated annealing...Done");
+            std::stringstream ss;
+            ss << "Running simulated annealing...Done (" << SAStopReasonToString(m_saProgress.stopReason) << " after " << m_saProgress.swapIndex << " swaps)";
+            LogLine(ss.str());
             PrintNewline();
+            PrintProposalAcceptance();
         }
         return;
     }
@@ -182,6 +189,8 @@ void ProgressReporter::InitializeSAState()
     m_saEnergyTextWidth = std::max(5, static_cast<int>(std::log10f(m_saStartingEnergy)) + 1);
     m_saSwapCountTextWidth = std::max(3, static_cast<int>(std::log10f(m_saProgress.totalSwaps)));
     m_saStartTime = std::chrono::system_clock::now();
+    m_traceSampleTime = std::chrono::steady_clock::now();
+    m_traceSampleSwapIndex = m_saProgress.swapIndex;
 }
 
 void ProgressReporter::UpdateSALine()
@@ -196,4 +205,39 @@ void ProgressReporter::UpdateSALine()
     auto deltaTime = currentTime - m_saStartTime;
     ss << "Duration: " << DurationToTimeStr(deltaTime);
     LogLine(ss.str());
+
+    SampleSATraceCounters();
+}
+
+void ProgressReporter::PrintProposalAcceptance()
+{
+    for (size_t type = 0; type < size_t(SwapProposalType::Count); ++type)
+    {
+        size_t numProposed = m_saProgress.numProposed[type];
+        if (numProposed == 0)
+            continue;
+
+        std::stringstream ss;
+        float acceptance = 100.0f * static_cast<float>(m_saProgress.numAccepted[type]) / static_cast<float>(numProposed);
+        ss << "  " << SwapProposalTypeToString(SwapProposalType(type)) << " swaps: " << numProposed << " proposed, " << std::setprecision(3) << std::fixed << acceptance << "% accepted";
+        LogLine(ss.str());
+        PrintNewline();
+    }
+}
+
+void ProgressReporter::SampleSATraceCounters()
+{
+    if (!Trace::IsOpen())
+        return;
+
+    auto now = std::chrono::steady_clock::now();
+    size_t swapIndex = m_saProgress.swapIndex;
+    float seconds = std::chrono::duration<float>(now - m_traceSampleTime).count();
+    Trace::Counter("Energy", m_saProgress.energy);
+    Trace::Counter("Temperature", m_saProgress.temperature);
+    Trace::Counter("Acceptance rate", m_saProgress.acceptanceRate);
+    if (seconds > 0.0f)
+        Trace::Counter("Swaps/sec", float(swapIndex - m_traceSampleSwapIndex) / seconds);
+    m_traceSampleTime = now;
+    m_traceSampleSwapIndex = swapIndex;
 }
\ No newline at end of file
@@ -47,9 +47,15 @@ private:
 
     std::chrono::system_clock::time_point m_saStartTime;
 
+    // Last sample of the trace counters, for swaps per second
+    std::chrono::steady_clock::time_point m_traceSampleTime;
+    size_t m_traceSampleSwapIndex;
+
     bool IsInProgress();
     void CmdReporter();
     void UpdateCMD();
     void InitializeSAState();
     void UpdateSALine();
+    void PrintProposalAcceptance();
+    void SampleSATraceCounters();
 };
\ No newline at end of file
@@ -0,0 +1,93 @@
+/*
+* Copyright (c) 2024, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#include "SimulatedAnnealing/CheckerboardTiles.h"
+
+#include <algorithm>
+
+static size_t NumTilesOnAxis(size_t dim, size_t reach)
+{
+    size_t minTileSize = std::max(2 * reach, size_t(1));
+    size_t numTiles = (dim / minTileSize) & ~size_t(1);
+    return (numTiles >= 2) ? numTiles : 1;
+}
+
+CheckerboardTiles::CheckerboardTiles(const Dimensions3D& dims, const Dimensions3D& reach) :
+    m_dims(dims),
+    m_tileCounts({ NumTilesOnAxis(dims.x, reach.x), NumTilesOnAxis(dims.y, reach.y), NumTilesOnAxis(dims.z, reach.z) }),
+    m_offset({ 0, 0, 0 })
+{
+    std::vector<std::vector<size_t>> tilesByColor(8);
+    for (size_t tile = 0; tile < m_tileCounts.NumPixels(); ++tile)
+    {
+        PixelCoords3D tileCoords = TileCoords(tile);
+        size_t color = (tileCoords.x & 1) | ((tileCoords.y & 1) << 1) | ((tileCoords.z & 1) << 2);
+        tilesByColor[color].push_back(tile);
+    }
+
+    for (std::vector<size_t>& tiles : tilesByColor)
+    {
+        if (!tiles.empty())
+            m_tilesByColor.push_back(std::move(tiles));
+    }
+}
+
+void CheckerboardTiles::SetOffset(const PixelCoords3D& offset)
+{
+    m_offset = offset;
+}
+
+const Dimensions3D& CheckerboardTiles::GetTileCounts() const
+{
+    return m_tileCounts;
+}
+
+size_t CheckerboardTiles::NumColors() const
+{
+    return m_tilesByColor.size();
+}
+
+const std::vector<size_t>& CheckerboardTiles::GetTilesOfColor(size_t color) const
+{
+    return m_tilesByColor[color];
+}
+
+size_t CheckerboardTiles::TileNumPixels(size_t tile) const
+{
+    PixelCoords3D tileCoords = TileCoords(tile);
+    size_t ret = 1;
+    for (int axis = 0; axis < 3; ++axis)
+        ret *= TileStart(axis, tileCoords[axis] + 1) - TileStart(axis, tileCoords[axis]);
+    return ret;
+}
+
+size_t CheckerboardTiles::RandomPixelInTile(size_t tile, pcg32_random_t& rng) const
+{
+    PixelCoords3D tileCoords = TileCoords(tile);
+    PixelCoords3D pixelCoords;
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        size_t start = TileStart(axis, tileCoords[axis]);
+        size_t size = TileStart(axis, tileCoords[axis] + 1) - start;
+        pixelCoords[axis] = (start + m_offset[axis] + pcg32_boundedrand_r(&rng, (uint32_t)size)) % m_dims.dim[axis];
+    }
+    return PixelCoords3DToPixelIndex(pixelCoords, m_dims);
+}
+
+// Tile sizes differ by at most one pixel
+size_t CheckerboardTiles::TileStart(int axis, size_t tileCoord) const
+{
+    return tileCoord * m_dims.dim[axis] / m_tileCounts.dim[axis];
+}
+
+PixelCoords3D CheckerboardTiles::TileCoords(size_t tile) const
+{
+    return PixelIndexToPixelCoords3D(tile, m_tileCounts);
+}
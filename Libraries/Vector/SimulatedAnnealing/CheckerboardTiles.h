@@ -0,0 +1,48 @@
+/*
+* Copyright (c) 2024, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#pragma once
+
+#include <vector>
+
+#include "Utils/Dimensions3D.h"
+#include "Utils/PixelCoords3D.h"
+
+#include "pcg_basic.h"
+
+// Splits the XYZ torus into a grid of tiles, colored like a 3D checkerboard, for swapping in parallel.
+// A swap reads and writes up to reach pixels away from the swapped pixels on each axis, so tiles are at least
+// 2 * reach wide and there is an even number of them on each axis. Two tiles of the same color are then a whole
+// tile apart on some axis, and swaps inside them never touch the same pixels.
+// An axis too short for two such tiles isn't split, which leaves fewer colors.
+class CheckerboardTiles
+{
+public:
+    CheckerboardTiles(const Dimensions3D& dims, const Dimensions3D& reach);
+
+    // Shifts every tile by offset (wrapping around), so swaps can cross the previous boundaries
+    void SetOffset(const PixelCoords3D& offset);
+
+    const Dimensions3D& GetTileCounts() const;
+    size_t NumColors() const;
+    const std::vector<size_t>& GetTilesOfColor(size_t color) const;
+
+    size_t TileNumPixels(size_t tile) const;
+    size_t RandomPixelInTile(size_t tile, pcg32_random_t& rng) const;
+
+private:
+    Dimensions3D m_dims;
+    Dimensions3D m_tileCounts;
+    PixelCoords3D m_offset;
+    std::vector<std::vector<size_t>> m_tilesByColor;
+
+    size_t TileStart(int axis, size_t tileCoord) const;
+    PixelCoords3D TileCoords(size_t tile) const;
+};
@@ -0,0 +1,136 @@
+/*
+* Copyright (c) 2024, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#include "SimulatedAnnealing/CoolingSchedule.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+bool StringToCoolingScheduleType(const std::string& str, CoolingScheduleType& type)
+{
+    if (str == "Linear")
+        type = CoolingScheduleType::Linear;
+    else if (str == "Geometric")
+        type = CoolingScheduleType::Geometric;
+    else if (str == "Adaptive")
+        type = CoolingScheduleType::Adaptive;
+    else if (str == "Reheating")
+        type = CoolingScheduleType::Reheating;
+    else
+        return false;
+    return true;
+}
+
+CoolingSchedule::CoolingSchedule(const CoolingScheduleParams& params, float coolingRate, size_t windowSwaps) :
+    m_params(params),
+    m_coolingRate(coolingRate),
+    m_windowSwaps(std::max(windowSwaps, size_t(1))),
+    m_logCoolingFactor(std::log(c_finalTemperature) * coolingRate),
+    // Steps of a quarter of the whole geometric schedule's, so the temperature can keep up with the target
+    m_logAdaptiveStep(-4.0f * std::log(c_finalTemperature) * coolingRate),
+    m_acceptanceEstimate(1.0f),
+    m_adaptiveMemory(std::max(0.02f / coolingRate, 100.0f)),
+    m_windowSwapCount(0),
+    m_windowAccepted(0),
+    m_windowStartEnergy(0.0f),
+    m_stalledWindows(0),
+    m_numReheats(0)
+{
+
+}
+
+void CoolingSchedule::Start(SAProgressData& pd)
+{
+    pd.temperature = 1.0f;
+    pd.acceptanceRate = 1.0f;
+    pd.stopReason = SAStopReason::Running;
+
+    m_acceptanceEstimate = 1.0f;
+    m_windowSwapCount = 0;
+    m_windowAccepted = 0;
+    m_windowStartEnergy = pd.energy;
+    m_stalledWindows = 0;
+    m_numReheats = 0;
+}
+
+void CoolingSchedule::Cool(SAProgressData& pd, size_t numSwaps)
+{
+    switch (m_params.type)
+    {
+        case CoolingScheduleType::Linear:
+        {
+            pd.temperature = std::max(pd.temperature - m_coolingRate * float(numSwaps), 0.0f);
+            break;
+        }
+        case CoolingScheduleType::Geometric:
+        case CoolingScheduleType::Reheating:
+        {
+            pd.temperature *= std::exp(m_logCoolingFactor * float(numSwaps));
+            break;
+        }
+        case CoolingScheduleType::Adaptive:
+        {
+            float target = TargetAcceptanceRate(float(pd.swapIndex) * m_coolingRate);
+            float step = m_logAdaptiveStep * float(numSwaps);
+            pd.temperature = std::min(pd.temperature * std::exp(m_acceptanceEstimate > target ? -step : step), 1.0f);
+            break;
+        }
+    }
+}
+
+void CoolingSchedule::Observe(SAProgressData& pd, size_t numSwaps, size_t numAccepted)
+{
+    float blend = 1.0f - std::exp(-float(numSwaps) / m_adaptiveMemory);
+    m_acceptanceEstimate += blend * (float(numAccepted) / float(std::max(numSwaps, size_t(1))) - m_acceptanceEstimate);
+
+    m_windowSwapCount += numSwaps;
+    m_windowAccepted += numAccepted;
+    if (m_windowSwapCount >= m_windowSwaps)
+        EndWindow(pd);
+
+    if (pd.stopReason == SAStopReason::Running && pd.swapIndex >= pd.totalSwaps)
+        pd.stopReason = SAStopReason::SwapBudget;
+}
+
+float CoolingSchedule::TargetAcceptanceRate(float fraction)
+{
+    if (fraction < 0.15f)
+        return 0.44f + 0.56f * std::pow(560.0f, -fraction / 0.15f);
+    if (fraction < 0.65f)
+        return 0.44f;
+    return 0.44f * std::pow(440.0f, -(fraction - 0.65f) / 0.35f);
+}
+
+void CoolingSchedule::EndWindow(SAProgressData& pd)
+{
+    float improvement = (m_windowStartEnergy - pd.energy) / std::max(std::abs(m_windowStartEnergy), FLT_MIN);
+    pd.acceptanceRate = float(m_windowAccepted) / float(m_windowSwapCount);
+
+    bool stalled = improvement < m_params.stallImprovement && pd.acceptanceRate < m_params.stallAcceptance;
+    m_stalledWindows = stalled ? m_stalledWindows + 1 : 0;
+    if (m_stalledWindows >= std::max(m_params.stallWindows, size_t(1)))
+    {
+        if (m_params.type == CoolingScheduleType::Reheating && m_numReheats < c_maxReheats)
+        {
+            pd.temperature = std::max(pd.temperature, c_reheatTemperature * std::pow(0.5f, float(m_numReheats)));
+            m_numReheats++;
+            m_stalledWindows = 0;
+        }
+        else if (m_params.earlyStop)
+        {
+            pd.stopReason = SAStopReason::Converged;
+        }
+    }
+
+    m_windowSwapCount = 0;
+    m_windowAccepted = 0;
+    m_windowStartEnergy = pd.energy;
+}
@@ -0,0 +1,91 @@
+/*
+* Copyright (c) 2024, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+#include "SimulatedAnnealing/SAProgressData.h"
+
+// Temperature is the chance that SimulatedAnnealing::Run() takes a swap that raises the energy. It starts at 1,
+// and 1 / coolingRate swaps is the length of the schedule.
+enum class CoolingScheduleType
+{
+    // Drops by coolingRate every swap, to 0 at the end of the schedule
+    Linear,
+    // Drops by the same factor every swap, to c_finalTemperature at the end of the schedule
+    Geometric,
+    // Lam's schedule: nudged down while more swaps are accepted than a target rate, and up while fewer are.
+    // The target starts near 1, holds at 0.44 through most of the schedule, and falls off at the end.
+    Adaptive,
+    // Geometric, but going back up to a lower temperature each time the run stalls, a few times over
+    Reheating
+};
+
+bool StringToCoolingScheduleType(const std::string& str, CoolingScheduleType& type);
+
+struct CoolingScheduleParams
+{
+    CoolingScheduleType type = CoolingScheduleType::Linear;
+
+    // Swaps are looked at in windows of one swap per pixel. A window stalls when it lowers the energy by less than
+    // stallImprovement of it, and accepts less than stallAcceptance of its swaps.
+    float stallImprovement = 1e-5f;
+    float stallAcceptance = 0.01f;
+    // This many stalled windows in a row reheat (Reheating), or else end the run if earlyStop is set
+    size_t stallWindows = 4;
+    bool earlyStop = false;
+};
+
+class CoolingSchedule
+{
+public:
+    CoolingSchedule(const CoolingScheduleParams& params, float coolingRate, size_t windowSwaps);
+
+    // Temperature 1, and a new window starting at pd.energy
+    void Start(SAProgressData& pd);
+
+    // Lowers pd.temperature ahead of the next numSwaps swaps
+    void Cool(SAProgressData& pd, size_t numSwaps);
+
+    // Takes in numSwaps swaps that are done, numAccepted of which were accepted, after pd.swapIndex and pd.energy
+    // have been updated for them. Sets pd.stopReason once the run should end.
+    void Observe(SAProgressData& pd, size_t numSwaps, size_t numAccepted);
+
+    // Lam's target acceptance rate, fraction of the way through the schedule
+    static float TargetAcceptanceRate(float fraction);
+
+private:
+    static constexpr float c_finalTemperature = 1e-3f;
+    // Reheating starts from this temperature, halving each time, at most c_maxReheats times
+    static constexpr float c_reheatTemperature = 0.05f;
+    static const size_t c_maxReheats = 3;
+
+    CoolingScheduleParams m_params;
+    float m_coolingRate;
+    size_t m_windowSwaps;
+
+    // Per swap log of the geometric cooling factor, and of the adaptive schedule's step
+    float m_logCoolingFactor;
+    float m_logAdaptiveStep;
+
+    // Moving average of accepted swaps, remembering about m_adaptiveMemory swaps
+    float m_acceptanceEstimate;
+    float m_adaptiveMemory;
+
+    size_t m_windowSwapCount;
+    size_t m_windowAccepted;
+    float m_windowStartEnergy;
+    size_t m_stalledWindows;
+    size_t m_numReheats;
+
+    void EndWindow(SAProgressData& pd);
+};
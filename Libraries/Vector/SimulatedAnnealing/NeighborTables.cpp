@@ -0,0 +1,142 @@
+/*
+* Copyright (c) 2024, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#include "SimulatedAnnealing/NeighborTables.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace
+{
+
+// The wrapped offsets of one axis' kernel taps, for each class of coordinate along the axis
+struct AxisTaps
+{
+    std::vector<size_t> classes;
+    size_t numClasses = 0;
+    size_t numTaps = 0;
+    // numClasses * numTaps, the taps of a class in kernel order
+    std::vector<std::ptrdiff_t> offsets;
+};
+
+AxisTaps MakeAxisTaps(const SymmetricKernel& kernel, size_t size)
+{
+    AxisTaps ret;
+    ret.numTaps = size_t(kernel.end() - kernel.start());
+
+    // Coordinates below -start() wrap off the low edge and those above size - end() off the high edge, each in its
+    // own way. Everything in between doesn't wrap.
+    size_t lowEdge = size_t(std::max(-kernel.start(), 0));
+    size_t highEdge = size_t(std::max(kernel.end() - 1, 0));
+    bool shareInterior = size > lowEdge + highEdge + 1;
+    ret.numClasses = shareInterior ? lowEdge + highEdge + 1 : size;
+
+    ret.classes.resize(size);
+    ret.offsets.resize(ret.numClasses * ret.numTaps);
+    for (size_t coord = 0; coord < size; ++coord)
+    {
+        size_t coordClass = coord;
+        if (shareInterior && coord >= lowEdge)
+            coordClass = (coord + highEdge < size) ? lowEdge : lowEdge + 1 + (coord + highEdge - size);
+        ret.classes[coord] = coordClass;
+
+        for (int tap = kernel.start(); tap < kernel.end(); ++tap)
+        {
+            std::ptrdiff_t wrapped = ((std::ptrdiff_t)coord + tap + (std::ptrdiff_t)size) % (std::ptrdiff_t)size;
+            ret.offsets[coordClass * ret.numTaps + size_t(tap - kernel.start())] = wrapped - (std::ptrdiff_t)coord;
+        }
+    }
+    return ret;
+}
+
+}
+
+NeighborTables::NeighborTables(const Dimensions3D& dims, const SymmetricKernel& kernelX, const SymmetricKernel& kernelY, const SymmetricKernel& kernelZ)
+{
+    AxisTaps tapsX = MakeAxisTaps(kernelX, dims.x);
+    AxisTaps tapsY = MakeAxisTaps(kernelY, dims.y);
+    AxisTaps tapsZ = MakeAxisTaps(kernelZ, dims.z);
+    m_classesX = tapsX.classes;
+    m_classesY = tapsY.classes;
+    m_classesZ = tapsZ.classes;
+    m_numClassesX = tapsX.numClasses;
+
+    const std::ptrdiff_t rowPitch = (std::ptrdiff_t)dims.x;
+    const std::ptrdiff_t slicePitch = (std::ptrdiff_t)(dims.x * dims.y);
+    bool hasCenterX = kernelX.start() <= 0 && 0 < kernelX.end();
+    bool hasCenterY = kernelY.start() <= 0 && 0 < kernelY.end();
+    bool hasCenterZ = kernelZ.start() <= 0 && 0 < kernelZ.end();
+
+    m_numNeighborsXY = tapsX.numTaps * tapsY.numTaps - ((hasCenterX && hasCenterY) ? 1 : 0);
+    m_neighborsXY.reserve(tapsX.numClasses * tapsY.numClasses * m_numNeighborsXY);
+    for (size_t classY = 0; classY < tapsY.numClasses; ++classY)
+    {
+        for (size_t classX = 0; classX < tapsX.numClasses; ++classX)
+        {
+            for (int iy = kernelY.start(); iy < kernelY.end(); ++iy)
+            {
+                std::ptrdiff_t offsetY = tapsY.offsets[classY * tapsY.numTaps + size_t(iy - kernelY.start())] * rowPitch;
+                for (int ix = kernelX.start(); ix < kernelX.end(); ++ix)
+                {
+                    if (ix == 0 && iy == 0)
+                        continue;
+
+                    std::ptrdiff_t offsetX = tapsX.offsets[classX * tapsX.numTaps + size_t(ix - kernelX.start())];
+                    m_neighborsXY.push_back({ offsetY + offsetX, kernelX[size_t(std::abs(ix))] * kernelY[size_t(std::abs(iy))] });
+                }
+            }
+        }
+    }
+
+    m_numNeighborsZ = tapsZ.numTaps - (hasCenterZ ? 1 : 0);
+    m_neighborsZ.reserve(tapsZ.numClasses * m_numNeighborsZ);
+    for (size_t classZ = 0; classZ < tapsZ.numClasses; ++classZ)
+    {
+        for (int iz = kernelZ.start(); iz < kernelZ.end(); ++iz)
+        {
+            if (iz == 0)
+                continue;
+
+            m_neighborsZ.push_back({ tapsZ.offsets[classZ * tapsZ.numTaps + size_t(iz - kernelZ.start())] * slicePitch, kernelZ[size_t(std::abs(iz))] });
+        }
+    }
+
+    m_numRows = tapsY.numTaps;
+    m_rows.reserve(tapsY.numClasses * m_numRows);
+    for (size_t classY = 0; classY < tapsY.numClasses; ++classY)
+    {
+        for (int iy = kernelY.start(); iy < kernelY.end(); ++iy)
+            m_rows.push_back({ tapsY.offsets[classY * tapsY.numTaps + size_t(iy - kernelY.start())] * rowPitch, kernelY[size_t(std::abs(iy))], iy == 0 });
+    }
+
+    // A row wraps where its offsets jump back by the image width
+    m_runs.resize(tapsX.numClasses);
+    for (size_t classX = 0; classX < tapsX.numClasses; ++classX)
+    {
+        const std::ptrdiff_t* offsets = &tapsX.offsets[classX * tapsX.numTaps];
+        Runs& runs = m_runs[classX];
+        runs = { 1, { offsets[0], 0 }, { tapsX.numTaps, 0 }, { 0, 0 } };
+        for (size_t tap = 1; tap < tapsX.numTaps; ++tap)
+        {
+            if (offsets[tap] != offsets[tap - 1] + 1)
+            {
+                runs = { 2, { offsets[0], offsets[tap] }, { tap, tapsX.numTaps - tap }, { 0, tap } };
+                break;
+            }
+        }
+    }
+
+    m_rowKernelX.assign(tapsX.numTaps + 8, 0.0f);
+    for (int ix = kernelX.start(); ix < kernelX.end(); ++ix)
+        m_rowKernelX[size_t(ix - kernelX.start())] = kernelX[size_t(std::abs(ix))];
+    m_centerRowKernelX = m_rowKernelX;
+    if (hasCenterX)
+        m_centerRowKernelX[size_t(-kernelX.start())] = 0.0f;
+}
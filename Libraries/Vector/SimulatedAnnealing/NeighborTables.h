@@ -0,0 +1,102 @@
+/*
+* Copyright (c) 2024, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+#include "Kernel/SymmetricKernel.h"
+#include "Utils/Dimensions3D.h"
+#include "Utils/PixelCoords3D.h"
+
+// The neighborhoods SADataController visits, worked out once instead of per neighbor: each neighbor is a flat
+// index offset from the pixel and its kernel weight, already wrapped around the torus.
+// Along each axis, all pixels far enough from the edges share one set of offsets. Each pixel within reach of an
+// edge wraps differently, so it gets its own set. An axis shorter than the kernel gives every coordinate its own set.
+// The XY lists cover every (X set, Y set) pair, so there are at most (kernel width)^2 of them, whatever the size.
+class NeighborTables
+{
+public:
+    struct Neighbor
+    {
+        std::ptrdiff_t offset;
+        float kernel;
+    };
+
+    // One row of the XY neighborhood, for walking it in runs: offset takes the pixel to the same X in the row
+    struct Row
+    {
+        std::ptrdiff_t offset;
+        float kernelY;
+        bool center;
+    };
+
+    // The runs of neighbors next to each other in memory that make up each row: one, or two if the row wraps
+    // around the image edge. offset takes a pixel in the row to the start of the run, and kernelOffset is
+    // where the run's weights start in GetRowKernelX().
+    struct Runs
+    {
+        size_t numRuns;
+        std::ptrdiff_t offset[2];
+        size_t count[2];
+        size_t kernelOffset[2];
+    };
+
+    NeighborTables(const Dimensions3D& dims, const SymmetricKernel& kernelX, const SymmetricKernel& kernelY, const SymmetricKernel& kernelZ);
+
+    // The XY neighbors of a pixel, without the pixel itself. Y is the outer loop and X the inner one, both in kernel order.
+    std::span<const Neighbor> GetNeighborsXY(const PixelCoords3D& pixelCoords) const
+    {
+        size_t list = m_classesY[pixelCoords.y] * m_numClassesX + m_classesX[pixelCoords.x];
+        return { m_neighborsXY.data() + list * m_numNeighborsXY, m_numNeighborsXY };
+    }
+
+    // The Z neighbors of a pixel, without the pixel itself, in kernel order
+    std::span<const Neighbor> GetNeighborsZ(const PixelCoords3D& pixelCoords) const
+    {
+        return { m_neighborsZ.data() + m_classesZ[pixelCoords.z] * m_numNeighborsZ, m_numNeighborsZ };
+    }
+
+    std::span<const Row> GetRows(const PixelCoords3D& pixelCoords) const
+    {
+        return { m_rows.data() + m_classesY[pixelCoords.y] * m_numRows, m_numRows };
+    }
+
+    const Runs& GetRuns(const PixelCoords3D& pixelCoords) const
+    {
+        return m_runs[m_classesX[pixelCoords.x]];
+    }
+
+    // Kernel X weights along a row, padded with 0s so that 8 can be read from anywhere in it. The center row
+    // has a 0 for the pixel itself.
+    const float* GetRowKernelX(bool center) const
+    {
+        return center ? m_centerRowKernelX.data() : m_rowKernelX.data();
+    }
+
+private:
+    std::vector<size_t> m_classesX;
+    std::vector<size_t> m_classesY;
+    std::vector<size_t> m_classesZ;
+    size_t m_numClassesX;
+
+    size_t m_numNeighborsXY;
+    std::vector<Neighbor> m_neighborsXY;
+    size_t m_numNeighborsZ;
+    std::vector<Neighbor> m_neighborsZ;
+
+    size_t m_numRows;
+    std::vector<Row> m_rows;
+    std::vector<Runs> m_runs;
+    std::vector<float> m_rowKernelX;
+    std::vector<float> m_centerRowKernelX;
+};
@@ -0,0 +1,193 @@
+/*
+* Copyright (c) 2024, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "SimulatedAnnealing/SAData.h"
+#include "SimulatedAnnealing/SADataController.h"
+#include "SimulatedAnnealing/SAProgressData.h"
+#include "SimulatedAnnealing/SimulatedAnnealing.h"
+#include "Kernel/SymmetricKernel.h"
+#include "Utils/Dimensions3D.h"
+
+#include "STBNRandom.h"
+
+#include "pcg_basic.h"
+
+// Replica exchange version of SimulatedAnnealing.
+// Each replica is its own chain on its own thread, held at one temperature of a ladder that runs from 0 up to a
+// max temperature. Every so often, replicas at neighboring temperatures may trade temperatures. Hot replicas
+// wander through states a single cooling chain would never leave its local minimum for, and the better ones work
+// their way down the ladder. The replica holding temperature 0 at the end is the result.
+// The replicas use the Metropolis rule (see SimulatedAnnealing::RunAtTemperature), which is what makes the
+// Metropolis test for a trade fair: exp((E_colder - E_hotter) * (1/T_colder - 1/T_hotter)). Temperature 0
+// only ever trades for a lower energy.
+template<typename T, typename ValueWeight>
+class ParallelTempering
+{
+public:
+    ParallelTempering(SAData<T>& data, SymmetricKernel kernelX, SymmetricKernel kernelY, SymmetricKernel kernelZ, float sigmaValue, float swapCountFactor, float coolingFactor, size_t numReplicas, float maxTemperature, bool soaCells, const SwapProposalParams& proposals, SAProgressData& pd) :
+        m_data(data),
+        m_maxTemperature(maxTemperature),
+        m_pd(pd)
+    {
+        numReplicas = std::max(numReplicas, size_t(2));
+        for (size_t index = 0; index < numReplicas; ++index)
+            m_replicas.push_back(std::make_unique<Replica>(data.dims, kernelX, kernelY, kernelZ, sigmaValue, swapCountFactor, coolingFactor, soaCells, proposals));
+
+        // Exchange often enough that good states can travel the whole ladder many times over
+        m_swapsPerRound = std::max(m_replicas[0]->sa.GetNumSwaps() / c_numRounds, size_t(1));
+    }
+
+    size_t GetNumReplicas() const
+    {
+        return m_replicas.size();
+    }
+
+    // Temperature at rung 0 (coldest) through GetNumReplicas() - 1 (hottest). Geometric, apart from the 0 at the bottom.
+    float GetLadderTemperature(size_t rung) const
+    {
+        if (rung == 0)
+            return 0.0f;
+        return m_maxTemperature * std::pow(c_ladderRatio, float(m_replicas.size() - 1 - rung));
+    }
+
+    void Run(pcg32_random_t& rng)
+    {
+        for (size_t index = 0; index < m_replicas.size(); ++index)
+        {
+            Replica& replica = *m_replicas[index];
+            std::copy(m_data.cells.begin(), m_data.cells.end(), replica.data.cells.begin());
+            std::copy(m_data.pdf.begin(), m_data.pdf.end(), replica.data.pdf.begin());
+            pcg32_srandom_r(&replica.rng, pcg32_random_r(&rng), index);
+            replica.rung = index;
+        }
+
+        RunRound([](Replica& replica, float) { replica.sa.Start(); });
+        m_pd.energy = Coldest().sa.GetProgressData().energy;
+        m_pd.temperature = 0.0f;
+        m_pd.swapIndex = 0;
+
+        size_t numSwaps = m_replicas[0]->sa.GetNumSwaps();
+        bool oddPairs = false;
+        while (m_pd.swapIndex < numSwaps)
+        {
+            size_t swapsPerRound = m_swapsPerRound;
+            RunRound([swapsPerRound](Replica& replica, float temperature) { replica.sa.RunAtTemperature(replica.rng, temperature, swapsPerRound); });
+
+            ExchangeTemperatures(rng, oddPairs);
+            oddPairs = !oddPairs;
+
+            m_pd.energy = Coldest().sa.GetProgressData().energy;
+            m_pd.swapIndex = m_replicas[0]->sa.GetProgressData().swapIndex;
+        }
+
+        const Replica& coldest = Coldest();
+        std::copy(coldest.data.cells.begin(), coldest.data.cells.end(), m_data.cells.begin());
+        std::copy(coldest.data.pdf.begin(), coldest.data.pdf.end(), m_data.pdf.begin());
+        std::copy(coldest.data.energy.begin(), coldest.data.energy.end(), m_data.energy.begin());
+        m_pd.stopReason = SAStopReason::SwapBudget;
+
+        // Replicas trade temperatures, so no one of them saw a single temperature's proposals. Report them all.
+        for (size_t type = 0; type < size_t(SwapProposalType::Count); ++type)
+        {
+            m_pd.numProposed[type] = 0;
+            m_pd.numAccepted[type] = 0;
+            for (const std::unique_ptr<Replica>& replica : m_replicas)
+            {
+                m_pd.numProposed[type] += replica->sa.GetProgressData().numProposed[type];
+                m_pd.numAccepted[type] += replica->sa.GetProgressData().numAccepted[type];
+            }
+        }
+    }
+
+private:
+    static const size_t c_numRounds = 256;
+    static constexpr float c_ladderRatio = 0.5f;
+
+    struct Replica
+    {
+        Replica(const Dimensions3D& dims, SymmetricKernel kernelX, SymmetricKernel kernelY, SymmetricKernel kernelZ, float sigmaValue, float swapCountFactor, float coolingFactor, bool soaCells, const SwapProposalParams& proposals) :
+            data(dims),
+            controller(data, kernelX, kernelY, kernelZ, sigmaValue, soaCells),
+            sa(dims, controller, swapCountFactor, coolingFactor, CoolingScheduleParams(), proposals),
+            rung(0)
+        {
+
+        }
+
+        SAData<T> data;
+        SADataController<T, ValueWeight> controller;
+        SimulatedAnnealing<T, ValueWeight> sa;
+        pcg32_random_t rng;
+        size_t rung;
+    };
+
+    SAData<T>& m_data;
+    float m_maxTemperature;
+    SAProgressData& m_pd;
+
+    std::vector<std::unique_ptr<Replica>> m_replicas;
+    size_t m_swapsPerRound;
+
+    const Replica& Coldest() const
+    {
+        for (const std::unique_ptr<Replica>& replica : m_replicas)
+        {
+            if (replica->rung == 0)
+                return *replica;
+        }
+        return *m_replicas[0];
+    }
+
+    // Runs func(replica, temperature) for every replica at once, one thread each
+    template<typename FUNC>
+    void RunRound(FUNC func)
+    {
+        std::vector<std::thread> threads;
+        for (std::unique_ptr<Replica>& replica : m_replicas)
+        {
+            Replica* replicaPtr = replica.get();
+            threads.emplace_back([this, replicaPtr, &func]() { func(*replicaPtr, GetLadderTemperature(replicaPtr->rung)); });
+        }
+        for (std::thread& thread : threads)
+            thread.join();
+    }
+
+    // Alternates between trying rungs (0,1), (2,3)... and (1,2), (3,4)... so every pair gets a turn
+    void ExchangeTemperatures(pcg32_random_t& rng, bool oddPairs)
+    {
+        std::vector<Replica*> byRung(m_replicas.size());
+        for (std::unique_ptr<Replica>& replica : m_replicas)
+            byRung[replica->rung] = replica.get();
+
+        for (size_t rung = oddPairs ? 1 : 0; rung + 1 < byRung.size(); rung += 2)
+        {
+            Replica* colder = byRung[rung];
+            Replica* hotter = byRung[rung + 1];
+            float colderEnergy = colder->sa.GetProgressData().energy;
+            float hotterEnergy = hotter->sa.GetProgressData().energy;
+            float colderTemperature = GetLadderTemperature(rung);
+            float hotterTemperature = GetLadderTemperature(rung + 1);
+
+            bool trade = hotterEnergy <= colderEnergy;
+            if (!trade && colderTemperature > 0.0f)
+                trade = RandomFloat01(rng) < std::exp((colderEnergy - hotterEnergy) * (1.0f / colderTemperature - 1.0f / hotterTemperature));
+            if (trade)
+                std::swap(colder->rung, hotter->rung);
+        }
+    }
+};
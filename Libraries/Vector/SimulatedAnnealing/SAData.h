@@ -12,6 +12,7 @@
 
 #include <vector>
 
+#include "ArenaAllocator.h"
 #include "Utils/Dimensions3D.h"
 
 template<typename T>
@@ -23,13 +24,19 @@ public:
         numPixels(dims.x * dims.y * dims.z),
         cells(numPixels),
         pdf(numPixels),
-        energy(numPixels, 0.0f)
+        energy(numPixels, 0.0f),
+        planeStride((numPixels + 15) & ~size_t(15))
     {
 
     }
     const Dimensions3D dims;
     const size_t numPixels;
-    std::vector<T> cells;
-    std::vector<float> pdf;
-    std::vector<float> energy;
+    ArenaVector<T> cells;
+    ArenaVector<float> pdf;
+    ArenaVector<float> energy;
+
+    // Optional structure of arrays copy of cells, for SIMD: component c of cell i is cellPlanes[c * planeStride + i],
+    // and each plane starts 64 byte aligned. Empty unless a SADataController is using it, which keeps it in step with cells.
+    const size_t planeStride;
+    ArenaVector<float> cellPlanes;
 };
@@ -10,92 +10,80 @@
 
 #pragma once
 
+#include <algorithm>
+#include <memory>
+#include <utility>
+
 #include "SAData.h"
+#include "NeighborTables.h"
 #include "Kernel/SymmetricKernel.h"
 #include "Utils/PixelCoords3D.h"
 #include "STBNMath.h"
+#include "STBNMathAVX2.h"
 
-template<typename T, float(*ValueDistance)(T, T)>
+// Neighborhoods are walked through NeighborTables, which every worker made by MakeWorker() shares.
+// With soaCells (and AVX2 available), cells are mirrored into SAData::cellPlanes, and the XY neighborhood of a
+// pixel is evaluated 8 neighbors at a time: each row of it is one or two runs of neighbors next to each other in
+// memory. The Z neighbors are still done one at a time. Results match the scalar path up to float summation order.
+template<typename T, typename ValueWeight>
 class SADataController
 {
 public:
-    SADataController(SAData<T>& data, SymmetricKernel kernelX, SymmetricKernel kernelY, SymmetricKernel kernelZ, float sigmaValue) :
+    SADataController(SAData<T>& data, SymmetricKernel kernelX, SymmetricKernel kernelY, SymmetricKernel kernelZ, float sigmaValue, bool soaCells = false) :
         m_data(data),
         m_kernelX(kernelX),
         m_kernelY(kernelY),
         m_kernelZ(kernelZ),
-        m_sigmaValue(sigmaValue),
+        m_valueExponentScale(1.0f / (2.0f * sigmaValue * sigmaValue)),
+        m_soaCells(STBN_X86() && soaCells && GetSelectedISA() >= CPUISA::AVX2),
+        m_neighborTables(std::make_shared<NeighborTables>(data.dims, kernelX, kernelY, kernelZ)),
         m_cachedEnergy(0.0)
     {
 
     }
 
-    void RecalculateEnergy(size_t pixelIndex)
+    bool UsesSoACells() const
     {
-        const PixelCoords3D pixelCoords = PixelIndexToPixelCoords3D(pixelIndex, m_data.dims);
-
-        const T& centerCell = m_data.cells[pixelIndex];
-
-        m_cachedEnergy -= double(m_data.energy[pixelIndex]);
+        return m_soaCells;
+    }
 
-        m_data.energy[pixelIndex] = 0.0f;
+    // Copies cells into SAData::cellPlanes when using them. CommitSwap() keeps them in step, but anything else that
+    // changes cells has to call this before the next splat.
+    void SyncCellPlanes()
+    {
+        if (!m_soaCells)
+            return;
 
-        // X,Y contributions
+        m_data.cellPlanes.resize(T::N * m_data.planeStride);
+        for (size_t index = 0; index < m_data.numPixels; ++index)
         {
-            size_t imageBegin = PixelCoords3DToPixelIndex({ 0, 0, pixelCoords[2] }, m_data.dims);
-            for (int iy = m_kernelY.start(); iy < m_kernelY.end(); ++iy)
-            {
-                float kernelY = m_kernelY[abs(iy)];
-                int pixelY = ((int)pixelCoords[1] + iy + (int)m_data.dims.y) % (int)m_data.dims.y;
-                for (int ix = m_kernelX.start(); ix < m_kernelX.end(); ++ix)
-                {
-                    if (ix == 0 && iy == 0)
-                        continue;
-
-                    float kernelX = m_kernelX[abs(ix)];
-                    int pixelX = (int)(pixelCoords[0] + ix + (int)m_data.dims.x) % (int)m_data.dims.x;
-
-                    float kernel = kernelX * kernelY;
-
-                    float valueDistance = ValueDistance(m_data.cells[imageBegin + pixelY * m_data.dims.x + pixelX], centerCell);
-
-                    float b = 0.0f;
-                    if (T::N == 3)
-                        b = valueDistance / (2.0f * m_sigmaValue * m_sigmaValue);
-                    else
-                        b = powf(valueDistance, float(T::N) / 3.0f) / (2.0f * m_sigmaValue * m_sigmaValue);
-                    kernel *= FastExp(-b);
-
-                    m_data.energy[pixelIndex] += kernel;
-                }
-            }
+            for (size_t component = 0; component < T::N; ++component)
+                m_data.cellPlanes[component * m_data.planeStride + index] = m_data.cells[index][int(component)];
         }
+    }
 
-        // Z contributions
+    void RecalculateEnergy(size_t pixelIndex)
+    {
+#if STBN_X86()
+        if (m_soaCells)
         {
-            for (int iz = m_kernelZ.start(); iz < m_kernelZ.end(); ++iz)
-            {
-                if (iz == 0)
-                    continue;
-
-                int pixelZ = ((int)pixelCoords[2] + iz + (int)m_data.dims.z) % (int)m_data.dims.z;
+            RecalculateEnergyAVX2(pixelIndex);
+            return;
+        }
+#endif
 
-                size_t srcPixelIndex = PixelCoords3DToPixelIndex({ pixelCoords[0], pixelCoords[1], (size_t)pixelZ }, m_data.dims);
+        const PixelCoords3D pixelCoords = PixelIndexToPixelCoords3D(pixelIndex, m_data.dims);
 
-                float kernel = m_kernelZ[abs(iz)];
+        const T& centerCell = m_data.cells[pixelIndex];
 
-                float valueDistance = ValueDistance(m_data.cells[srcPixelIndex], centerCell);
+        m_cachedEnergy -= double(m_data.energy[pixelIndex]);
 
-                float b = 0.0f;
-                if (T::N == 3)
-                    b = valueDistance / (2.0f * m_sigmaValue * m_sigmaValue);
-                else
-                    b = powf(valueDistance, float(T::N) / 3.0f) / (2.0f * m_sigmaValue * m_sigmaValue);
-                kernel *= FastExp(-b);
+        m_data.energy[pixelIndex] = 0.0f;
 
-                m_data.energy[pixelIndex] += kernel;
-            }
-        }
+        ForEachNeighbor(pixelIndex, pixelCoords, [&](size_t neighborIndex, float kernel)
+        {
+            m_data.energy[pixelIndex] += kernel * FastExp(-ValueExponent(m_data.cells[neighborIndex], centerCell));
+        });
 
         m_cachedEnergy += double(m_data.energy[pixelIndex]);
     }
@@ -105,6 +93,26 @@ public:
         return (float)m_cachedEnergy;
     }
 
+    // A copy that shares the data, for a thread to swap through on its own. Its energy starts at 0, so
+    // after the thread is done, MergeWorker() adds the energy change it made and puts it back to 0 for the next run.
+    SADataController MakeWorker() const
+    {
+        SADataController ret(*this);
+        ret.m_cachedEnergy = 0.0;
+        return ret;
+    }
+
+    void MergeWorker(SADataController& worker)
+    {
+        m_cachedEnergy += std::exchange(worker.m_cachedEnergy, 0.0);
+    }
+
+    // How far from a swapped pixel, on each axis, SwapDelta() and CommitSwap() read and write
+    Dimensions3D GetKernelReach() const
+    {
+        return { (size_t)std::max(-m_kernelX.start(), m_kernelX.end()), (size_t)std::max(-m_kernelY.start(), m_kernelY.end()), (size_t)std::max(-m_kernelZ.start(), m_kernelZ.end()) };
+    }
+
     void SplatOn(size_t index)
     {
         Splat<true>(index);
@@ -115,8 +123,20 @@ public:
         Splat<false>(index);
     }
 
-    void Swap(size_t indexA, size_t indexB)
+    // Change in Energy() that CommitSwap(indexA, indexB) would make, computed in one read only pass over
+    // each pixel's neighbors. Rejected swaps then cost that pass instead of two full swaps.
+    float SwapDelta(size_t indexA, size_t indexB) const
+    {
+        if (indexA == indexB)
+            return 0.0f;
+        return float(SwapRowDelta(indexA, indexB) + SwapRowDelta(indexB, indexA));
+    }
+
+    void CommitSwap(size_t indexA, size_t indexB)
     {
+        if (indexA == indexB)
+            return;
+
         T A = m_data.cells[indexA];
         T B = m_data.cells[indexB];
         float PDFA = m_data.pdf[indexA];
@@ -127,6 +147,11 @@ public:
 
         m_data.cells[indexA] = B;
         m_data.cells[indexB] = A;
+        if (m_soaCells)
+        {
+            for (size_t component = 0; component < T::N; ++component)
+                std::swap(m_data.cellPlanes[component * m_data.planeStride + indexA], m_data.cellPlanes[component * m_data.planeStride + indexB]);
+        }
 
         m_data.pdf[indexA] = PDFB;
         m_data.pdf[indexB] = PDFA;
@@ -147,77 +172,89 @@ private:
     SymmetricKernel m_kernelX;
     SymmetricKernel m_kernelY;
     SymmetricKernel m_kernelZ;
-    float m_sigmaValue;
+    float m_valueExponentScale;
+    bool m_soaCells;
+    std::shared_ptr<const NeighborTables> m_neighborTables;
 
     double m_cachedEnergy;
 
-    float CalculateB(float valueDistance)
+    // The exponent of the value weight exp(-ValueExponent(a, b)) between two cells
+    float ValueExponent(T a, T b) const
     {
-        float b = 0.0f;
-        if (T::N == 3)
-            b = valueDistance / (2.0f * m_sigmaValue * m_sigmaValue);
-        else
-            b = powf(valueDistance, float(T::N) / 3.0f) / (2.0f * m_sigmaValue * m_sigmaValue);
-        return b;
+        return ValueWeight::Exponent(a, b) * m_valueExponentScale;
     }
 
-    template<bool ON>
-    void SplatXY(const PixelCoords3D& pixelCoords, const T centerCell)
+    // Calls func(neighborIndex, kernel) for each XY and Z neighbor, in the same order as the splats
+    template<typename FUNC>
+    void ForEachNeighbor(size_t pixelIndex, const PixelCoords3D& pixelCoords, FUNC func) const
     {
-        size_t imageBegin = PixelCoords3DToPixelIndex({ 0, 0, pixelCoords[2] }, m_data.dims);
-        for (int iy = m_kernelY.start(); iy < m_kernelY.end(); ++iy)
-        {
-            float kernelY = m_kernelY[abs(iy)];
-            int pixelY = ((int)pixelCoords[1] + iy + (int)m_data.dims.y) % (int)m_data.dims.y;
-            for (int ix = m_kernelX.start(); ix < m_kernelX.end(); ++ix)
-            {
-                if (ix == 0 && iy == 0)
-                    continue;
+        for (const NeighborTables::Neighbor& neighbor : m_neighborTables->GetNeighborsXY(pixelCoords))
+            func(size_t(std::ptrdiff_t(pixelIndex) + neighbor.offset), neighbor.kernel);
 
-                float kernelX = m_kernelX[abs(ix)];
-                int pixelX = (int)(pixelCoords[0] + ix + (int)m_data.dims.x) % (int)m_data.dims.x;
+        ForEachNeighborZ(pixelIndex, pixelCoords, func);
+    }
 
-                float kernel = kernelX * kernelY;
-                if (!ON)
-                    kernel *= -1.0f;
+    template<typename FUNC>
+    void ForEachNeighborZ(size_t pixelIndex, const PixelCoords3D& pixelCoords, FUNC func) const
+    {
+        for (const NeighborTables::Neighbor& neighbor : m_neighborTables->GetNeighborsZ(pixelCoords))
+            func(size_t(std::ptrdiff_t(pixelIndex) + neighbor.offset), neighbor.kernel);
+    }
 
-                float valueDistance = ValueDistance(m_data.cells[imageBegin + pixelY * m_data.dims.x + pixelX], centerCell);
+    // The part of SwapDelta from pixelIndex taking the cell at otherIndex: its splat is taken off and put back on
+    // with the new cell, then its energy is recalculated, which is the new splat again minus what it had stored.
+    // The kernel offsets run from start() up to but not including end(), so a pixel's stored energy isn't quite
+    // its old splat, and both old and new terms are evaluated.
+    // Neighbors that are one of the two swapped pixels (possible with small dims) also had their stored energy
+    // changed by the splats before it is recalculated, which takes that change back out.
+    double SwapRowDelta(size_t pixelIndex, size_t otherIndex) const
+    {
+        const T oldCell = m_data.cells[pixelIndex];
+        const T newCell = m_data.cells[otherIndex];
 
-                float b = CalculateB(valueDistance);
+#if STBN_X86()
+        if (m_soaCells)
+            return SwapRowDeltaAVX2(pixelIndex, otherIndex);
+#endif
 
-                kernel *= FastExp(-b);
+        double delta = -double(m_data.energy[pixelIndex]);
+        ForEachNeighbor(pixelIndex, PixelIndexToPixelCoords3D(pixelIndex, m_data.dims), [&](size_t neighborIndex, float kernel)
+        {
+            delta += SwapNeighborDelta(neighborIndex, kernel, pixelIndex, otherIndex, oldCell, newCell);
+        });
 
-                m_data.energy[imageBegin + pixelY * m_data.dims.x + pixelX] += kernel;
+        return delta;
+    }
 
-                m_cachedEnergy += double(kernel);
-            }
+    // One neighbor's part of SwapRowDelta()
+    double SwapNeighborDelta(size_t neighborIndex, float kernel, size_t pixelIndex, size_t otherIndex, T oldCell, T newCell) const
+    {
+        if (neighborIndex == pixelIndex || neighborIndex == otherIndex)
+        {
+            const T newNeighborCell = (neighborIndex == pixelIndex) ? newCell : oldCell;
+            return double(kernel * FastExp(-ValueExponent(newNeighborCell, newCell)));
         }
+
+        const T neighborCell = m_data.cells[neighborIndex];
+        float oldTerm = kernel * FastExp(-ValueExponent(neighborCell, oldCell));
+        float newTerm = kernel * FastExp(-ValueExponent(neighborCell, newCell));
+        return 2.0 * double(newTerm) - double(oldTerm);
     }
 
     template<bool ON>
-    void SplatZ(const PixelCoords3D& pixelCoords, T centerCell)
+    void SplatNeighbors(size_t pixelIndex, std::span<const NeighborTables::Neighbor> neighbors, const T centerCell)
     {
-        // NOTE! LE not LEQ
-        for (int iz = m_kernelZ.start(); iz < m_kernelZ.end(); ++iz)
+        for (const NeighborTables::Neighbor& neighbor : neighbors)
         {
-            if (iz == 0)
-                continue;
-
-            int pixelZ = ((int)pixelCoords[2] + iz + (int)m_data.dims.z) % (int)m_data.dims.z;
+            size_t neighborIndex = size_t(std::ptrdiff_t(pixelIndex) + neighbor.offset);
 
-            size_t pixelIndex = PixelCoords3DToPixelIndex({ pixelCoords[0], pixelCoords[1], (size_t)pixelZ }, m_data.dims);
-
-            float kernel = m_kernelZ[abs(iz)];
+            float kernel = neighbor.kernel;
             if (!ON)
                 kernel *= -1.0f;
 
-            float valueDistance = ValueDistance(m_data.cells[pixelIndex], centerCell);
-
-            float b = CalculateB(valueDistance);
+            kernel *= FastExp(-ValueExponent(m_data.cells[neighborIndex], centerCell));
 
-            kernel *= FastExp(-b);
-
-            m_data.energy[pixelIndex] += kernel;
+            m_data.energy[neighborIndex] += kernel;
 
             m_cachedEnergy += double(kernel);
         }
@@ -229,7 +266,179 @@ private:
         const PixelCoords3D pixelCoords = PixelIndexToPixelCoords3D(pixelIndex, m_data.dims);
         const T& centerCell = m_data.cells[pixelIndex];
 
-        SplatXY<ON>(pixelCoords, centerCell);
-        SplatZ<ON>(pixelCoords, centerCell);
+#if STBN_X86()
+        if (m_soaCells)
+            SplatXYAVX2<ON>(pixelIndex, pixelCoords, centerCell);
+        else
+#endif
+            SplatNeighbors<ON>(pixelIndex, m_neighborTables->GetNeighborsXY(pixelCoords), centerCell);
+        SplatNeighbors<ON>(pixelIndex, m_neighborTables->GetNeighborsZ(pixelCoords), centerCell);
+    }
+
+#if STBN_X86()
+    // All ones in the first numLanes lanes
+    STBN_TARGET_AVX2 static __m256i LaneMaskAVX2(size_t numLanes)
+    {
+        return _mm256_cmpgt_epi32(_mm256_set1_epi32(int(std::min(numLanes, size_t(8)))), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+    }
+
+    STBN_TARGET_AVX2 static void BroadcastCellAVX2(T cell, __m256 (&cells)[T::N])
+    {
+        for (size_t component = 0; component < T::N; ++component)
+            cells[component] = _mm256_set1_ps(cell[int(component)]);
+    }
+
+    STBN_TARGET_AVX2 void LoadCellsAVX2(size_t index, __m256i mask, __m256 (&cells)[T::N]) const
+    {
+        for (size_t component = 0; component < T::N; ++component)
+            cells[component] = _mm256_maskload_ps(&m_data.cellPlanes[component * m_data.planeStride + index], mask);
+    }
+
+    // kernelX[lane] * kernelY, or 0 in lanes outside mask
+    STBN_TARGET_AVX2 static __m256 LoadKernelAVX2(const float* kernelX, __m256 kernelY, __m256i mask)
+    {
+        return _mm256_and_ps(_mm256_mul_ps(_mm256_loadu_ps(kernelX), kernelY), _mm256_castsi256_ps(mask));
+    }
+
+    // kernel * FastExp(-ValueExponent(neighbor, center)) for 8 neighbors
+    STBN_TARGET_AVX2 __m256 WeightAVX2(const __m256 (&neighbors)[T::N], const __m256 (&center)[T::N], __m256 kernel) const
+    {
+        __m256 exponent = _mm256_mul_ps(ValueWeight::ExponentAVX2(neighbors, center), _mm256_set1_ps(m_valueExponentScale));
+        return _mm256_mul_ps(kernel, FastExpAVX2(_mm256_xor_ps(exponent, _mm256_set1_ps(-0.0f))));
+    }
+
+    STBN_TARGET_AVX2 void RecalculateEnergyAVX2(size_t pixelIndex)
+    {
+        const PixelCoords3D pixelCoords = PixelIndexToPixelCoords3D(pixelIndex, m_data.dims);
+        const T centerCell = m_data.cells[pixelIndex];
+
+        m_cachedEnergy -= double(m_data.energy[pixelIndex]);
+
+        __m256 center[T::N];
+        BroadcastCellAVX2(centerCell, center);
+        __m256 sum = _mm256_setzero_ps();
+
+        const NeighborTables::Runs& runs = m_neighborTables->GetRuns(pixelCoords);
+        for (const NeighborTables::Row& row : m_neighborTables->GetRows(pixelCoords))
+        {
+            __m256 kernelY = _mm256_set1_ps(row.kernelY);
+            size_t rowIndex = size_t(std::ptrdiff_t(pixelIndex) + row.offset);
+            const float* rowKernelX = m_neighborTables->GetRowKernelX(row.center);
+            for (size_t run = 0; run < runs.numRuns; ++run)
+            {
+                for (size_t lane = 0; lane < runs.count[run]; lane += 8)
+                {
+                    __m256i mask = LaneMaskAVX2(runs.count[run] - lane);
+                    __m256 neighbors[T::N];
+                    LoadCellsAVX2(size_t(std::ptrdiff_t(rowIndex) + runs.offset[run]) + lane, mask, neighbors);
+                    sum = _mm256_add_ps(sum, WeightAVX2(neighbors, center, LoadKernelAVX2(rowKernelX + runs.kernelOffset[run] + lane, kernelY, mask)));
+                }
+            }
+        }
+
+        float energy = HorizontalSumAVX2(sum);
+        ForEachNeighborZ(pixelIndex, pixelCoords, [&](size_t neighborIndex, float kernel)
+        {
+            energy += kernel * FastExp(-ValueExponent(m_data.cells[neighborIndex], centerCell));
+        });
+
+        m_data.energy[pixelIndex] = energy;
+        m_cachedEnergy += double(energy);
+    }
+
+    // SwapRowDelta() 8 neighbors at a time. Lanes holding either swapped pixel, which local swap proposals make
+    // common, get a 0 weight and go through SwapNeighborDelta() on their own instead.
+    STBN_TARGET_AVX2 double SwapRowDeltaAVX2(size_t pixelIndex, size_t otherIndex) const
+    {
+        const PixelCoords3D pixelCoords = PixelIndexToPixelCoords3D(pixelIndex, m_data.dims);
+        const T oldCell = m_data.cells[pixelIndex];
+        const T newCell = m_data.cells[otherIndex];
+
+        __m256 oldCenter[T::N];
+        __m256 newCenter[T::N];
+        BroadcastCellAVX2(oldCell, oldCenter);
+        BroadcastCellAVX2(newCell, newCenter);
+        __m256 sum = _mm256_setzero_ps();
+
+        double delta = -double(m_data.energy[pixelIndex]);
+
+        const size_t swappedIndices[2] = { pixelIndex, otherIndex };
+        const __m256i laneIds = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+
+        const NeighborTables::Runs& runs = m_neighborTables->GetRuns(pixelCoords);
+        for (const NeighborTables::Row& row : m_neighborTables->GetRows(pixelCoords))
+        {
+            __m256 kernelY = _mm256_set1_ps(row.kernelY);
+            size_t rowIndex = size_t(std::ptrdiff_t(pixelIndex) + row.offset);
+            const float* rowKernelX = m_neighborTables->GetRowKernelX(row.center);
+            for (size_t run = 0; run < runs.numRuns; ++run)
+            {
+                size_t runBegin = size_t(std::ptrdiff_t(rowIndex) + runs.offset[run]);
+                const float* runKernelX = rowKernelX + runs.kernelOffset[run];
+                for (size_t lane = 0; lane < runs.count[run]; lane += 8)
+                {
+                    size_t chunkBegin = runBegin + lane;
+                    size_t chunkEnd = chunkBegin + std::min(runs.count[run] - lane, size_t(8));
+                    __m256i mask = LaneMaskAVX2(runs.count[run] - lane);
+                    __m256i kernelMask = mask;
+                    for (size_t swappedIndex : swappedIndices)
+                    {
+                        if (swappedIndex < chunkBegin || swappedIndex >= chunkEnd)
+                            continue;
+
+                        size_t swappedLane = swappedIndex - chunkBegin;
+                        kernelMask = _mm256_andnot_si256(_mm256_cmpeq_epi32(_mm256_set1_epi32(int(swappedLane)), laneIds), kernelMask);
+                        delta += SwapNeighborDelta(swappedIndex, runKernelX[lane + swappedLane] * row.kernelY, pixelIndex, otherIndex, oldCell, newCell);
+                    }
+
+                    __m256 neighbors[T::N];
+                    LoadCellsAVX2(chunkBegin, mask, neighbors);
+                    __m256 kernel = LoadKernelAVX2(runKernelX + lane, kernelY, kernelMask);
+                    __m256 oldTerm = WeightAVX2(neighbors, oldCenter, kernel);
+                    __m256 newTerm = WeightAVX2(neighbors, newCenter, kernel);
+                    sum = _mm256_add_ps(sum, _mm256_sub_ps(_mm256_add_ps(newTerm, newTerm), oldTerm));
+                }
+            }
+        }
+        delta += double(HorizontalSumAVX2(sum));
+
+        ForEachNeighborZ(pixelIndex, pixelCoords, [&](size_t neighborIndex, float kernel)
+        {
+            delta += SwapNeighborDelta(neighborIndex, kernel, pixelIndex, otherIndex, oldCell, newCell);
+        });
+
+        return delta;
+    }
+
+    template<bool ON>
+    STBN_TARGET_AVX2 void SplatXYAVX2(size_t pixelIndex, const PixelCoords3D& pixelCoords, const T centerCell)
+    {
+        __m256 center[T::N];
+        BroadcastCellAVX2(centerCell, center);
+        __m256 sum = _mm256_setzero_ps();
+
+        const NeighborTables::Runs& runs = m_neighborTables->GetRuns(pixelCoords);
+        for (const NeighborTables::Row& row : m_neighborTables->GetRows(pixelCoords))
+        {
+            __m256 kernelY = _mm256_set1_ps(ON ? row.kernelY : -row.kernelY);
+            size_t rowIndex = size_t(std::ptrdiff_t(pixelIndex) + row.offset);
+            const float* rowKernelX = m_neighborTables->GetRowKernelX(row.center);
+            for (size_t run = 0; run < runs.numRuns; ++run)
+            {
+                for (size_t lane = 0; lane < runs.count[run]; lane += 8)
+                {
+                    size_t index = size_t(std::ptrdiff_t(rowIndex) + runs.offset[run]) + lane;
+                    __m256i mask = LaneMaskAVX2(runs.count[run] - lane);
+                    __m256 neighbors[T::N];
+                    LoadCellsAVX2(index, mask, neighbors);
+                    __m256 term = WeightAVX2(neighbors, center, LoadKernelAVX2(rowKernelX + runs.kernelOffset[run] + lane, kernelY, mask));
+                    _mm256_maskstore_ps(&m_data.energy[index], mask, _mm256_add_ps(_mm256_maskload_ps(&m_data.energy[index], mask), term));
+                    sum = _mm256_add_ps(sum, term);
+                }
+            }
+        }
+
+        m_cachedEnergy += double(HorizontalSumAVX2(sum));
     }
+#endif
 };
@@ -10,10 +10,59 @@
 
 #pragma once
 
+#include <cstddef>
+
+enum class SAStopReason
+{
+    Running,
+    // Ran all totalSwaps swaps
+    SwapBudget,
+    // The energy stopped improving before the budget was used up (CoolingScheduleParams::earlyStop)
+    Converged
+};
+
+inline const char* SAStopReasonToString(SAStopReason stopReason)
+{
+    switch (stopReason)
+    {
+        case SAStopReason::Running: return "running";
+        case SAStopReason::SwapBudget: return "swap budget used up";
+        case SAStopReason::Converged: return "converged";
+    }
+    return "";
+}
+
+// Where B of a swap proposal was drawn from, see SwapProposalParams
+enum class SwapProposalType
+{
+    Global,
+    Spatial,
+    Column,
+    Count
+};
+
+inline const char* SwapProposalTypeToString(SwapProposalType type)
+{
+    switch (type)
+    {
+        case SwapProposalType::Global: return "global";
+        case SwapProposalType::Spatial: return "spatial";
+        case SwapProposalType::Column: return "column";
+        case SwapProposalType::Count: break;
+    }
+    return "";
+}
+
 struct SAProgressData
 {
     float energy;
     size_t swapIndex;
     const size_t totalSwaps;
     float temperature;
+    // Fraction of swaps accepted in the last complete window (see CoolingScheduleParams)
+    float acceptanceRate;
+    SAStopReason stopReason;
+    // Swaps proposed and accepted so far, by SwapProposalType. RunCheckerboard() doesn't count them, and parallel tempering sums them over its replicas.
+    size_t numProposed[size_t(SwapProposalType::Count)];
+    size_t numAccepted[size_t(SwapProposalType::Count)];
 };
\ No newline at end of file
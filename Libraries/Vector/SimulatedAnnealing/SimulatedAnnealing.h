@@ -11,10 +11,18 @@
 #pragma once
 
 #include <algorithm>
+#include <barrier>
+#include <cmath>
+#include <thread>
+#include <utility>
+#include <vector>
 
+#include "SimulatedAnnealing/CheckerboardTiles.h"
+#include "SimulatedAnnealing/CoolingSchedule.h"
 #include "SimulatedAnnealing/SAData.h"
 #include "SimulatedAnnealing/SADataController.h"
 #include "SimulatedAnnealing/SAProgressData.h"
+#include "SimulatedAnnealing/SwapProposals.h"
 #include "Utils/Dimensions3D.h"
 
 #include "STBNMath.h"
@@ -24,16 +32,18 @@
 
 #include "SAProgressData.h"
 
-template<typename T, float(*ValueDistance)(T, T)>
+template<typename T, typename ValueWeight>
 class SimulatedAnnealing
 {
 public:
-	SimulatedAnnealing(const Dimensions3D& dims, SADataController<T, ValueDistance>& controller, float swapCountFactor, float coolingFactor) :
+	SimulatedAnnealing(const Dimensions3D& dims, SADataController<T, ValueWeight>& controller, float swapCountFactor, float coolingFactor, const CoolingScheduleParams& scheduleParams = CoolingScheduleParams(), const SwapProposalParams& proposalParams = SwapProposalParams()) :
         m_dims(dims),
         m_numPixels(m_dims.x * m_dims.y * m_dims.z),
         m_controller(controller),
         m_coolingRate(1.0f / (coolingFactor * float(m_dims.NumPixels()) * float(m_dims.NumPixels()))),
         m_numSwaps(std::max(size_t(swapCountFactor * float(m_dims.NumPixels())* float(m_dims.NumPixels())), size_t(1))),
+        m_schedule(scheduleParams, m_coolingRate, m_numPixels),
+        m_proposals(dims, proposalParams),
         m_pd({0.0f, 0, m_numSwaps, 0.0f})
     {
         
@@ -44,6 +54,11 @@ public:
         return m_pd;
     }
 
+    const SAProgressData& GetProgressData() const
+    {
+        return m_pd;
+    }
+
     float GetCoolingRate() const
     {
         return m_coolingRate;
@@ -64,28 +79,238 @@ public:
         return m_numSwaps;
     }
 
+    // Runs until GetProgressData().stopReason says why it stopped: the swap budget is used up, or the cooling
+    // schedule's early stop found the energy no longer improving
     void Run(pcg32_random_t& rng)
+    {
+        Start();
+        while (m_pd.stopReason == SAStopReason::Running)
+        {
+            m_schedule.Cool(m_pd, 1);
+            bool accepted = PerformSwapIteration<false>(rng);
+            m_schedule.Observe(m_pd, 1, accepted ? 1 : 0);
+        }
+    }
+
+    // Run() on numThreads threads. Each sweep shifts a CheckerboardTiles grid to a random offset, then goes through
+    // the colors, with every tile of a color taking a share of the sweep's swaps at once. Both pixels of a swap are
+    // in the same tile, which keeps them local already, so SwapProposalParams don't apply. Temperature and progress
+    // are updated between colors. The threads and their workers are made once and meet at a barrier per color.
+    void RunCheckerboard(pcg32_random_t& rng, size_t numThreads)
+    {
+        Start();
+
+        CheckerboardTiles tiles(m_dims, m_controller.GetKernelReach());
+        std::vector<pcg32_random_t> threadRNGs(numThreads);
+        for (size_t threadIndex = 0; threadIndex < numThreads; ++threadIndex)
+            pcg32_srandom_r(&threadRNGs[threadIndex], pcg32_random_r(&rng), threadIndex);
+
+        std::vector<SADataController<T, ValueWeight>> workers(numThreads, m_controller.MakeWorker());
+        std::vector<size_t> workerSwaps(numThreads, 0);
+        std::vector<size_t> workerAccepted(numThreads, 0);
+        const std::vector<size_t>* colorTiles = nullptr;
+        size_t sweepSwaps = 0;
+        bool done = false;
+
+        std::barrier sync((std::ptrdiff_t)numThreads);
+        auto runTiles = [&](size_t threadIndex)
+        {
+            RunCheckerboardTiles(tiles, *colorTiles, threadIndex, numThreads, sweepSwaps, workers[threadIndex], threadRNGs[threadIndex], workerSwaps[threadIndex], workerAccepted[threadIndex]);
+        };
+
+        std::vector<std::thread> threads;
+        for (size_t threadIndex = 1; threadIndex < numThreads; ++threadIndex)
+        {
+            threads.emplace_back([&, threadIndex]()
+            {
+                while (true)
+                {
+                    sync.arrive_and_wait();
+                    if (done)
+                        return;
+                    runTiles(threadIndex);
+                    sync.arrive_and_wait();
+                }
+            });
+        }
+
+        while (m_pd.stopReason == SAStopReason::Running)
+        {
+            tiles.SetOffset({ pcg32_boundedrand_r(&rng, (uint32_t)m_dims.x), pcg32_boundedrand_r(&rng, (uint32_t)m_dims.y), pcg32_boundedrand_r(&rng, (uint32_t)m_dims.z) });
+            sweepSwaps = std::min(m_numSwaps - m_pd.swapIndex, m_numPixels);
+            for (size_t color = 0; color < tiles.NumColors() && m_pd.stopReason == SAStopReason::Running; ++color)
+            {
+                colorTiles = &tiles.GetTilesOfColor(color);
+
+                sync.arrive_and_wait();
+                runTiles(0);
+                sync.arrive_and_wait();
+
+                size_t colorSwaps = 0;
+                size_t colorAccepted = 0;
+                for (size_t threadIndex = 0; threadIndex < numThreads; ++threadIndex)
+                {
+                    m_controller.MergeWorker(workers[threadIndex]);
+                    colorSwaps += std::exchange(workerSwaps[threadIndex], 0);
+                    colorAccepted += std::exchange(workerAccepted[threadIndex], 0);
+                }
+
+                m_pd.energy = m_controller.Energy();
+                m_schedule.Cool(m_pd, colorSwaps);
+                m_pd.swapIndex = std::min(m_pd.swapIndex + colorSwaps, m_numSwaps);
+                m_schedule.Observe(m_pd, colorSwaps, colorAccepted);
+            }
+        }
+
+        done = true;
+        sync.arrive_and_wait();
+        for (std::thread& thread : threads)
+            thread.join();
+    }
+
+    // Run() with numThreads threads evaluating upcoming proposals at once, giving exactly the same result.
+    // Late in the schedule nearly every proposal is rejected and changes nothing, so a batch of proposals is drawn
+    // ahead from a copy of the RNG, as if all of them were rejected, and their SwapDelta()s are worked out in
+    // parallel against the same state. Going through them in order, the first one accepted is committed and the
+    // rest are thrown away, and the RNG is put back to where the single chain would have it after that proposal.
+    // The batch grows while proposals keep getting rejected, and shrinks back when they don't.
+    void RunSpeculative(pcg32_random_t& rng, size_t numThreads)
+    {
+        Start();
+
+        const size_t maxBatchSize = numThreads * c_maxSpeculativeProposalsPerThread;
+        std::vector<SpeculativeProposal> proposals(maxBatchSize);
+        size_t batchSize = numThreads;
+        bool done = false;
+
+        std::barrier sync((std::ptrdiff_t)numThreads);
+        auto evaluate = [&](size_t threadIndex)
+        {
+            for (size_t index = threadIndex; index < batchSize; index += numThreads)
+                proposals[index].swapDelta = m_controller.SwapDelta(proposals[index].indexA, proposals[index].indexB);
+        };
+
+        std::vector<std::thread> threads;
+        for (size_t threadIndex = 1; threadIndex < numThreads; ++threadIndex)
+        {
+            threads.emplace_back([&, threadIndex]()
+            {
+                while (true)
+                {
+                    sync.arrive_and_wait();
+                    if (done)
+                        return;
+                    evaluate(threadIndex);
+                    sync.arrive_and_wait();
+                }
+            });
+        }
+
+        size_t targetBatchSize = numThreads;
+        while (m_pd.stopReason == SAStopReason::Running)
+        {
+            batchSize = std::min(targetBatchSize, m_numSwaps - m_pd.swapIndex);
+
+            pcg32_random_t speculativeRNG = rng;
+            for (size_t index = 0; index < batchSize; ++index)
+            {
+                SpeculativeProposal& proposal = proposals[index];
+                proposal.type = m_proposals.Propose(speculativeRNG, proposal.indexA, proposal.indexB);
+                proposal.rngAfterIndices = speculativeRNG;
+                proposal.random01 = RandomFloat01(speculativeRNG);
+                proposal.rngAfterRandom = speculativeRNG;
+            }
+            rng = speculativeRNG;
+
+            sync.arrive_and_wait();
+            evaluate(0);
+            sync.arrive_and_wait();
+
+            size_t numUsed = batchSize;
+            bool accepted = false;
+            for (size_t index = 0; index < batchSize; ++index)
+            {
+                const SpeculativeProposal& proposal = proposals[index];
+                m_schedule.Cool(m_pd, 1);
+                m_pd.swapIndex++;
+
+                // Same test as PerformSwapIteration, which only draws random01 for a swap that raises the energy
+                bool downhill = proposal.swapDelta <= 0.0f;
+                accepted = downhill || proposal.random01 < m_pd.temperature;
+                CountProposal(proposal.type, accepted);
+                if (accepted)
+                {
+                    m_controller.CommitSwap(proposal.indexA, proposal.indexB);
+                    m_pd.energy = m_controller.Energy();
+                }
+                m_schedule.Observe(m_pd, 1, accepted ? 1 : 0);
+
+                // The schedule may also stop the run on a rejected proposal, which drew random01
+                if (accepted || m_pd.stopReason != SAStopReason::Running)
+                {
+                    rng = (accepted && downhill) ? proposal.rngAfterIndices : proposal.rngAfterRandom;
+                    numUsed = index + 1;
+                    break;
+                }
+            }
+
+            targetBatchSize = std::clamp(2 * (accepted ? numUsed : batchSize), numThreads, maxBatchSize);
+        }
+
+        done = true;
+        sync.arrive_and_wait();
+        for (std::thread& thread : threads)
+            thread.join();
+    }
+
+    // For running the chain in pieces, like parallel tempering does: Start() once, then any number of
+    // RunAtTemperature() calls. These hold the temperature instead of cooling it, and take a swap that raises
+    // the energy by delta with the Metropolis chance exp(-delta / temperature), so temperature is in energy units.
+    void Start()
     {
         PerformInitialSplats();
         InitializeIterationState();
-        while (m_pd.swapIndex < m_numSwaps)
+    }
+
+    void RunAtTemperature(pcg32_random_t& rng, float temperature, size_t numSwaps)
+    {
+        m_pd.temperature = temperature;
+        size_t endSwapIndex = std::min(m_pd.swapIndex + numSwaps, m_numSwaps);
+        while (m_pd.swapIndex < endSwapIndex)
         {
-            PerformSwapIteration(rng);
+            PerformSwapIteration<true>(rng);
         }
     }
 
 private:
     const Dimensions3D m_dims;
     const size_t m_numPixels;
-    SADataController<T, ValueDistance>& m_controller;
+    SADataController<T, ValueWeight>& m_controller;
 
     float m_coolingRate;
     size_t m_numSwaps;
+    CoolingSchedule m_schedule;
+    SwapProposals m_proposals;
 
     SAProgressData m_pd;
 
+    static const size_t c_maxSpeculativeProposalsPerThread = 64;
+
+    struct SpeculativeProposal
+    {
+        uint32_t indexA;
+        uint32_t indexB;
+        SwapProposalType type;
+        float random01;
+        float swapDelta;
+        // Where the RNG would be after drawing the indices, and after drawing random01 too
+        pcg32_random_t rngAfterIndices;
+        pcg32_random_t rngAfterRandom;
+    };
+
     void PerformInitialSplats()
     {
+        m_controller.SyncCellPlanes();
         for (size_t index = 0; index < GetNumPixels(); ++index)
         {
             m_controller.SplatOn(index);
@@ -95,28 +320,68 @@ private:
     void InitializeIterationState()
     {
         m_pd.energy = m_controller.Energy();
-        m_pd.temperature = 1.0f;
         m_pd.swapIndex = 0;
+        std::fill(std::begin(m_pd.numProposed), std::end(m_pd.numProposed), size_t(0));
+        std::fill(std::begin(m_pd.numAccepted), std::end(m_pd.numAccepted), size_t(0));
+        m_schedule.Start(m_pd);
     }
 
-    void PerformSwapIteration(pcg32_random_t& rng)
+    void CountProposal(SwapProposalType type, bool accepted)
     {
-        m_pd.temperature = std::max(m_pd.temperature - m_coolingRate, 0.0f);
-
-        uint32_t indexA = pcg32_boundedrand_r(&rng, (uint32_t)GetNumPixels());
-        uint32_t indexB = pcg32_boundedrand_r(&rng, (uint32_t)GetNumPixels());
-        m_controller.Swap(indexA, indexB);
+        m_pd.numProposed[size_t(type)]++;
+        if (accepted)
+            m_pd.numAccepted[size_t(type)]++;
+    }
 
-        float swapEnergy = m_controller.Energy();
-        if (swapEnergy <= m_pd.energy || RandomFloat01(rng) < m_pd.temperature)
+    // Thread threadIndex's share of a color: every numThreads'th tile of it
+    void RunCheckerboardTiles(const CheckerboardTiles& tiles, const std::vector<size_t>& colorTiles, size_t threadIndex, size_t numThreads, size_t sweepSwaps, SADataController<T, ValueWeight>& worker, pcg32_random_t& rng, size_t& numSwaps, size_t& numAccepted)
+    {
+        for (size_t tileIndex = threadIndex; tileIndex < colorTiles.size(); tileIndex += numThreads)
         {
-            m_pd.energy = swapEnergy;
+            size_t tile = colorTiles[tileIndex];
+            size_t tileSwaps = std::max(sweepSwaps * tiles.TileNumPixels(tile) / m_numPixels, size_t(1));
+            for (size_t swap = 0; swap < tileSwaps; ++swap)
+            {
+                size_t indexA = tiles.RandomPixelInTile(tile, rng);
+                size_t indexB = tiles.RandomPixelInTile(tile, rng);
+                float swapDelta = worker.SwapDelta(indexA, indexB);
+                if (swapDelta <= 0.0f || AcceptUphillSwap<false>(rng, swapDelta))
+                {
+                    worker.CommitSwap(indexA, indexB);
+                    numAccepted++;
+                }
+            }
+            numSwaps += tileSwaps;
         }
-        else
+    }
+
+    template<bool METROPOLIS>
+    bool AcceptUphillSwap(pcg32_random_t& rng, float swapDelta)
+    {
+        if (!METROPOLIS)
+            return RandomFloat01(rng) < m_pd.temperature;
+        return m_pd.temperature > 0.0f && RandomFloat01(rng) < std::exp(-swapDelta / m_pd.temperature);
+    }
+
+    // Returns whether the swap was taken
+    template<bool METROPOLIS>
+    bool PerformSwapIteration(pcg32_random_t& rng)
+    {
+        uint32_t indexA;
+        uint32_t indexB;
+        SwapProposalType type = m_proposals.Propose(rng, indexA, indexB);
+
+        // Rejected swaps, which are most of them late in the schedule, never touch the data
+        float swapDelta = m_controller.SwapDelta(indexA, indexB);
+        bool accepted = swapDelta <= 0.0f || AcceptUphillSwap<METROPOLIS>(rng, swapDelta);
+        CountProposal(type, accepted);
+        if (accepted)
         {
-            m_controller.Swap(indexA, indexB);
+            m_controller.CommitSwap(indexA, indexB);
+            m_pd.energy = m_controller.Energy();
         }
 
         m_pd.swapIndex++;
+        return accepted;
     }
 };
@@ -0,0 +1,94 @@
+/*
+* Copyright (c) 2024, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#include "SimulatedAnnealing/SwapProposals.h"
+
+#include <algorithm>
+
+#include "STBNRandom.h"
+#include "Utils/PixelCoords3D.h"
+
+// The largest radius whose window doesn't wrap around onto itself
+static uint32_t WindowRadius(size_t radius, size_t dim)
+{
+    return uint32_t(std::min(radius, (dim - 1) / 2));
+}
+
+// coord + offset - radius, wrapped around dim
+static size_t WrapOffset(size_t coord, uint32_t offset, uint32_t radius, size_t dim)
+{
+    return (coord + dim + offset - radius) % dim;
+}
+
+SwapProposals::SwapProposals(const Dimensions3D& dims, const SwapProposalParams& params) :
+    m_dims(dims),
+    m_numPixels(uint32_t(dims.NumPixels())),
+    m_spatialRadiusX(WindowRadius(params.spatialRadius, dims.x)),
+    m_spatialRadiusY(WindowRadius(params.spatialRadius, dims.y)),
+    m_columnRadius(WindowRadius(params.columnRadius, dims.z))
+{
+    // A window with nothing in it but A leaves those proposals global
+    float spatialFraction = (m_spatialRadiusX > 0 || m_spatialRadiusY > 0) ? std::clamp(params.spatialFraction, 0.0f, 1.0f) : 0.0f;
+    float columnFraction = (m_columnRadius > 0) ? std::clamp(params.columnFraction, 0.0f, 1.0f) : 0.0f;
+    m_spatialEnd = spatialFraction;
+    m_columnEnd = std::min(spatialFraction + columnFraction, 1.0f);
+}
+
+SwapProposalType SwapProposals::Propose(pcg32_random_t& rng, uint32_t& indexA, uint32_t& indexB) const
+{
+    indexA = pcg32_boundedrand_r(&rng, m_numPixels);
+
+    SwapProposalType type = SwapProposalType::Global;
+    if (m_columnEnd > 0.0f)
+    {
+        float choice = RandomFloat01(rng);
+        if (choice < m_spatialEnd)
+            type = SwapProposalType::Spatial;
+        else if (choice < m_columnEnd)
+            type = SwapProposalType::Column;
+    }
+
+    switch (type)
+    {
+        case SwapProposalType::Spatial:
+        {
+            // Any offset in the window but the center
+            uint32_t width = 2 * m_spatialRadiusX + 1;
+            uint32_t height = 2 * m_spatialRadiusY + 1;
+            uint32_t center = m_spatialRadiusY * width + m_spatialRadiusX;
+            uint32_t offset = pcg32_boundedrand_r(&rng, width * height - 1);
+            if (offset >= center)
+                offset++;
+
+            PixelCoords3D coords = PixelIndexToPixelCoords3D(indexA, m_dims);
+            coords.x = WrapOffset(coords.x, offset % width, m_spatialRadiusX, m_dims.x);
+            coords.y = WrapOffset(coords.y, offset / width, m_spatialRadiusY, m_dims.y);
+            indexB = uint32_t(PixelCoords3DToPixelIndex(coords, m_dims));
+            break;
+        }
+        case SwapProposalType::Column:
+        {
+            uint32_t offset = pcg32_boundedrand_r(&rng, 2 * m_columnRadius);
+            if (offset >= m_columnRadius)
+                offset++;
+
+            PixelCoords3D coords = PixelIndexToPixelCoords3D(indexA, m_dims);
+            coords.z = WrapOffset(coords.z, offset, m_columnRadius, m_dims.z);
+            indexB = uint32_t(PixelCoords3DToPixelIndex(coords, m_dims));
+            break;
+        }
+        default:
+        {
+            indexB = pcg32_boundedrand_r(&rng, m_numPixels);
+            break;
+        }
+    }
+    return type;
+}
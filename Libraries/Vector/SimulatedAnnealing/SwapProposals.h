@@ -0,0 +1,53 @@
+/*
+* Copyright (c) 2024, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#pragma once
+
+#include <cstdint>
+
+#include "SimulatedAnnealing/SAProgressData.h"
+#include "Utils/Dimensions3D.h"
+
+#include "pcg_basic.h"
+
+struct SwapProposalParams
+{
+    // Fractions of proposals that draw B from a window around A: within the same XY slice, or along A's Z column.
+    // The rest draw B from the whole texture.
+    float spatialFraction = 0.0f;
+    float columnFraction = 0.0f;
+    // How far B can be from A on each axis of the window, wrapping around. Limited to what fits in the dimensions.
+    size_t spatialRadius = 4;
+    size_t columnRadius = 4;
+};
+
+// Draws the pairs of pixels SimulatedAnnealing tries to swap.
+// Far apart pixels are slower to evaluate, since neither neighborhood is in cache, and late in the schedule they
+// are nearly always rejected. Swapping nearby pixels is both cheaper and more likely to be taken.
+class SwapProposals
+{
+public:
+    SwapProposals(const Dimensions3D& dims, const SwapProposalParams& params);
+
+    // With only global proposals, this draws exactly what two pcg32_boundedrand_r() calls over all pixels would
+    SwapProposalType Propose(pcg32_random_t& rng, uint32_t& indexA, uint32_t& indexB) const;
+
+private:
+    Dimensions3D m_dims;
+    uint32_t m_numPixels;
+
+    // Proposals with RandomFloat01() below m_spatialEnd are spatial, then below m_columnEnd are column ones
+    float m_spatialEnd;
+    float m_columnEnd;
+
+    uint32_t m_spatialRadiusX;
+    uint32_t m_spatialRadiusY;
+    uint32_t m_columnRadius;
+};
@@ -0,0 +1,161 @@
+/*
+* Copyright (c) 2024, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+
+#include "Types/Float.h"
+#include "Types/Float2.h"
+#include "Types/Float3.h"
+#include "ValueDistanceFunctions/FloatValueDistanceFunctions.h"
+#include "ValueDistanceFunctions/Float2ValueDistanceFunctions.h"
+#include "ValueDistanceFunctions/Float3ValueDistanceFunctions.h"
+#include "STBNMath.h"
+#include "STBNMathAVX2.h"
+
+// Value distance policies for SADataController, one per value distance function.
+// Exponent(a, b) is ValueDistance(a, b)^(N/3), the value part of the energy weight's exponent before it's scaled
+// by 1 / (2 sigma^2). It's written out per type so that there's no powf(): N/3 is 1 for Float3, and a cube root
+// otherwise (FastCbrt()), which also absorbs the square root of L2 for Float2.
+// ExponentAVX2(a, b) is Exponent() for 8 pairs of cells at once, with the cells split into one vector per component.
+// Distance(a, b) is the plain value distance function, for anything that wants the distance itself.
+
+struct AbsDistanceWeight
+{
+    static float Distance(Float a, Float b) { return AbsDistance(a, b); }
+
+    static float Exponent(Float a, Float b)
+    {
+        return FastCbrt(std::fabs(a.x - b.x));
+    }
+
+#if STBN_X86()
+    STBN_TARGET_AVX2 static __m256 ExponentAVX2(const __m256 (&a)[1], const __m256 (&b)[1])
+    {
+        return FastCbrtAVX2(AbsAVX2(_mm256_sub_ps(a[0], b[0])));
+    }
+#endif
+};
+
+struct L1Weight
+{
+    static float Distance(Float2 a, Float2 b) { return L1(a, b); }
+    static float Distance(Float3 a, Float3 b) { return L1(a, b); }
+
+    static float Exponent(Float2 a, Float2 b)
+    {
+        float distance = std::fabs(a.x - b.x) + std::fabs(a.y - b.y);
+        return FastCbrt(distance * distance);
+    }
+
+    static float Exponent(Float3 a, Float3 b)
+    {
+        return std::fabs(a.x - b.x) + std::fabs(a.y - b.y) + std::fabs(a.z - b.z);
+    }
+
+#if STBN_X86()
+    STBN_TARGET_AVX2 static __m256 ExponentAVX2(const __m256 (&a)[2], const __m256 (&b)[2])
+    {
+        __m256 distance = _mm256_add_ps(AbsAVX2(_mm256_sub_ps(a[0], b[0])), AbsAVX2(_mm256_sub_ps(a[1], b[1])));
+        return FastCbrtAVX2(_mm256_mul_ps(distance, distance));
+    }
+
+    STBN_TARGET_AVX2 static __m256 ExponentAVX2(const __m256 (&a)[3], const __m256 (&b)[3])
+    {
+        __m256 distance = _mm256_add_ps(AbsAVX2(_mm256_sub_ps(a[0], b[0])), AbsAVX2(_mm256_sub_ps(a[1], b[1])));
+        return _mm256_add_ps(distance, AbsAVX2(_mm256_sub_ps(a[2], b[2])));
+    }
+#endif
+};
+
+struct L2Weight
+{
+    static float Distance(Float2 a, Float2 b) { return L2(a, b); }
+    static float Distance(Float3 a, Float3 b) { return L2(a, b); }
+
+    // sqrt(d^2)^(2/3) is cbrt(d^2)
+    static float Exponent(Float2 a, Float2 b)
+    {
+        return FastCbrt((a.x - b.x) * (a.x - b.x) + (a.y - b.y) * (a.y - b.y));
+    }
+
+    static float Exponent(Float3 a, Float3 b)
+    {
+        return std::sqrt((a.x - b.x) * (a.x - b.x) + (a.y - b.y) * (a.y - b.y) + (a.z - b.z) * (a.z - b.z));
+    }
+
+#if STBN_X86()
+    STBN_TARGET_AVX2 static __m256 ExponentAVX2(const __m256 (&a)[2], const __m256 (&b)[2])
+    {
+        __m256 dx = _mm256_sub_ps(a[0], b[0]);
+        __m256 dy = _mm256_sub_ps(a[1], b[1]);
+        return FastCbrtAVX2(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)));
+    }
+
+    STBN_TARGET_AVX2 static __m256 ExponentAVX2(const __m256 (&a)[3], const __m256 (&b)[3])
+    {
+        __m256 dx = _mm256_sub_ps(a[0], b[0]);
+        __m256 dy = _mm256_sub_ps(a[1], b[1]);
+        __m256 dz = _mm256_sub_ps(a[2], b[2]);
+        return _mm256_sqrt_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)), _mm256_mul_ps(dz, dz)));
+    }
+#endif
+};
+
+struct LInfinityWeight
+{
+    static float Distance(Float2 a, Float2 b) { return LInfinity(a, b); }
+    static float Distance(Float3 a, Float3 b) { return LInfinity(a, b); }
+
+    static float Exponent(Float2 a, Float2 b)
+    {
+        float distance = std::max(std::fabs(a.x - b.x), std::fabs(a.y - b.y));
+        return FastCbrt(distance * distance);
+    }
+
+    static float Exponent(Float3 a, Float3 b)
+    {
+        return std::max(std::fabs(a.x - b.x), std::max(std::fabs(a.y - b.y), std::fabs(a.z - b.z)));
+    }
+
+#if STBN_X86()
+    STBN_TARGET_AVX2 static __m256 ExponentAVX2(const __m256 (&a)[2], const __m256 (&b)[2])
+    {
+        __m256 distance = _mm256_max_ps(AbsAVX2(_mm256_sub_ps(a[0], b[0])), AbsAVX2(_mm256_sub_ps(a[1], b[1])));
+        return FastCbrtAVX2(_mm256_mul_ps(distance, distance));
+    }
+
+    STBN_TARGET_AVX2 static __m256 ExponentAVX2(const __m256 (&a)[3], const __m256 (&b)[3])
+    {
+        __m256 distanceYZ = _mm256_max_ps(AbsAVX2(_mm256_sub_ps(a[1], b[1])), AbsAVX2(_mm256_sub_ps(a[2], b[2])));
+        return _mm256_max_ps(AbsAVX2(_mm256_sub_ps(a[0], b[0])), distanceYZ);
+    }
+#endif
+};
+
+struct NegativeDotWeight
+{
+    static float Distance(Float3 a, Float3 b) { return NegativeDot(a, b); }
+
+    static float Exponent(Float3 a, Float3 b)
+    {
+        return -(a.x * b.x) + (a.y * b.y) + (a.z * b.z);
+    }
+
+#if STBN_X86()
+    STBN_TARGET_AVX2 static __m256 ExponentAVX2(const __m256 (&a)[3], const __m256 (&b)[3])
+    {
+        __m256 x = _mm256_xor_ps(_mm256_mul_ps(a[0], b[0]), _mm256_set1_ps(-0.0f));
+        return _mm256_add_ps(_mm256_add_ps(x, _mm256_mul_ps(a[1], b[1])), _mm256_mul_ps(a[2], b[2]));
+    }
+#endif
+};
@@ -12,6 +12,8 @@
 
 #include <string>
 
+#include "SimulatedAnnealing/CoolingSchedule.h"
+#include "SimulatedAnnealing/SwapProposals.h"
 #include "Utils/Dimensions3D.h"
 
 struct VectorSTBNArgs
@@ -19,8 +21,21 @@ struct VectorSTBNArgs
     Dimensions3D dimensions = { 0, 0, 0 };
     float coolingFactor = 0.0f;
     float swapCountFactor = 0.0f;
+    // How temperature falls, and when to stop before swapCountFactor's budget is used up
+    CoolingScheduleParams coolingSchedule;
+    // Mix of global and local swap proposals
+    SwapProposalParams swapProposals;
     float energySigma = 0.0f;
     float valueSigma = 0.0f;
+    // More than 1 runs simulated annealing on checkerboard tiles on this many threads
+    size_t numThreads = 1;
+    // More than 1 evaluates upcoming swaps on this many threads, with the same results as the single chain
+    size_t numSpeculativeThreads = 1;
+    // More than 1 runs parallel tempering with this many replicas instead of a single annealing chain
+    size_t numReplicas = 1;
+    float maxReplicaTemperature = 0.0f;
+    // Mirror the cells into structure of arrays planes and evaluate neighborhoods with AVX2, when the CPU has it
+    bool soaCells = false;
     std::string baseOutputFilePath;
     std::string baseOutputFileName;
     std::string importanceMapPath;
@@ -22,9 +22,7 @@
 #include "Types/Float.h"
 #include "Types/Float2.h"
 #include "Types/Float3.h"
-#include "ValueDistanceFunctions/FloatValueDistanceFunctions.h"
-#include "ValueDistanceFunctions/Float2ValueDistanceFunctions.h"
-#include "ValueDistanceFunctions/Float3ValueDistanceFunctions.h"
+#include "ValueDistanceFunctions/ValueWeightPolicies.h"
 
 
 VectorSTBNImplSelector::VectorSTBNImplSelector(const VectorSTBNTypeArgs& typeArgs, const VectorSTBNArgs& args) :
@@ -34,34 +32,34 @@ VectorSTBNImplSelector::VectorSTBNImplSelector(const VectorSTBNTypeArgs& typeArg
 
 }
 
-template<float(*ValueDistanceFunction)(Float, Float), Float(*RandomFloatGenerator)(pcg32_random_t&)>
+template<typename ValueWeight, Float(*RandomFloatGenerator)(pcg32_random_t&)>
 void MakeFloat(const VectorSTBNFloatArgs& typeArgs, const VectorSTBNArgs& args)
 {
     if (args.importanceMapPath == "")
     {
         DefaultRandomTextureGenerator<Float, RandomFloatGenerator> randomFloatTextureGenerator;
-        VectorSTBNMaker<Float, ValueDistanceFunction, decltype(randomFloatTextureGenerator)> maker(args, randomFloatTextureGenerator);
+        VectorSTBNMaker<Float, ValueWeight, decltype(randomFloatTextureGenerator)> maker(args, randomFloatTextureGenerator);
         maker.Make();
     }
     else
     {
         ImportanceSamplingData isData = LoadISDataFromPNG(args.importanceMapPath, args.importanceMapIsRGB);
         ImportanceSampledRandomTextureGenerator<Float, RandomFloatGenerator> randomISFloatTextureGenerator(isData);
-        VectorSTBNMaker<Float, ValueDistanceFunction, decltype(randomISFloatTextureGenerator)> maker(args, randomISFloatTextureGenerator);
+        VectorSTBNMaker<Float, ValueWeight, decltype(randomISFloatTextureGenerator)> maker(args, randomISFloatTextureGenerator);
         maker.Make();
     }
 }
 
-template<float(*ValueDistanceFunction)(Float, Float)>
+template<typename ValueWeight>
 void MakeFloat(const VectorSTBNFloatArgs& typeArgs, const VectorSTBNArgs& args)
 {
     switch (typeArgs.generatorType)
     {
     case FLOAT_GENERATOR_TYPE::UNIFORM:
-        MakeFloat<ValueDistanceFunction, GenerateFloatUniform>(typeArgs, args);
+        MakeFloat<ValueWeight, GenerateFloatUniform>(typeArgs, args);
     break;
     case FLOAT_GENERATOR_TYPE::UNIT:
-        MakeFloat<ValueDistanceFunction, GenerateFloatUnit>(typeArgs, args);
+        MakeFloat<ValueWeight, GenerateFloatUnit>(typeArgs, args);
     break;
     }
 }
@@ -71,39 +69,39 @@ void MakeFloat(const VectorSTBNFloatArgs& typeArgs, const VectorSTBNArgs& args)
     switch (typeArgs.valueDistanceFunction)
     {
     case FLOAT_VALUE_DISTANCE_FUNCTION::ABSOLUTE_VALUE:
-        MakeFloat<&AbsDistance>(typeArgs, args);
+        MakeFloat<AbsDistanceWeight>(typeArgs, args);
         break;
     }
 }
 
-template<float(*ValueDistanceFunction)(Float2, Float2), Float2(*RandomFloat2Generator)(pcg32_random_t&)>
+template<typename ValueWeight, Float2(*RandomFloat2Generator)(pcg32_random_t&)>
 void MakeFloat2(const VectorSTBNFloat2Args& typeArgs, const VectorSTBNArgs& args)
 {
     if (args.importanceMapPath == "")
     {
         DefaultRandomTextureGenerator<Float2, RandomFloat2Generator> randomFloat2TextureGenerator;
-        VectorSTBNMaker<Float2, ValueDistanceFunction, decltype(randomFloat2TextureGenerator)> maker(args, randomFloat2TextureGenerator);
+        VectorSTBNMaker<Float2, ValueWeight, decltype(randomFloat2TextureGenerator)> maker(args, randomFloat2TextureGenerator);
         maker.Make();
     }
     else
     {
         ImportanceSamplingData isData = LoadISDataFromPNG(args.importanceMapPath, args.importanceMapIsRGB);
         ImportanceSampledRandomTextureGenerator<Float2, RandomFloat2Generator> randomISFloat2TextureGenerator(isData);
-        VectorSTBNMaker<Float2, ValueDistanceFunction, decltype(randomISFloat2TextureGenerator)> maker(args, randomISFloat2TextureGenerator);
+        VectorSTBNMaker<Float2, ValueWeight, decltype(randomISFloat2TextureGenerator)> maker(args, randomISFloat2TextureGenerator);
         maker.Make();
     }
 }
 
-template<float(*ValueDistanceFunction)(Float2, Float2)>
+template<typename ValueWeight>
 void MakeFloat2(const VectorSTBNFloat2Args& typeArgs, const VectorSTBNArgs& args)
 {
     switch (typeArgs.generatorType)
     {
     case FLOAT2_GENERATOR_TYPE::UNIFORM:
-        MakeFloat2<ValueDistanceFunction, GenerateFloat2Uniform>(typeArgs, args);
+        MakeFloat2<ValueWeight, GenerateFloat2Uniform>(typeArgs, args);
         break;
     case FLOAT2_GENERATOR_TYPE::UNIT:
-        MakeFloat2<ValueDistanceFunction, GenerateFloat2Unit>(typeArgs, args);
+        MakeFloat2<ValueWeight, GenerateFloat2Unit>(typeArgs, args);
         break;
     }
 }
@@ -113,74 +111,74 @@ void MakeFloat2(const VectorSTBNFloat2Args& typeArgs, const VectorSTBNArgs& args
     switch (typeArgs.valueDistanceFunction)
     {
     case FLOAT2_VALUE_DISTANCE_FUNCTION::L1:
-        MakeFloat2<&L1>(typeArgs, args);
+        MakeFloat2<L1Weight>(typeArgs, args);
         break;
     case FLOAT2_VALUE_DISTANCE_FUNCTION::L2:
-        MakeFloat2<&L2>(typeArgs, args);
+        MakeFloat2<L2Weight>(typeArgs, args);
         break;
     case FLOAT2_VALUE_DISTANCE_FUNCTION::LInfinity:
-        MakeFloat2<&LInfinity>(typeArgs, args);
+        MakeFloat2<LInfinityWeight>(typeArgs, args);
         break;
     }
 }
 
-template<float(*ValueDistanceFunction)(Float3, Float3), Float3(*RandomFloat3Generator)(pcg32_random_t&)>
+template<typename ValueWeight, Float3(*RandomFloat3Generator)(pcg32_random_t&)>
 void MakeFloat3(const VectorSTBNFloat3Args& typeArgs, const VectorSTBNArgs& args)
 {
     if (args.importanceMapPath == "")
     {
         DefaultRandomTextureGenerator<Float3, RandomFloat3Generator> randomFloat3TextureGenerator;
-        VectorSTBNMaker<Float3, ValueDistanceFunction, decltype(randomFloat3TextureGenerator)> maker(args, randomFloat3TextureGenerator);
+        VectorSTBNMaker<Float3, ValueWeight, decltype(randomFloat3TextureGenerator)> maker(args, randomFloat3TextureGenerator);
         maker.Make();
     }
     else
     {
         ImportanceSamplingData isData = LoadISDataFromPNG(args.importanceMapPath, args.importanceMapIsRGB);
         ImportanceSampledRandomTextureGenerator<Float3, RandomFloat3Generator> randomISFloat3TextureGenerator(isData);
-        VectorSTBNMaker<Float3, ValueDistanceFunction, decltype(randomISFloat3TextureGenerator)> maker(args, randomISFloat3TextureGenerator);
+        VectorSTBNMaker<Float3, ValueWeight, decltype(randomISFloat3TextureGenerator)> maker(args, randomISFloat3TextureGenerator);
         maker.Make();
     }
 }
 
-template<float(*ValueDistanceFunction)(Float3, Float3)>
+template<typename ValueWeight>
 void MakeFloat3Unit(const VectorSTBNFloat3Args& typeArgs, const VectorSTBNArgs& args)
 {
     if (args.importanceMapPath == "")
     {
-        DefaultRandomTextureGenerator<Float3, GenerateFloatUnit> randomFloat3TextureGenerator;
-        VectorSTBNMaker<Float3, ValueDistanceFunction, decltype(randomFloat3TextureGenerator)> maker(args, randomFloat3TextureGenerator);
+        DefaultRandomTextureGenerator<Float3, GenerateFloat3Unit> randomFloat3TextureGenerator;
+        VectorSTBNMaker<Float3, ValueWeight, decltype(randomFloat3TextureGenerator)> maker(args, randomFloat3TextureGenerator);
         maker.Make();
     }
     else
     {
         ImportanceSamplingData isData = LoadISDataFromPNG(args.importanceMapPath, args.importanceMapIsRGB);
         ImportanceSampledUnitFloat3RandomTextureGenerator randomISUnitFloat3TextureGenerator(isData);
-        VectorSTBNMaker<Float3, ValueDistanceFunction, ImportanceSampledUnitFloat3RandomTextureGenerator> maker(args, randomISUnitFloat3TextureGenerator);
+        VectorSTBNMaker<Float3, ValueWeight, ImportanceSampledUnitFloat3RandomTextureGenerator> maker(args, randomISUnitFloat3TextureGenerator);
         maker.Make();
     }
 }
 
-template<float(*ValueDistanceFunction)(Float3, Float3)>
+template<typename ValueWeight>
 void MakeFloat3UnitWeightedCosineHemisphere(const VectorSTBNFloat3Args& typeArgs, const VectorSTBNArgs& args)
 {
     CosineWeightedHemisphereFloat3RandomTextureGenerator randomISCosineWeightedHemisphereFloat3TextureGenerator;
-    VectorSTBNMaker<Float3, ValueDistanceFunction, CosineWeightedHemisphereFloat3RandomTextureGenerator> maker(args, randomISCosineWeightedHemisphereFloat3TextureGenerator);
+    VectorSTBNMaker<Float3, ValueWeight, CosineWeightedHemisphereFloat3RandomTextureGenerator> maker(args, randomISCosineWeightedHemisphereFloat3TextureGenerator);
     maker.Make();
 }
 
-template<float(*ValueDistanceFunction)(Float3, Float3)>
+template<typename ValueWeight>
 void MakeFloat3(const VectorSTBNFloat3Args& typeArgs, const VectorSTBNArgs& args)
 {
     switch (typeArgs.generatorType)
     {
     case FLOAT3_GENERATOR_TYPE::UNIFORM:
-        MakeFloat3<ValueDistanceFunction, GenerateFloat3Uniform>(typeArgs, args);
+        MakeFloat3<ValueWeight, GenerateFloat3Uniform>(typeArgs, args);
         break;
     case FLOAT3_GENERATOR_TYPE::UNIT:
-        MakeFloat3<ValueDistanceFunction, GenerateFloat3Unit>(typeArgs, args);
+        MakeFloat3<ValueWeight, GenerateFloat3Unit>(typeArgs, args);
         break;
     case FLOAT3_GENERATOR_TYPE::UNIT_COSINE_WEIGHTED_HEMISPHERE:
-        MakeFloat3UnitWeightedCosineHemisphere<ValueDistanceFunction>(typeArgs, args);
+        MakeFloat3UnitWeightedCosineHemisphere<ValueWeight>(typeArgs, args);
     }
 }
 
@@ -189,16 +187,16 @@ void MakeFloat3(const VectorSTBNFloat3Args& typeArgs, const VectorSTBNArgs& args
     switch (typeArgs.valueDistanceFunction)
     {
     case FLOAT3_VALUE_DISTANCE_FUNCTION::L1:
-        MakeFloat3<&L1>(typeArgs, args);
+        MakeFloat3<L1Weight>(typeArgs, args);
         break;
     case FLOAT3_VALUE_DISTANCE_FUNCTION::L2:
-        MakeFloat3<&L2>(typeArgs, args);
+        MakeFloat3<L2Weight>(typeArgs, args);
         break;
     case FLOAT3_VALUE_DISTANCE_FUNCTION::LInfinity:
-        MakeFloat3<&LInfinity>(typeArgs, args);
+        MakeFloat3<LInfinityWeight>(typeArgs, args);
         break;
     case FLOAT3_VALUE_DISTANCE_FUNCTION::NegativeDot:
-        MakeFloat3<&NegativeDot>(typeArgs, args);
+        MakeFloat3<NegativeDotWeight>(typeArgs, args);
         break;
     }
 }
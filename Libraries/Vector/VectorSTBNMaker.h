@@ -18,6 +18,7 @@
 #include <vector>
 
 #include "STBNRandom.h"
+#include "Trace.h"
 #include "VectorSTBNArgs.h"
 #include "Debug/DebugFileExport.h"
 #include "Exporters/RGBAExporters.h"
@@ -25,6 +26,7 @@
 #include "ImportanceSampling/ImportanceSamplingData.h"
 #include "RandomTextureGenerators/PDFStats.h"
 #include "Reporting/ProgressReporter.h"
+#include "SimulatedAnnealing/ParallelTempering.h"
 #include "SimulatedAnnealing/SimulatedAnnealing.h"
 #include "Utils/Dimensions3D.h"
 #include "VectorSTBNProgressData.h"
@@ -38,7 +40,7 @@ std::string GenerateBaseOutputFileName(const VectorSTBNArgs& args)
     return ss.str();
 }
 
-template<typename T, float(*ValueDistance)(T, T), typename RandomTextureGenerator>
+template<typename T, typename ValueWeight, typename RandomTextureGenerator>
 class VectorSTBNMaker
 {
 public:
@@ -46,16 +48,20 @@ public:
         m_dims(args.dimensions),
         m_baseOutputFilePath(args.baseOutputFilePath),
         m_baseOutputFileName(GenerateBaseOutputFileName(args)),
+        m_numThreads(args.numThreads),
+        m_numSpeculativeThreads(args.numSpeculativeThreads),
         m_randomTextureGenerator(randomTextureGenerator),
         m_rng(GetRNG()),
         m_kernelX(VectorBlueNoiseGaussianKernel(args.energySigma, m_dims.x)),
         m_kernelY(VectorBlueNoiseGaussianKernel(args.energySigma, m_dims.y)),
         m_kernelZ(VectorBlueNoiseGaussianKernel(args.energySigma, m_dims.z)),
         m_saData(m_dims),
-        m_saDataController(m_saData, m_kernelX, m_kernelY, m_kernelZ, args.valueSigma),
-        m_sa(m_dims, m_saDataController, args.swapCountFactor, args.coolingFactor),
+        m_saDataController(m_saData, m_kernelX, m_kernelY, m_kernelZ, args.valueSigma, args.soaCells),
+        m_sa(m_dims, m_saDataController, args.swapCountFactor, args.coolingFactor, args.coolingSchedule, args.swapProposals),
         m_reporter(m_progress, m_sa.GetProgressData(), m_dims, 10)
     {
+        if (args.numReplicas > 1)
+            m_parallelTempering = std::make_unique<ParallelTempering<T, ValueWeight>>(m_saData, m_kernelX, m_kernelY, m_kernelZ, args.valueSigma, args.swapCountFactor, args.coolingFactor, args.numReplicas, args.maxReplicaTemperature, args.soaCells, args.swapProposals, m_sa.GetProgressData());
     }
 
     void Make()
@@ -81,6 +87,8 @@ private:
     Dimensions3D m_dims;
     std::string m_baseOutputFilePath;
     std::string m_baseOutputFileName;
+    size_t m_numThreads;
+    size_t m_numSpeculativeThreads;
 
     RandomTextureGenerator& m_randomTextureGenerator;
 
@@ -93,8 +101,9 @@ private:
     SymmetricKernel m_kernelZ;
 
     SAData<T> m_saData;
-    SADataController<T, ValueDistance> m_saDataController;
-    SimulatedAnnealing<T, ValueDistance> m_sa;
+    SADataController<T, ValueWeight> m_saDataController;
+    SimulatedAnnealing<T, ValueWeight> m_sa;
+    std::unique_ptr<ParallelTempering<T, ValueWeight>> m_parallelTempering;
 
     VectorSTBNProgressData m_progress;
 
@@ -102,6 +111,7 @@ private:
 
     void GenerateStartingTexture()
     {
+        TraceSpan span("GenerateStartingTexture", "VectorSTBN");
         m_progress.startedGenerateTexture = true;
         m_pdfStats = m_randomTextureGenerator.Generate(m_saData.cells, m_saData.pdf, m_rng);
         m_progress.finishedGenerateTexture = true;
@@ -109,13 +119,22 @@ private:
 
     void RunSimulatedAnnealing()
     {
+        TraceSpan span("RunSimulatedAnnealing", "VectorSTBN");
         m_progress.startedSA = true;
-        m_sa.Run(m_rng);
+        if (m_parallelTempering)
+            m_parallelTempering->Run(m_rng);
+        else if (m_numThreads > 1)
+            m_sa.RunCheckerboard(m_rng, m_numThreads);
+        else if (m_numSpeculativeThreads > 1)
+            m_sa.RunSpeculative(m_rng, m_numSpeculativeThreads);
+        else
+            m_sa.Run(m_rng);
         m_progress.finishedSA = true;
     }
 
     void WriteOutFinalFiles()
     {
+        TraceSpan span("WriteOutFinalFiles", "VectorSTBN");
         m_progress.startedFileExport = true;
         auto output = ConvertCellsAndPDFToRGBA32Texture(m_saData.cells, m_saData.pdf, m_pdfStats.min, m_pdfStats.max);
         WriteRGBA32CellsToPNG(m_baseOutputFileName, output, m_dims);
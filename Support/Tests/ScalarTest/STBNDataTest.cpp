@@ -15,8 +15,7 @@ TEST(STBNData, Constructor)
     std::vector<float> energy;
     energy.resize(numPixels, 0.0f);
 
-    std::vector<bool> pixelOn;
-    pixelOn.resize(numPixels, false);
+    PixelBitset pixelOn(numPixels, false);
 
     std::vector<size_t> pixelRank;
     pixelRank.resize(numPixels, numPixels);
@@ -43,4 +42,29 @@ TEST(STBNData, Equality)
 
     EXPECT_EQ(a, a);
     EXPECT_EQ(a, b);
+}
+
+TEST(STBNData, WithoutEnergy)
+{
+    Dimensions dims = { 16, 16, 4, 1 };
+    STBNData data(dims, false);
+
+    EXPECT_TRUE(data.energy.empty());
+    EXPECT_EQ(data.pixelOn.size(), data.numPixels);
+    EXPECT_EQ(data.pixelRank.size(), data.numPixels);
+}
+
+TEST(STBNData, ArenaAllocation)
+{
+    HugePageArenaStats before = HugePageArena::GetStats();
+
+    Dimensions dims = { 128, 128, 64, 1 };
+    STBNData data(dims);
+
+    EXPECT_EQ(reinterpret_cast<size_t>(data.energy.data()) % HugePageArena::c_alignment, 0u);
+    EXPECT_EQ(reinterpret_cast<size_t>(data.pixelRank.data()) % HugePageArena::c_alignment, 0u);
+
+    // energy and pixelRank are both over 2MB, so each gets its own mapping
+    HugePageArenaStats after = HugePageArena::GetStats();
+    EXPECT_EQ(after.largeAllocations - before.largeAllocations, 2u);
 }
\ No newline at end of file
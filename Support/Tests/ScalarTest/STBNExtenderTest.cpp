@@ -0,0 +1,107 @@
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "STBNExtender.h"
+#include "STBNMaker.h"
+#include "Utils/PixelCoords.h"
+#include "VoidAndCluster/VoidAndCluster.h"
+
+static Dimensions existingDims = { 32, 32, 16, 1 };
+static SigmaPerDimension sigmas = { 1.9f, 1.9f, 1.9f, 1.9f };
+static float ibpd = 0.1f;
+
+static const std::vector<size_t>& GetExistingRanks()
+{
+    static std::vector<size_t> ranks;
+    if (ranks.empty())
+    {
+        STBNMaker maker(existingDims, sigmas, ibpd, ScalarImplementation::SliceCache_2Dx1Dx1D);
+        maker.Make();
+        const ArenaVector<size_t>& pixelRank = maker.GetVoidAndCluster()->GetSTBNData().pixelRank;
+        ranks.assign(pixelRank.begin(), pixelRank.end());
+    }
+    return ranks;
+}
+
+TEST(STBNExtender, RanksArePermutation)
+{
+    STBNExtender extender(existingDims, GetExistingRanks(), 24, sigmas, ScalarImplementation::SliceCache_2Dx1Dx1D);
+    extender.Make();
+
+    const STBNData& data = extender.GetSTBNData();
+    std::vector<size_t> sortedRanks(data.pixelRank.begin(), data.pixelRank.end());
+    std::sort(sortedRanks.begin(), sortedRanks.end());
+    for (size_t rank = 0; rank < sortedRanks.size(); ++rank)
+        EXPECT_EQ(sortedRanks[rank], rank);
+}
+
+// The window is under half the depth of the extended volume, so the first half of the ranks, which are given out
+// before looking for unranked pixels, run past the window's own pixel count. With these dims, rank 16x16x16 goes
+// to a new pixel, which must not be mistaken for one without a rank.
+TEST(STBNExtender, DeepVolumeRanksArePermutation)
+{
+    Dimensions deepDims = { 16, 16, 29, 1 };
+    STBNMaker maker(deepDims, sigmas, ibpd, ScalarImplementation::SliceCache_2Dx1Dx1D);
+    maker.Make();
+    const ArenaVector<size_t>& pixelRank = maker.GetVoidAndCluster()->GetSTBNData().pixelRank;
+    std::vector<size_t> deepRanks(pixelRank.begin(), pixelRank.end());
+
+    STBNExtender extender(deepDims, deepRanks, 33, sigmas, ScalarImplementation::SliceCache_2Dx1Dx1D);
+    extender.Make();
+    ASSERT_LT(extender.GetWindowDimZ() * 2, size_t(33));
+
+    const STBNData& data = extender.GetSTBNData();
+    std::vector<size_t> sortedRanks(data.pixelRank.begin(), data.pixelRank.end());
+    std::sort(sortedRanks.begin(), sortedRanks.end());
+    for (size_t rank = 0; rank < sortedRanks.size(); ++rank)
+        EXPECT_EQ(sortedRanks[rank], rank);
+}
+
+TEST(STBNExtender, ExistingOrderKept)
+{
+    const std::vector<size_t>& existingRanks = GetExistingRanks();
+    STBNExtender extender(existingDims, existingRanks, 24, sigmas, ScalarImplementation::SliceCache_2Dx1Dx1D);
+    extender.Make();
+
+    const STBNData& data = extender.GetSTBNData();
+    std::vector<size_t> extendedIndexByExistingRank(existingRanks.size());
+    for (size_t pixelIndex = 0; pixelIndex < existingRanks.size(); ++pixelIndex)
+    {
+        PixelCoords coords = PixelIndexToPixelCoords(pixelIndex, existingDims);
+        extendedIndexByExistingRank[existingRanks[pixelIndex]] = PixelCoordsToPixelIndex(coords, data.dimensions);
+    }
+
+    for (size_t rank = 1; rank < extendedIndexByExistingRank.size(); ++rank)
+        EXPECT_LT(data.pixelRank[extendedIndexByExistingRank[rank - 1]], data.pixelRank[extendedIndexByExistingRank[rank]]);
+}
+
+TEST(STBNExtender, WindowOnlyCoversNewSlices)
+{
+    STBNExtender extender(existingDims, GetExistingRanks(), 24, sigmas, ScalarImplementation::SliceCache_2Dx1Dx1D);
+    BlueNoiseGaussianKernel kernelZ(sigmas.z, 24);
+
+    EXPECT_EQ(extender.GetWindowDimZ(), size_t(8 + 2 * kernelZ.max()));
+}
+
+TEST(STBNExtender, SliceCacheMatchesReference)
+{
+    STBNExtender extenderSC(existingDims, GetExistingRanks(), 24, sigmas, ScalarImplementation::SliceCache_2Dx1Dx1D);
+    STBNExtender extenderRef(existingDims, GetExistingRanks(), 24, sigmas, ScalarImplementation::Reference_2Dx1Dx1D);
+    extenderSC.Make();
+    extenderRef.Make();
+
+    EXPECT_EQ(extenderSC.GetSTBNData().pixelRank, extenderRef.GetSTBNData().pixelRank);
+}
+
+// Extending with other groups has to change how the new slices are made, not be dropped for the 2Dx1Dx1D default
+TEST(STBNExtender, GroupsReachTheController)
+{
+    STBNExtender extender211(existingDims, GetExistingRanks(), 24, sigmas, ScalarImplementation::SliceCache_ND, { 0, 0, 1, 2 });
+    STBNExtender extender1111(existingDims, GetExistingRanks(), 24, sigmas, ScalarImplementation::SliceCache_ND, { 0, 1, 2, 3 });
+    extender211.Make();
+    extender1111.Make();
+
+    EXPECT_NE(extender211.GetSTBNData().pixelRank, extender1111.GetSTBNData().pixelRank);
+}
@@ -0,0 +1,72 @@
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "STBNMath.h"
+
+TEST(STBNMath, ConstexprExpMatchesExp)
+{
+    for (double x = -20.0; x <= 4.0; x += 0.01)
+        EXPECT_NEAR(ConstexprExp(x), std::exp(x), std::exp(x) * 1e-12);
+}
+
+TEST(STBNMath, FastCbrtMatchesCbrt)
+{
+    EXPECT_EQ(FastCbrt(0.0f), 0.0f);
+    for (float x = 1e-6f; x < 100.0f; x *= 1.01f)
+        ASSERT_NEAR(FastCbrt(x), std::cbrt(x), std::cbrt(x) * 2e-6f) << "x = " << x;
+}
+
+TEST(STBNMath, FastExpWithinErrorBound)
+{
+    for (float x = -20.0f; x <= 0.0f; x += 0.0007f)
+        ASSERT_NEAR(FastExp(x), std::exp(x), c_fastExpMaxError) << "x = " << x;
+}
+
+TEST(STBNMath, FastExpClampsToRange)
+{
+    EXPECT_EQ(FastExp(-100.0f), FastExp(FastExpLUT::c_minimum));
+    EXPECT_EQ(FastExp(1.0f), 1.0f);
+    EXPECT_EQ(FastExp(0.0f), 1.0f);
+}
+
+TEST(STBNMath, FunctionLUT2ParamInterpolates)
+{
+    // Bilinear interpolation reproduces a bilinear function
+    static constexpr FunctionLUT2Param<0.0f, 1.0f, -1.0f, 1.0f, 5, 9, float> lut([](float x, float y) { return 2.0f * x - y + x * y; });
+    for (float y = -1.0f; y <= 1.0f; y += 0.07f)
+    {
+        for (float x = 0.0f; x <= 1.0f; x += 0.03f)
+            EXPECT_NEAR(lut.Lookup(x, y), 2.0f * x - y + x * y, 1e-5f);
+    }
+}
+
+static void ExpectFastExpBatchSameAsScalar(CPUISA isa)
+{
+    if (!IsISASupported(isa))
+        GTEST_SKIP() << ISAToString(isa) << " isn't supported here";
+
+    // Odd lengths so the vector versions have a tail to deal with
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> value(-20.0f, 1.0f);
+    std::vector<float> x(1001);
+    for (float& v : x)
+        v = value(rng);
+
+    std::vector<float> out(x.size());
+    GetFastExpBatch(isa)(x.data(), out.data(), x.size());
+    for (size_t index = 0; index < x.size(); ++index)
+        ASSERT_NEAR(out[index], FastExp(x[index]), 1e-7f) << "x = " << x[index];
+}
+
+TEST(STBNMath, FastExpBatchAVX2MatchesScalar)
+{
+    ExpectFastExpBatchSameAsScalar(CPUISA::AVX2);
+}
+
+TEST(STBNMath, FastExpBatchAVX512MatchesScalar)
+{
+    ExpectFastExpBatchSameAsScalar(CPUISA::AVX512);
+}
\ No newline at end of file
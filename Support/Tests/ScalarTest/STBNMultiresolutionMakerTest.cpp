@@ -0,0 +1,63 @@
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "Kernel/BlueNoiseGaussianKernel.h"
+#include "STBNMaker.h"
+#include "STBNMultiresolutionMaker.h"
+#include "VoidAndCluster/SliceCache/SliceCacheController2Dx1Dx1D.h"
+#include "VoidAndCluster/VoidAndCluster.h"
+
+static Dimensions dims = { 64, 64, 8, 1 };
+static SigmaPerDimension sigmas = { 1.9f, 1.9f, 1.9f, 1.9f };
+static float ibpd = 0.1f;
+
+TEST(STBNMultiresolutionMaker, LevelsStopAtMinDim)
+{
+    EXPECT_EQ(STBNMultiresolutionMaker(dims, sigmas, ibpd, ScalarImplementation::SliceCache_2Dx1Dx1D, 1).GetNumLevels(), size_t(1));
+    EXPECT_EQ(STBNMultiresolutionMaker(dims, sigmas, ibpd, ScalarImplementation::SliceCache_2Dx1Dx1D, 2).GetNumLevels(), size_t(2));
+    EXPECT_EQ(STBNMultiresolutionMaker(dims, sigmas, ibpd, ScalarImplementation::SliceCache_2Dx1Dx1D, 10).GetNumLevels(), size_t(3));
+    EXPECT_EQ(STBNMultiresolutionMaker({ 48, 64, 8, 1 }, sigmas, ibpd, ScalarImplementation::SliceCache_2Dx1Dx1D, 10).GetNumLevels(), size_t(2));
+}
+
+TEST(STBNMultiresolutionMaker, RanksArePermutation)
+{
+    STBNMultiresolutionMaker maker(dims, sigmas, ibpd, ScalarImplementation::SliceCache_2Dx1Dx1D, 3);
+    maker.Make();
+
+    const STBNData& data = maker.GetVoidAndCluster()->GetSTBNData();
+    std::vector<size_t> sortedRanks(data.pixelRank.begin(), data.pixelRank.end());
+    std::sort(sortedRanks.begin(), sortedRanks.end());
+    for (size_t rank = 0; rank < sortedRanks.size(); ++rank)
+        EXPECT_EQ(sortedRanks[rank], rank);
+}
+
+TEST(STBNMultiresolutionMaker, OneLevelMatchesSTBNMaker)
+{
+    STBNMultiresolutionMaker multiresMaker(dims, sigmas, ibpd, ScalarImplementation::SliceCache_2Dx1Dx1D, 1);
+    STBNMaker maker(dims, sigmas, ibpd, ScalarImplementation::SliceCache_2Dx1Dx1D);
+    multiresMaker.Make();
+    maker.Make();
+
+    EXPECT_EQ(multiresMaker.GetVoidAndCluster()->GetSTBNData().pixelRank, maker.GetVoidAndCluster()->GetSTBNData().pixelRank);
+}
+
+TEST(VoidAndCluster, InitializeFromPattern)
+{
+    Dimensions smallDims = { 16, 16, 4, 1 };
+    BlueNoiseGaussianKernel kxy(sigmas.x, smallDims.x);
+    BlueNoiseGaussianKernel kz(sigmas.z, smallDims.z);
+    BlueNoiseGaussianKernel kw(sigmas.w, smallDims.w);
+    STBNData data(smallDims);
+    SliceCacheController2Dx1Dx1D vcc(data, kxy, kxy, kz, kw);
+    VoidAndCluster vc(ibpd, &vcc);
+
+    // Duplicates are only turned on once
+    std::vector<size_t> onPixels = { 3, 70, 500, 70, 1023 };
+    vc.InitializeFromPattern(onPixels);
+
+    EXPECT_EQ(vcc.GetPixelOnCount(), size_t(4));
+    for (size_t pixelIndex : onPixels)
+        EXPECT_TRUE(data.pixelOn[pixelIndex]);
+}
\ No newline at end of file
@@ -0,0 +1,60 @@
+#include "gtest/gtest.h"
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "Trace.h"
+
+static std::string TracePath()
+{
+    return (std::filesystem::temp_directory_path() / "STBNTraceTest.json").string();
+}
+
+static std::string ReadFile(const std::string& fileName)
+{
+    std::ifstream file(fileName);
+    std::stringstream ss;
+    ss << file.rdbuf();
+    return ss.str();
+}
+
+TEST(Trace, NothingRecordedWhenClosed)
+{
+    EXPECT_FALSE(Trace::IsOpen());
+    {
+        TraceSpan span("Closed", "Test");
+        Trace::Counter("Closed counter", 1.0);
+    }
+    Trace::Close();
+    EXPECT_FALSE(Trace::IsOpen());
+}
+
+TEST(Trace, WritesSpansAndCounters)
+{
+    std::string fileName = TracePath();
+    ASSERT_TRUE(Trace::Open(fileName.c_str()));
+    EXPECT_TRUE(Trace::IsOpen());
+    EXPECT_FALSE(Trace::Open(fileName.c_str()));
+
+    Trace::SetThreadName("Test thread");
+    {
+        TraceSpan span("Outer", "Test");
+        Trace::Counter("Test counter", 42.0);
+    }
+    Trace::Close();
+    EXPECT_FALSE(Trace::IsOpen());
+
+    std::string json = ReadFile(fileName);
+    std::filesystem::remove(fileName);
+
+    EXPECT_EQ(json.find("{\"displayTimeUnit\""), size_t(0));
+    EXPECT_NE(json.find("{\"ph\":\"B\""), std::string::npos);
+    EXPECT_NE(json.find("{\"ph\":\"E\""), std::string::npos);
+    EXPECT_NE(json.find("\"name\":\"Outer\",\"cat\":\"Test\""), std::string::npos);
+    EXPECT_NE(json.find("\"Test counter\""), std::string::npos);
+    EXPECT_NE(json.find("\"Test thread\""), std::string::npos);
+    EXPECT_EQ(json.find("Closed"), std::string::npos);
+    EXPECT_EQ(json.substr(json.find_last_not_of("\n") - 1, 2), "]}");
+}
\ No newline at end of file
@@ -0,0 +1,86 @@
+#include "gtest/gtest.h"
+
+#include <random>
+#include <vector>
+
+#include "Utils/PixelBitset.h"
+
+// Odd size so the last word is partly used
+static const size_t c_size = 1000;
+
+static std::vector<bool> RandomBits(unsigned int seed)
+{
+    std::mt19937 rng(seed);
+    std::vector<bool> ret(c_size);
+    for (size_t i = 0; i < c_size; ++i)
+        ret[i] = (rng() & 1) != 0;
+    return ret;
+}
+
+static PixelBitset ToBitset(const std::vector<bool>& bits)
+{
+    PixelBitset ret(bits.size());
+    for (size_t i = 0; i < bits.size(); ++i)
+        ret.Set(i, bits[i]);
+    return ret;
+}
+
+TEST(PixelBitset, SetGetCount)
+{
+    std::vector<bool> bits = RandomBits(1);
+    PixelBitset bitset = ToBitset(bits);
+
+    size_t count = 0;
+    for (size_t i = 0; i < c_size; ++i)
+    {
+        EXPECT_EQ(bitset[i], bits[i]);
+        count += bits[i] ? 1 : 0;
+    }
+    EXPECT_EQ(bitset.Count(), count);
+}
+
+TEST(PixelBitset, FlipAll)
+{
+    std::vector<bool> bits = RandomBits(2);
+    PixelBitset bitset = ToBitset(bits);
+    size_t count = bitset.Count();
+
+    bitset.FlipAll();
+    for (size_t i = 0; i < c_size; ++i)
+        EXPECT_EQ(bitset[i], !bits[i]);
+    EXPECT_EQ(bitset.Count(), c_size - count);
+
+    PixelBitset allOn(c_size, true);
+    EXPECT_EQ(allOn.Count(), c_size);
+    allOn.FlipAll();
+    EXPECT_EQ(allOn, PixelBitset(c_size, false));
+}
+
+TEST(PixelBitset, ForEachBit)
+{
+    std::vector<bool> bits = RandomBits(3);
+    PixelBitset bitset = ToBitset(bits);
+
+    // Ranges that start and end inside words, cover whole words, and are empty
+    const size_t ranges[][2] = { { 0, c_size }, { 5, 70 }, { 64, 128 }, { 130, 131 }, { 200, 200 }, { 900, c_size } };
+    for (const auto& range : ranges)
+    {
+        std::vector<size_t> expectedOn, expectedOff, on, off;
+        for (size_t i = range[0]; i < range[1]; ++i)
+            (bits[i] ? expectedOn : expectedOff).push_back(i);
+
+        bitset.ForEachBit<true>(range[0], range[1], [&](size_t i) { on.push_back(i); });
+        bitset.ForEachBit<false>(range[0], range[1], [&](size_t i) { off.push_back(i); });
+        EXPECT_EQ(on, expectedOn);
+        EXPECT_EQ(off, expectedOff);
+    }
+}
+
+TEST(PixelBitset, Resize)
+{
+    PixelBitset bitset(10, false);
+    bitset.resize(100, true);
+    for (size_t i = 0; i < 100; ++i)
+        EXPECT_EQ(bitset[i], i >= 10);
+    EXPECT_EQ(bitset.Count(), 90u);
+}
\ No newline at end of file
@@ -0,0 +1,78 @@
+#include "gtest/gtest.h"
+
+#include <numeric>
+
+#include "Utils/Dimensions.h"
+#include "Utils/PixelCoords.h"
+
+static void ExpectRoundTrip(const Dimensions& dims)
+{
+    size_t numPixels = dims.x * dims.y * dims.z * dims.w;
+    std::vector<bool> seen(numPixels, false);
+    for (size_t w = 0; w < dims.w; ++w)
+    {
+        for (size_t z = 0; z < dims.z; ++z)
+        {
+            for (size_t y = 0; y < dims.y; ++y)
+            {
+                for (size_t x = 0; x < dims.x; ++x)
+                {
+                    size_t pixelIndex = PixelCoordsToPixelIndex({ x, y, z, w }, dims);
+                    ASSERT_LT(pixelIndex, numPixels);
+                    EXPECT_FALSE(seen[pixelIndex]);
+                    seen[pixelIndex] = true;
+
+                    PixelCoords coords = PixelIndexToPixelCoords(pixelIndex, dims);
+                    EXPECT_EQ(coords.x, x);
+                    EXPECT_EQ(coords.y, y);
+                    EXPECT_EQ(coords.z, z);
+                    EXPECT_EQ(coords.w, w);
+                }
+            }
+        }
+    }
+}
+
+TEST(PixelCoords, LinearRoundTrip)
+{
+    // W larger than Y
+    ExpectRoundTrip({ 4, 2, 3, 5 });
+}
+
+TEST(PixelCoords, BrickedRoundTrip)
+{
+    ExpectRoundTrip({ 16, 24, 8, 2, PixelLayout::Bricked });
+}
+
+TEST(PixelCoords, BrickedZTapsAreClose)
+{
+    Dimensions dims = { 64, 64, 16, 1, PixelLayout::Bricked };
+    size_t a = PixelCoordsToPixelIndex({ 9, 9, 4, 0 }, dims);
+    size_t b = PixelCoordsToPixelIndex({ 9, 9, 5, 0 }, dims);
+    EXPECT_EQ(b - a, c_brickSizeX * c_brickSizeY);
+}
+
+TEST(PixelCoords, ValuesToLinearOrder)
+{
+    Dimensions dims = { 8, 16, 4, 1, PixelLayout::Bricked };
+    Dimensions linearDims = { 8, 16, 4, 1 };
+    size_t numPixels = dims.x * dims.y * dims.z * dims.w;
+
+    // Store each pixel's linear index at its bricked index
+    ArenaVector<size_t> values(numPixels);
+    for (size_t linearIndex = 0; linearIndex < numPixels; ++linearIndex)
+        values[PixelCoordsToPixelIndex(PixelIndexToPixelCoords(linearIndex, linearDims), dims)] = linearIndex;
+
+    std::vector<size_t> expected(numPixels);
+    std::iota(expected.begin(), expected.end(), size_t(0));
+    EXPECT_EQ(PixelValuesToLinearOrder(values, dims), expected);
+    EXPECT_EQ(PixelValuesToLinearOrder(ArenaVector<size_t>(expected.begin(), expected.end()), linearDims), expected);
+}
+
+TEST(Dimensions, LayoutSupported)
+{
+    EXPECT_TRUE(IsLayoutSupported({ 12, 10, 3, 1 }));
+    EXPECT_TRUE(IsLayoutSupported({ 16, 8, 4, 3, PixelLayout::Bricked }));
+    EXPECT_FALSE(IsLayoutSupported({ 12, 8, 4, 1, PixelLayout::Bricked }));
+    EXPECT_FALSE(IsLayoutSupported({ 16, 8, 6, 1, PixelLayout::Bricked }));
+}
@@ -0,0 +1,109 @@
+#include "gtest/gtest.h"
+
+#include "Kernel/BlueNoiseGaussianKernel.h"
+#include "STBNData.h"
+
+#include "VoidAndCluster/Auto/AutoController2Dx1Dx1D.h"
+#include "VoidAndCluster/Reference/ReferenceController2Dx1Dx1D.h"
+#include "VoidAndCluster/VoidAndCluster.h"
+
+static Dimensions dims = { 32, 32, 16, 1 };
+static SigmaPerDimension sigmas = { 1.9f, 1.9f, 1.9f, 1.9f };
+static float ibpd = 0.1f;
+static BlueNoiseGaussianKernel kx(sigmas.x, dims.x);
+static BlueNoiseGaussianKernel ky(sigmas.y, dims.y);
+static BlueNoiseGaussianKernel kz(sigmas.z, dims.z);
+static BlueNoiseGaussianKernel kw(sigmas.w, dims.w);
+
+static AutoController2Dx1Dx1D* get_Global_VCC_Auto_32x32x16x1()
+{
+    static STBNData dataAuto(dims);
+    static AutoController2Dx1Dx1D vccAuto(dataAuto, kx, ky, kz, kw);
+
+    return &vccAuto;
+}
+
+static VoidAndCluster* get_Global_VC_Auto_32x32x16x1()
+{
+    static VoidAndCluster vcAuto(ibpd, get_Global_VCC_Auto_32x32x16x1());
+
+    return &vcAuto;
+}
+
+static VoidAndCluster* get_Global_VC_Ref_32x32x16x1()
+{
+    static STBNData dataRef(dims);
+    static ReferenceController2Dx1Dx1D vccRef(dataRef, kx, ky, kz, kw);
+    static VoidAndCluster vcRef(ibpd, &vccRef);
+
+    return &vcRef;
+}
+
+TEST(AutoController2Dx1Dx1D, WhiteNoise32x32x16)
+{
+    auto vcAuto = get_Global_VC_Auto_32x32x16x1();
+    auto vcRef = get_Global_VC_Ref_32x32x16x1();
+
+    vcAuto->InitializeToWhiteNoise();
+    vcRef->InitializeToWhiteNoise();
+
+    EXPECT_EQ(vcAuto->GetSTBNData().energy, vcRef->GetSTBNData().energy);
+}
+
+TEST(AutoController2Dx1Dx1D, ReorganizeToBlueNoise32x32x16)
+{
+    auto vcAuto = get_Global_VC_Auto_32x32x16x1();
+    auto vcRef = get_Global_VC_Ref_32x32x16x1();
+
+    vcAuto->ReorganizeToBlueNoise();
+    vcRef->ReorganizeToBlueNoise();
+
+    EXPECT_EQ(vcAuto->GetSTBNData().energy, vcRef->GetSTBNData().energy);
+    EXPECT_EQ(vcAuto->GetSTBNData().pixelOn, vcRef->GetSTBNData().pixelOn);
+}
+
+TEST(AutoController2Dx1Dx1D, Phase1)
+{
+    auto vcAuto = get_Global_VC_Auto_32x32x16x1();
+    auto vcRef = get_Global_VC_Ref_32x32x16x1();
+
+    vcAuto->Phase1();
+    vcRef->Phase1();
+
+    EXPECT_EQ(vcAuto->GetSTBNData().energy, vcRef->GetSTBNData().energy);
+    EXPECT_EQ(vcAuto->GetSTBNData().pixelRank, vcRef->GetSTBNData().pixelRank);
+}
+
+TEST(AutoController2Dx1Dx1D, Phase2)
+{
+    auto vcAuto = get_Global_VC_Auto_32x32x16x1();
+    auto vcRef = get_Global_VC_Ref_32x32x16x1();
+
+    vcAuto->Phase2();
+    vcRef->Phase2();
+
+    EXPECT_EQ(vcAuto->GetSTBNData().energy, vcRef->GetSTBNData().energy);
+    EXPECT_EQ(vcAuto->GetSTBNData().pixelRank, vcRef->GetSTBNData().pixelRank);
+}
+
+TEST(AutoController2Dx1Dx1D, Phase3)
+{
+    auto vcAuto = get_Global_VC_Auto_32x32x16x1();
+    auto vcRef = get_Global_VC_Ref_32x32x16x1();
+
+    vcAuto->Phase3();
+    vcRef->Phase3();
+
+    EXPECT_EQ(vcAuto->GetSTBNData().energy, vcRef->GetSTBNData().energy);
+    EXPECT_EQ(vcAuto->GetSTBNData().pixelRank, vcRef->GetSTBNData().pixelRank);
+}
+
+TEST(AutoController2Dx1Dx1D, UsedMoreThanOneStrategy)
+{
+    // Runs after the phase tests above, so this is the full generation
+    const AutoControllerStats& stats = get_Global_VCC_Auto_32x32x16x1()->GetStats();
+
+    EXPECT_GT(stats.strategySwitches, 0u);
+    EXPECT_GT(stats.queries[(size_t)AutoStrategy::SliceCache], 0u);
+    EXPECT_GT(stats.queries[(size_t)AutoStrategy::PixelList], 0u);
+}
@@ -0,0 +1,131 @@
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <numeric>
+
+#include "BlueNoiseTexturesND.h"
+#include "Kernel/BlueNoiseGaussianKernel.h"
+#include "STBNData.h"
+#include "STBNMaker.h"
+#include "Utils/PixelCoords.h"
+
+#include "VoidAndCluster/Auto/AutoController2Dx1Dx1D.h"
+#include "VoidAndCluster/Reference/ReferenceController2Dx1Dx1D.h"
+#include "VoidAndCluster/Reference/ReferenceController2Dx2D.h"
+#include "VoidAndCluster/SliceCache/SliceCacheController2Dx1Dx1D.h"
+#include "VoidAndCluster/SliceCache/SliceCacheController2Dx2D.h"
+#include "VoidAndCluster/SliceCache/SliceCacheControllerND.h"
+#include "VoidAndCluster/VoidAndCluster.h"
+
+static Dimensions dims = { 32, 32, 8, 1, PixelLayout::Bricked };
+static SigmaPerDimension sigmas = { 1.9f, 1.9f, 1.9f, 1.9f };
+static float ibpd = 0.1f;
+static BlueNoiseGaussianKernel kx(sigmas.x, dims.x);
+static BlueNoiseGaussianKernel ky(sigmas.y, dims.y);
+static BlueNoiseGaussianKernel kz(sigmas.z, dims.z);
+static BlueNoiseGaussianKernel kw(sigmas.w, dims.w);
+
+static void RunAllPhases(VoidAndCluster& vc)
+{
+    vc.InitializeToWhiteNoise();
+    vc.ReorganizeToBlueNoise();
+    vc.Phase1();
+    vc.Phase2();
+    vc.Phase3();
+}
+
+static const STBNData& GetBrickedReference2Dx1Dx1D()
+{
+    static STBNData dataRef(dims);
+    static ReferenceController2Dx1Dx1D vccRef(dataRef, kx, ky, kz, kw);
+    static VoidAndCluster vcRef(ibpd, &vccRef);
+    static bool made = false;
+    if (!made)
+    {
+        RunAllPhases(vcRef);
+        made = true;
+    }
+    return dataRef;
+}
+
+TEST(BrickedLayout, SliceCache2Dx1Dx1DMatchesReference)
+{
+    STBNData data(dims);
+    SliceCacheController2Dx1Dx1D vcc(data, kx, ky, kz, kw);
+    VoidAndCluster vc(ibpd, &vcc);
+    RunAllPhases(vc);
+
+    EXPECT_EQ(data.energy, GetBrickedReference2Dx1Dx1D().energy);
+    EXPECT_EQ(data.pixelRank, GetBrickedReference2Dx1Dx1D().pixelRank);
+}
+
+TEST(BrickedLayout, SliceCacheNDMatchesReference)
+{
+    STBNData data(dims);
+    SliceCacheControllerND vcc(data, BlueNoiseTexturesND::MakeGroupMasks({ 0, 0, 1, 2 }, 4), kx, ky, kz, kw);
+    VoidAndCluster vc(ibpd, &vcc);
+    RunAllPhases(vc);
+
+    EXPECT_EQ(data.energy, GetBrickedReference2Dx1Dx1D().energy);
+    EXPECT_EQ(data.pixelRank, GetBrickedReference2Dx1Dx1D().pixelRank);
+}
+
+TEST(BrickedLayout, AutoMatchesReference)
+{
+    STBNData data(dims);
+    AutoController2Dx1Dx1D vcc(data, kx, ky, kz, kw);
+    VoidAndCluster vc(ibpd, &vcc);
+    RunAllPhases(vc);
+
+    EXPECT_EQ(data.energy, GetBrickedReference2Dx1Dx1D().energy);
+    EXPECT_EQ(data.pixelRank, GetBrickedReference2Dx1Dx1D().pixelRank);
+}
+
+TEST(BrickedLayout, SliceCache2Dx2DMatchesReference)
+{
+    Dimensions dims22 = { 16, 16, 4, 4, PixelLayout::Bricked };
+    BlueNoiseGaussianKernel kx22(sigmas.x, dims22.x), ky22(sigmas.y, dims22.y), kz22(sigmas.z, dims22.z), kw22(sigmas.w, dims22.w);
+
+    STBNData dataSC(dims22);
+    SliceCacheController2Dx2D vccSC(dataSC, kx22, ky22, kz22, kw22);
+    VoidAndCluster vcSC(ibpd, &vccSC);
+    RunAllPhases(vcSC);
+
+    STBNData dataRef(dims22);
+    ReferenceController2Dx2D vccRef(dataRef, kx22, ky22, kz22, kw22);
+    VoidAndCluster vcRef(ibpd, &vccRef);
+    RunAllPhases(vcRef);
+
+    EXPECT_EQ(dataSC.energy, dataRef.energy);
+    EXPECT_EQ(dataSC.pixelRank, dataRef.pixelRank);
+}
+
+TEST(BrickedLayout, TexturesAreLinear)
+{
+    STBNMaker maker(dims, sigmas, ibpd, ScalarImplementation::SliceCache_2Dx1Dx1D);
+    maker.Make();
+    BlueNoiseTexturesND textures = maker.GetBlueNoiseTextures();
+
+    // Texture pixel (x,y,z) is linear, the STBN data is bricked
+    const STBNData& data = maker.GetVoidAndCluster()->GetSTBNData();
+    const std::vector<Pixel>& pixels = textures.GetPixels();
+    size_t numPixels = pixels.size();
+    std::vector<size_t> ranks(numPixels);
+    for (size_t z = 0; z < dims.z; ++z)
+    {
+        for (size_t y = 0; y < dims.y; ++y)
+        {
+            for (size_t x = 0; x < dims.x; ++x)
+            {
+                size_t linearIndex = (z * dims.y + y) * dims.x + x;
+                ranks[linearIndex] = size_t(pixels[linearIndex].rank);
+                EXPECT_EQ(ranks[linearIndex], data.pixelRank[PixelCoordsToPixelIndex({ x, y, z, 0 }, dims)]);
+            }
+        }
+    }
+
+    std::sort(ranks.begin(), ranks.end());
+    std::vector<size_t> expected(numPixels);
+    std::iota(expected.begin(), expected.end(), size_t(0));
+    EXPECT_EQ(ranks, expected);
+}
@@ -0,0 +1,85 @@
+#include "gtest/gtest.h"
+
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "Kernel/BlueNoiseGaussianKernel.h"
+#include "STBNData.h"
+#include "STBNMaker.h"
+#include "Utils/PixelCoords.h"
+
+static Dimensions dims = { 16, 16, 8, 2 };
+static SigmaPerDimension sigmas = { 1.9f, 1.9f, 1.9f, 1.9f };
+static BlueNoiseGaussianKernel kx(sigmas.x, dims.x);
+static BlueNoiseGaussianKernel ky(sigmas.y, dims.y);
+static BlueNoiseGaussianKernel kz(sigmas.z, dims.z);
+static BlueNoiseGaussianKernel kw(sigmas.w, dims.w);
+
+static const ScalarImplementation c_implementations[] =
+{
+    ScalarImplementation::Reference_2Dx1Dx1D,
+    ScalarImplementation::SliceCache_2Dx1Dx1D,
+    ScalarImplementation::SliceCache_ND,
+    ScalarImplementation::Auto_2Dx1Dx1D,
+    ScalarImplementation::FixedPoint64_2Dx1Dx1D
+};
+
+static std::vector<size_t> RandomPixels(size_t count, unsigned int seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<size_t> dist(0, dims.x * dims.y * dims.z * dims.w - 1);
+    std::vector<size_t> ret(count);
+    for (size_t& pixelIndex : ret)
+        pixelIndex = dist(rng);
+    return ret;
+}
+
+// The bulk ops must leave each engine in the same state as the per pixel ops, caches included
+TEST(BulkOps, MatchPerPixelOps)
+{
+    std::vector<size_t> onPixels = RandomPixels(300, 1);
+    std::vector<size_t> offPixels = RandomPixels(20, 2);
+
+    for (ScalarImplementation implementation : c_implementations)
+    {
+        STBNData dataBulk(dims);
+        STBNData dataSingle(dims);
+        std::unique_ptr<VCController> bulk = MakeVCController(implementation, dataBulk, kx, ky, kz, kw);
+        std::unique_ptr<VCController> single = MakeVCController(implementation, dataSingle, kx, ky, kz, kw);
+
+        for (size_t pixelIndex : onPixels)
+        {
+            bulk->SplatOn(PixelIndexToPixelCoords(pixelIndex, dims));
+            single->SplatOn(PixelIndexToPixelCoords(pixelIndex, dims));
+        }
+        bulk->GetTightestCluster();
+        single->GetTightestCluster();
+
+        bulk->SetPixelsOn(onPixels, true);
+        for (size_t pixelIndex : onPixels)
+            single->SetPixelOn(pixelIndex, true);
+        bulk->SetPixelsOn(offPixels, false);
+        for (size_t pixelIndex : offPixels)
+            single->SetPixelOn(pixelIndex, false);
+
+        EXPECT_EQ(dataBulk.pixelOn, dataSingle.pixelOn);
+        EXPECT_EQ(bulk->GetPixelOnCount(), single->GetPixelOnCount());
+        EXPECT_EQ(bulk->GetTightestCluster(), single->GetTightestCluster());
+        EXPECT_EQ(bulk->GetLargestVoid(), single->GetLargestVoid());
+
+        bulk->InvertAllPixels();
+        for (size_t pixelIndex = 0; pixelIndex < dataSingle.numPixels; ++pixelIndex)
+            single->InvertPixelOn(pixelIndex);
+
+        EXPECT_EQ(dataBulk.pixelOn, dataSingle.pixelOn);
+        EXPECT_EQ(bulk->GetPixelOnCount(), single->GetPixelOnCount());
+        EXPECT_EQ(bulk->GetTightestCluster(), single->GetTightestCluster());
+        EXPECT_EQ(bulk->GetLargestVoid(), single->GetLargestVoid());
+
+        bulk->SetRanks(offPixels, 10);
+        for (size_t index = 0; index < offPixels.size(); ++index)
+            single->SetPixelRank(offPixels[index], 10 + index);
+        EXPECT_EQ(dataBulk.pixelRank, dataSingle.pixelRank);
+    }
+}
\ No newline at end of file
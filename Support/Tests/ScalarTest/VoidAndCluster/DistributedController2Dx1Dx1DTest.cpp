@@ -0,0 +1,62 @@
+#include "gtest/gtest.h"
+
+#include "STBNData.h"
+#include "STBNMaker.h"
+
+#include "VoidAndCluster/Distributed/DistributedController2Dx1Dx1D.h"
+#include "VoidAndCluster/VoidAndCluster.h"
+
+static SigmaPerDimension sigmas = { 1.9f, 1.9f, 1.9f, 1.9f };
+static float ibpd = 0.1f;
+
+static const ArenaVector<size_t>& GetSliceCacheRanks(const Dimensions& dims)
+{
+    static STBNMaker maker32x32x16(Dimensions{ 32, 32, 16, 1 }, sigmas, ibpd, ScalarImplementation::SliceCache_2Dx1Dx1D);
+    static STBNMaker maker16x16x8x2(Dimensions{ 16, 16, 8, 2 }, sigmas, ibpd, ScalarImplementation::SliceCache_2Dx1Dx1D);
+    static bool made = false;
+    if (!made)
+    {
+        maker32x32x16.Make();
+        maker16x16x8x2.Make();
+        made = true;
+    }
+
+    STBNMaker& maker = (dims.w == 1) ? maker32x32x16 : maker16x16x8x2;
+    return maker.GetVoidAndCluster()->GetSTBNData().pixelRank;
+}
+
+static void ExpectMatchesSliceCache(const Dimensions& dims, const TileOptions& tileOptions)
+{
+    STBNMaker maker(dims, sigmas, ibpd, ScalarImplementation::Distributed_2Dx1Dx1D, { 0, 0, 1, 2 }, tileOptions);
+    maker.Make();
+
+    EXPECT_EQ(maker.GetVoidAndCluster()->GetSTBNData().pixelRank, GetSliceCacheRanks(dims));
+    EXPECT_TRUE(maker.GetVoidAndCluster()->GetSTBNData().energy.empty());
+}
+
+TEST(DistributedController2Dx1Dx1D, ThreadsMatchSliceCache)
+{
+    ExpectMatchesSliceCache({ 32, 32, 16, 1 }, { 3, TileTransport::Threads });
+}
+
+TEST(DistributedController2Dx1Dx1D, ProcessesMatchSliceCache)
+{
+    ExpectMatchesSliceCache({ 32, 32, 16, 1 }, { 3, TileTransport::Processes });
+}
+
+TEST(DistributedController2Dx1Dx1D, TilesAcrossW)
+{
+    // 5 tiles over 16 slices, so tiles straddle the W boundary
+    ExpectMatchesSliceCache({ 16, 16, 8, 2 }, { 5, TileTransport::Threads });
+}
+
+TEST(DistributedController2Dx1Dx1D, TileCountClamped)
+{
+    Dimensions dims = { 8, 8, 2, 1 };
+    STBNData data(dims, false);
+    BlueNoiseGaussianKernel kernel(1.9f, 8);
+    BlueNoiseGaussianKernel kernelZ(1.9f, 2);
+    DistributedController2Dx1Dx1D vcc(data, kernel, kernel, kernelZ, kernelZ, { 8, TileTransport::Threads });
+
+    EXPECT_EQ(vcc.GetNumTiles(), size_t(2));
+}
\ No newline at end of file
@@ -0,0 +1,98 @@
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "Kernel/BlueNoiseGaussianKernel.h"
+#include "STBNData.h"
+#include "STBNMaker.h"
+#include "Utils/PixelCoords.h"
+
+#include "VoidAndCluster/FixedPoint/FixedPointController2Dx1Dx1D.h"
+#include "VoidAndCluster/Reference/ReferenceController2Dx1Dx1D.h"
+#include "VoidAndCluster/VoidAndCluster.h"
+
+static Dimensions dims = { 32, 32, 16, 1 };
+static SigmaPerDimension sigmas = { 1.9f, 1.9f, 1.9f, 1.9f };
+static BlueNoiseGaussianKernel kx(sigmas.x, dims.x);
+static BlueNoiseGaussianKernel ky(sigmas.y, dims.y);
+static BlueNoiseGaussianKernel kz(sigmas.z, dims.z);
+static BlueNoiseGaussianKernel kw(sigmas.w, dims.w);
+
+static std::vector<size_t> RandomPixels(size_t count, unsigned int seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<size_t> dist(0, dims.x * dims.y * dims.z * dims.w - 1);
+    std::vector<size_t> ret(count);
+    for (size_t& pixelIndex : ret)
+        pixelIndex = dist(rng);
+    return ret;
+}
+
+TEST(FixedPointController2Dx1Dx1D, SplatOffUndoesSplatOn)
+{
+    STBNData data(dims);
+    FixedPointController2Dx1Dx1D<int32_t> vcc(data, kx, ky, kz, kw);
+
+    std::vector<size_t> pixels = RandomPixels(1000, 1);
+    for (size_t pixelIndex : pixels)
+        vcc.SplatOn(PixelIndexToPixelCoords(pixelIndex, dims));
+    std::shuffle(pixels.begin(), pixels.end(), std::mt19937(2));
+    for (size_t pixelIndex : pixels)
+        vcc.SplatOff(PixelIndexToPixelCoords(pixelIndex, dims));
+
+    for (int32_t energy : vcc.GetEnergy())
+        EXPECT_EQ(energy, 0);
+}
+
+TEST(FixedPointController2Dx1Dx1D, SplatOrderIndependent)
+{
+    STBNData dataA(dims);
+    STBNData dataB(dims);
+    FixedPointController2Dx1Dx1D<int64_t> vccA(dataA, kx, ky, kz, kw);
+    FixedPointController2Dx1Dx1D<int64_t> vccB(dataB, kx, ky, kz, kw);
+
+    std::vector<size_t> pixels = RandomPixels(1000, 3);
+    for (size_t pixelIndex : pixels)
+        vccA.SplatOn(PixelIndexToPixelCoords(pixelIndex, dims));
+    std::reverse(pixels.begin(), pixels.end());
+    for (size_t pixelIndex : pixels)
+        vccB.SplatOn(PixelIndexToPixelCoords(pixelIndex, dims));
+
+    EXPECT_TRUE(vccA.GetEnergy() == vccB.GetEnergy());
+}
+
+TEST(FixedPointController2Dx1Dx1D, EnergyMatchesFloat)
+{
+    STBNData dataFixed(dims);
+    STBNData dataRef(dims);
+    FixedPointController2Dx1Dx1D<int32_t> vccFixed(dataFixed, kx, ky, kz, kw);
+    ReferenceController2Dx1Dx1D vccRef(dataRef, kx, ky, kz, kw);
+
+    for (size_t pixelIndex : RandomPixels(1000, 4))
+    {
+        vccFixed.SplatOn(PixelIndexToPixelCoords(pixelIndex, dims));
+        vccRef.SplatOn(PixelIndexToPixelCoords(pixelIndex, dims));
+    }
+
+    EXPECT_GT(vccFixed.GetFractionBits(), 20);
+    for (size_t pixelIndex = 0; pixelIndex < dataRef.numPixels; ++pixelIndex)
+        EXPECT_NEAR(std::ldexp(double(vccFixed.GetEnergy()[pixelIndex]), -vccFixed.GetFractionBits()), dataRef.energy[pixelIndex], 1e-4);
+}
+
+TEST(FixedPointController2Dx1Dx1D, RanksArePermutation)
+{
+    STBNMaker maker(dims, sigmas, 0.1f, ScalarImplementation::FixedPoint32_2Dx1Dx1D);
+    maker.Make();
+
+    // The energy is only kept in the controller
+    EXPECT_TRUE(maker.GetVoidAndCluster()->GetSTBNData().energy.empty());
+
+    const ArenaVector<size_t>& pixelRank = maker.GetVoidAndCluster()->GetSTBNData().pixelRank;
+    std::vector<size_t> sortedRanks(pixelRank.begin(), pixelRank.end());
+    std::sort(sortedRanks.begin(), sortedRanks.end());
+    for (size_t rank = 0; rank < sortedRanks.size(); ++rank)
+        EXPECT_EQ(sortedRanks[rank], rank);
+}
\ No newline at end of file
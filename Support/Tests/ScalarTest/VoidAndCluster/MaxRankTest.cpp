@@ -0,0 +1,70 @@
+#include "gtest/gtest.h"
+
+#include "STBNData.h"
+#include "STBNMaker.h"
+
+#include "VoidAndCluster/VoidAndCluster.h"
+
+static Dimensions dims = { 32, 32, 8, 1 };
+static SigmaPerDimension sigmas = { 1.9f, 1.9f, 1.9f, 1.9f };
+static float ibpd = 0.1f;
+
+static const ArenaVector<size_t>& GetFullRanks()
+{
+    static STBNMaker maker(dims, sigmas, ibpd, ScalarImplementation::SliceCache_2Dx1Dx1D);
+    static bool made = false;
+    if (!made)
+    {
+        maker.Make();
+        made = true;
+    }
+    return maker.GetVoidAndCluster()->GetSTBNData().pixelRank;
+}
+
+// Ranks below maxRank match a full run, except that Phase 1 always ranks the whole initial pattern
+static void ExpectFirstRanksMatch(size_t maxRank)
+{
+    STBNMaker maker(dims, sigmas, ibpd, ScalarImplementation::SliceCache_2Dx1Dx1D);
+    maker.SetMaxRank(maxRank);
+    maker.Make();
+
+    const VoidAndCluster* vc = maker.GetVoidAndCluster();
+    const ArenaVector<size_t>& fullRanks = GetFullRanks();
+    const ArenaVector<size_t>& ranks = vc->GetSTBNData().pixelRank;
+    size_t numRanked = std::max(maxRank, vc->GetProgressData().phase1Part1OnesCountTotal);
+
+    size_t ranked = 0;
+    for (size_t pixelIndex = 0; pixelIndex < vc->GetNumPixels(); ++pixelIndex)
+    {
+        if (fullRanks[pixelIndex] < numRanked)
+        {
+            EXPECT_EQ(ranks[pixelIndex], fullRanks[pixelIndex]);
+            ranked++;
+        }
+        else
+        {
+            EXPECT_EQ(ranks[pixelIndex], vc->GetNumPixels());
+        }
+    }
+    EXPECT_EQ(ranked, numRanked);
+}
+
+TEST(MaxRank, WithinPhase1)
+{
+    ExpectFirstRanksMatch(100);
+}
+
+TEST(MaxRank, WithinPhase2)
+{
+    ExpectFirstRanksMatch(3000);
+}
+
+TEST(MaxRank, WithinPhase3)
+{
+    ExpectFirstRanksMatch(6000);
+}
+
+TEST(MaxRank, AllRanks)
+{
+    ExpectFirstRanksMatch(dims.x * dims.y * dims.z * dims.w);
+}
\ No newline at end of file
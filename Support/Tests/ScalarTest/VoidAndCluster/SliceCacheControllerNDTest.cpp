@@ -0,0 +1,145 @@
+#include "gtest/gtest.h"
+
+#include "BlueNoiseTexturesND.h"
+#include "Kernel/BlueNoiseGaussianKernel.h"
+#include "STBNData.h"
+#include "Utils/PixelCoords.h"
+
+#include "VoidAndCluster/Reference/ReferenceController2Dx1Dx1D.h"
+#include "VoidAndCluster/Reference/ReferenceController2Dx2D.h"
+#include "VoidAndCluster/Reference/ReferenceFuncs.h"
+#include "VoidAndCluster/SliceCache/SliceCacheControllerND.h"
+#include "VoidAndCluster/VoidAndCluster.h"
+
+static SigmaPerDimension sigmas = { 1.9f, 1.9f, 1.9f, 1.9f };
+static float ibpd = 0.1f;
+
+// Reference for groups { 0, 1, 0, 2 }, where the largest group (XZ) isn't contiguous in memory
+class ReferenceControllerXZxYxW : public VCController
+{
+public:
+    ReferenceControllerXZxYxW(STBNData& data, SymmetricKernel kernelX, SymmetricKernel kernelY, SymmetricKernel kernelZ, SymmetricKernel kernelW) :
+        m_data(data), m_kernelX(kernelX), m_kernelY(kernelY), m_kernelZ(kernelZ), m_kernelW(kernelW)
+    {
+    }
+
+    virtual STBNData& GetSTBNData() override { return m_data; }
+    virtual size_t GetPixelOnCount() const override { return ReferenceFuncs::GetPixelOnCount(m_data); }
+    virtual size_t GetTightestCluster() override { return ReferenceFuncs::GetTightestCluster(m_data); }
+    virtual size_t GetLargestVoid() override { return ReferenceFuncs::GetLargestVoid(m_data); }
+
+    virtual void SplatOn(const PixelCoords& pixelCoords) override
+    {
+        ReferenceFuncs::SplatOn2D(m_data, pixelCoords, 2, m_kernelZ, 0, m_kernelX);
+        ReferenceFuncs::SplatOn1D(m_data, pixelCoords, 1, m_kernelY);
+        ReferenceFuncs::SplatOn1D(m_data, pixelCoords, 3, m_kernelW);
+    }
+
+    virtual void SplatOff(const PixelCoords& pixelCoords) override
+    {
+        ReferenceFuncs::SplatOff2D(m_data, pixelCoords, 2, m_kernelZ, 0, m_kernelX);
+        ReferenceFuncs::SplatOff1D(m_data, pixelCoords, 1, m_kernelY);
+        ReferenceFuncs::SplatOff1D(m_data, pixelCoords, 3, m_kernelW);
+    }
+
+    virtual void SetPixelOn(size_t pixelIndex, bool value) override { ReferenceFuncs::SetPixelOn(m_data, pixelIndex, value); }
+    virtual void SetPixelRank(size_t pixelIndex, size_t rank) override { ReferenceFuncs::SetPixelRank(m_data, pixelIndex, rank); }
+    virtual void SetAllEnergyToZero() override { ReferenceFuncs::SetAllEnergyToZero(m_data); }
+    virtual void InvertPixelOn(size_t pixelIndex) override { ReferenceFuncs::InvertPixelOn(m_data, pixelIndex); }
+    virtual void InvertAllPixels() override { ReferenceFuncs::InvertAllPixels(m_data); }
+    virtual void SetPixelsOn(std::span<const size_t> pixelIndices, bool value) override { ReferenceFuncs::SetPixelsOn(m_data, pixelIndices, value); }
+    virtual void SetRanks(std::span<const size_t> pixelIndices, size_t firstRank) override { ReferenceFuncs::SetRanks(m_data, pixelIndices, firstRank); }
+
+private:
+    STBNData& m_data;
+    SymmetricKernel m_kernelX;
+    SymmetricKernel m_kernelY;
+    SymmetricKernel m_kernelZ;
+    SymmetricKernel m_kernelW;
+};
+
+static void RunAllPhases(VoidAndCluster& vc)
+{
+    vc.InitializeToWhiteNoise();
+    vc.ReorganizeToBlueNoise();
+    vc.Phase1();
+    vc.Phase2();
+    vc.Phase3();
+}
+
+TEST(SliceCacheControllerND, MasksToSplatAndSliceDims)
+{
+    Dimensions dims = { 16, 16, 8, 1 };
+    BlueNoiseGaussianKernel kx(sigmas.x, dims.x), ky(sigmas.y, dims.y), kz(sigmas.z, dims.z), kw(sigmas.w, dims.w);
+    STBNData data(dims);
+
+    SliceCacheControllerND vcc211(data, BlueNoiseTexturesND::MakeGroupMasks({ 0, 0, 1, 2 }, 4), kx, ky, kz, kw);
+    EXPECT_EQ(vcc211.GetSplatDims(), std::vector<unsigned int>({ 3, 4, 8 }));
+    EXPECT_EQ(vcc211.GetSliceDims(), 3u);
+
+    // Group numbers and mask order don't matter, splats go in order of each group's lowest dimension
+    SliceCacheControllerND vcc1011(data, { 13, 2 }, kx, ky, kz, kw);
+    EXPECT_EQ(vcc1011.GetSplatDims(), std::vector<unsigned int>({ 13, 2 }));
+    EXPECT_EQ(vcc1011.GetSliceDims(), 13u);
+}
+
+TEST(SliceCacheControllerND, Matches2Dx1Dx1DReference)
+{
+    Dimensions dims = { 32, 32, 8, 1 };
+    BlueNoiseGaussianKernel kx(sigmas.x, dims.x), ky(sigmas.y, dims.y), kz(sigmas.z, dims.z), kw(sigmas.w, dims.w);
+
+    STBNData dataND(dims);
+    SliceCacheControllerND vccND(dataND, BlueNoiseTexturesND::MakeGroupMasks({ 0, 0, 1, 2 }, 4), kx, ky, kz, kw);
+    VoidAndCluster vcND(ibpd, &vccND);
+
+    STBNData dataRef(dims);
+    ReferenceController2Dx1Dx1D vccRef(dataRef, kx, ky, kz, kw);
+    VoidAndCluster vcRef(ibpd, &vccRef);
+
+    RunAllPhases(vcND);
+    RunAllPhases(vcRef);
+
+    EXPECT_EQ(dataND.energy, dataRef.energy);
+    EXPECT_EQ(dataND.pixelRank, dataRef.pixelRank);
+}
+
+TEST(SliceCacheControllerND, Matches2Dx2DReference)
+{
+    Dimensions dims = { 16, 16, 4, 4 };
+    BlueNoiseGaussianKernel kx(sigmas.x, dims.x), ky(sigmas.y, dims.y), kz(sigmas.z, dims.z), kw(sigmas.w, dims.w);
+
+    STBNData dataND(dims);
+    SliceCacheControllerND vccND(dataND, BlueNoiseTexturesND::MakeGroupMasks({ 0, 0, 1, 1 }, 4), kx, ky, kz, kw);
+    VoidAndCluster vcND(ibpd, &vccND);
+
+    STBNData dataRef(dims);
+    ReferenceController2Dx2D vccRef(dataRef, kx, ky, kz, kw);
+    VoidAndCluster vcRef(ibpd, &vccRef);
+
+    RunAllPhases(vcND);
+    RunAllPhases(vcRef);
+
+    EXPECT_EQ(dataND.energy, dataRef.energy);
+    EXPECT_EQ(dataND.pixelRank, dataRef.pixelRank);
+}
+
+TEST(SliceCacheControllerND, NonContiguousSlicesMatchReference)
+{
+    Dimensions dims = { 16, 8, 16, 1 };
+    BlueNoiseGaussianKernel kx(sigmas.x, dims.x), ky(sigmas.y, dims.y), kz(sigmas.z, dims.z), kw(sigmas.w, dims.w);
+
+    STBNData dataND(dims);
+    SliceCacheControllerND vccND(dataND, BlueNoiseTexturesND::MakeGroupMasks({ 0, 1, 0, 2 }, 4), kx, ky, kz, kw);
+    VoidAndCluster vcND(ibpd, &vccND);
+    EXPECT_EQ(vccND.GetSliceDims(), 5u);
+
+    STBNData dataRef(dims);
+    ReferenceControllerXZxYxW vccRef(dataRef, kx, ky, kz, kw);
+    VoidAndCluster vcRef(ibpd, &vccRef);
+
+    RunAllPhases(vcND);
+    RunAllPhases(vcRef);
+
+    EXPECT_EQ(dataND.energy, dataRef.energy);
+    EXPECT_EQ(dataND.pixelRank, dataRef.pixelRank);
+}
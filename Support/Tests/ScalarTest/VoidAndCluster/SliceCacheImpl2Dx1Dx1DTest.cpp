@@ -132,6 +132,40 @@ TEST(SliceCacheImpl, RandomSplatClusterVoidTest)
     EXPECT_EQ(updaterSC.GetLargestVoid(), updaterRef.GetLargestVoid());
 }
 
+TEST(SliceCacheImpl, RandomSplatWithWeightsXY)
+{
+    size_t cubeSide = 16;
+    Dimensions dimensions{ cubeSide, cubeSide, cubeSide, 1 };
+    BlueNoiseGaussianKernel kernelX(1.9f, cubeSide);
+    ConstantKernel kernelY(3.0f, 2);
+
+    STBNData dataSC(dimensions);
+    SliceCacheImpl updaterSC(dataSC, SliceCacheImpl::MakeWeightsXY(kernelY, kernelX));
+    STBNData dataRef(dimensions);
+    ReferenceImpl2Dx1Dx1D updaterRef(dataRef);
+    std::vector<VCImpl*> impls = { &updaterSC, &updaterRef };
+
+    for (auto& impl : impls)
+    {
+        std::default_random_engine rng(1337);
+        std::uniform_int_distribution dist(0, static_cast<int>(cubeSide - 1));
+        for (int i = 0; i < cubeSide * cubeSide * 3; i++)
+        {
+            PixelCoords pixelCoords = { dist(rng), dist(rng), dist(rng), 0 };
+            impl->SplatOnXY(pixelCoords, kernelY, kernelX);
+            impl->SetPixelOn(PixelCoordsToPixelIndex(pixelCoords, dimensions), true);
+
+            pixelCoords.x = dist(rng); pixelCoords.y = dist(rng); pixelCoords.z = dist(rng);
+            impl->SplatOffXY(pixelCoords, kernelY, kernelX);
+            impl->SetPixelOn(PixelCoordsToPixelIndex(pixelCoords, dimensions), false);
+        }
+    }
+
+    EXPECT_EQ(dataSC.energy, dataRef.energy);
+    EXPECT_EQ(updaterSC.GetTightestCluster(), updaterRef.GetTightestCluster());
+    EXPECT_EQ(updaterSC.GetLargestVoid(), updaterRef.GetLargestVoid());
+}
+
 void initializeToWhiteNoise(VCImpl* impl, const Dimensions& dims)
 {
     static BlueNoiseGaussianKernel kernel(1.9f, std::min(dims.x, std::min(dims.y, dims.z)));
@@ -0,0 +1,72 @@
+#include "gtest/gtest.h"
+
+#include <cfloat>
+#include <random>
+#include <vector>
+
+#include "Utils/PixelBitset.h"
+#include "VoidAndCluster/SliceCache/SliceScan.h"
+
+static const size_t c_numPixels = 300;
+
+static void ExpectSameAsScalar(CPUISA isa)
+{
+    if (!IsISASupported(isa))
+        GTEST_SKIP() << ISAToString(isa) << " isn't supported here";
+
+    SliceScanFuncs scalar = GetSliceScanFuncs(CPUISA::Scalar);
+    SliceScanFuncs vector = GetSliceScanFuncs(isa);
+    ASSERT_EQ(vector.isa, isa);
+
+    // Energies are small multiples of 1/4 so there are lots of exact ties, with each other and the incoming best
+    std::mt19937 rng(1);
+    std::uniform_int_distribution<int> quarters(0, 12);
+    std::uniform_int_distribution<int> onPercent(0, 100);
+    std::uniform_int_distribution<size_t> pixel(0, c_numPixels - 1);
+    for (int test = 0; test < 2000; ++test)
+    {
+        std::vector<float> energy(c_numPixels);
+        PixelBitset pixelOn(c_numPixels);
+        int percent = onPercent(rng);
+        for (size_t pixelIndex = 0; pixelIndex < c_numPixels; ++pixelIndex)
+        {
+            energy[pixelIndex] = float(quarters(rng)) / 4.0f;
+            pixelOn.Set(pixelIndex, onPercent(rng) < percent);
+        }
+
+        size_t begin = pixel(rng);
+        size_t end = std::min(begin + pixel(rng), c_numPixels);
+        bool max = (test % 2) == 0;
+        float startValue = (test % 4) < 2 ? (max ? -FLT_MAX : FLT_MAX) : float(quarters(rng)) / 4.0f;
+        size_t startIndex = pixel(rng);
+
+        float scalarValue = startValue;
+        size_t scalarIndex = startIndex;
+        (max ? scalar.max : scalar.min)(energy.data(), pixelOn, begin, end, scalarValue, scalarIndex);
+
+        float vectorValue = startValue;
+        size_t vectorIndex = startIndex;
+        (max ? vector.max : vector.min)(energy.data(), pixelOn, begin, end, vectorValue, vectorIndex);
+
+        ASSERT_EQ(vectorValue, scalarValue);
+        ASSERT_EQ(vectorIndex, scalarIndex);
+    }
+}
+
+TEST(SliceScan, AVX2MatchesScalar)
+{
+    ExpectSameAsScalar(CPUISA::AVX2);
+}
+
+TEST(SliceScan, AVX512MatchesScalar)
+{
+    ExpectSameAsScalar(CPUISA::AVX512);
+}
+
+TEST(CPUDispatch, FallsBackToNarrowerVersions)
+{
+    ISADispatch<int> dispatch(1, 2, 0);
+    EXPECT_EQ(dispatch.Get(CPUISA::Scalar), 1);
+    EXPECT_EQ(dispatch.Resolve(CPUISA::AVX512), IsISASupported(CPUISA::AVX2) ? CPUISA::AVX2 : CPUISA::Scalar);
+    EXPECT_TRUE(IsISASupported(GetSelectedISA()));
+}
\ No newline at end of file
@@ -0,0 +1,79 @@
+#include "gtest/gtest.h"
+
+#include <random>
+#include <vector>
+
+#include "Utils/PixelBitset.h"
+#include "VoidAndCluster/SliceCache/SplatRow.h"
+
+static const size_t c_numPixels = 256;
+
+struct SplatRowCase
+{
+    std::vector<float> energy;
+    std::vector<float> weights;
+    PixelBitset pixelOn;
+    SplatRowCache cache;
+};
+
+// Energies and weights are small multiples of 1/4 so there are lots of exact ties with each other and the cache
+static SplatRowCase MakeCase(std::mt19937& rng)
+{
+    std::uniform_int_distribution<int> quarters(0, 12);
+    std::uniform_int_distribution<int> coin(0, 1);
+    std::uniform_int_distribution<size_t> pixel(0, c_numPixels - 1);
+
+    SplatRowCase ret;
+    ret.pixelOn.resize(c_numPixels);
+    for (size_t pixelIndex = 0; pixelIndex < c_numPixels; ++pixelIndex)
+    {
+        ret.energy.push_back(float(quarters(rng)) / 4.0f);
+        ret.weights.push_back(float(quarters(rng)) / 4.0f);
+        ret.pixelOn.Set(pixelIndex, coin(rng) != 0);
+    }
+    ret.cache = { coin(rng) != 0, float(quarters(rng)) / 4.0f, pixel(rng), coin(rng) != 0, float(quarters(rng)) / 4.0f, pixel(rng) };
+    return ret;
+}
+
+static void ExpectSameAsScalar(CPUISA isa)
+{
+    if (!IsISASupported(isa))
+        GTEST_SKIP() << ISAToString(isa) << " isn't supported here";
+
+    SplatRowFuncs scalar = GetSplatRowFuncs(CPUISA::Scalar);
+    SplatRowFuncs vector = GetSplatRowFuncs(isa);
+    ASSERT_EQ(vector.isa, isa);
+
+    std::mt19937 rng(1);
+    std::uniform_int_distribution<size_t> start(0, 100);
+    std::uniform_int_distribution<size_t> count(0, 70);
+    for (int test = 0; test < 2000; ++test)
+    {
+        SplatRowCase scalarCase = MakeCase(rng);
+        SplatRowCase vectorCase = scalarCase;
+        size_t firstPixelIndex = start(rng);
+        size_t numPixels = count(rng);
+        bool on = (test % 2) == 0;
+
+        (on ? scalar.on : scalar.off)(scalarCase.energy.data(), scalarCase.weights.data(), numPixels, scalarCase.pixelOn, firstPixelIndex, scalarCase.cache);
+        (on ? vector.on : vector.off)(vectorCase.energy.data(), vectorCase.weights.data(), numPixels, vectorCase.pixelOn, firstPixelIndex, vectorCase.cache);
+
+        ASSERT_EQ(vectorCase.energy, scalarCase.energy);
+        ASSERT_EQ(vectorCase.cache.dirtyMin, scalarCase.cache.dirtyMin);
+        ASSERT_EQ(vectorCase.cache.minValue, scalarCase.cache.minValue);
+        ASSERT_EQ(vectorCase.cache.minValueIndex, scalarCase.cache.minValueIndex);
+        ASSERT_EQ(vectorCase.cache.dirtyMax, scalarCase.cache.dirtyMax);
+        ASSERT_EQ(vectorCase.cache.maxValue, scalarCase.cache.maxValue);
+        ASSERT_EQ(vectorCase.cache.maxValueIndex, scalarCase.cache.maxValueIndex);
+    }
+}
+
+TEST(SplatRow, AVX2MatchesScalar)
+{
+    ExpectSameAsScalar(CPUISA::AVX2);
+}
+
+TEST(SplatRow, AVX512MatchesScalar)
+{
+    ExpectSameAsScalar(CPUISA::AVX512);
+}
\ No newline at end of file
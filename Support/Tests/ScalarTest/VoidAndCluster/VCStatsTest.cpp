@@ -0,0 +1,71 @@
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <sstream>
+
+#include "STBNMaker.h"
+
+#include "VoidAndCluster/VCStats.h"
+#include "VoidAndCluster/VoidAndCluster.h"
+
+static Dimensions dims = { 32, 32, 8, 1 };
+static SigmaPerDimension sigmas = { 1.9f, 1.9f, 1.9f, 1.9f };
+static float ibpd = 0.1f;
+
+static const VCPhaseStats& GetPhase(const VCStats& stats, VCPhase phase)
+{
+    return stats.phases[(size_t)phase];
+}
+
+TEST(VCStats, HistogramBucketsArePowersOfTwo)
+{
+    LatencyHistogram histogram;
+    histogram.Add(std::chrono::nanoseconds(0));
+    histogram.Add(std::chrono::nanoseconds(1));
+    histogram.Add(std::chrono::nanoseconds(3));
+    histogram.Add(std::chrono::nanoseconds(4));
+    histogram.Add(std::chrono::nanoseconds(1000));
+
+    EXPECT_EQ(histogram.buckets[0], size_t(2));
+    EXPECT_EQ(histogram.buckets[1], size_t(1));
+    EXPECT_EQ(histogram.buckets[2], size_t(1));
+    EXPECT_EQ(histogram.buckets[9], size_t(1));
+    EXPECT_EQ(histogram.count, size_t(5));
+    EXPECT_EQ(histogram.totalNs, uint64_t(1008));
+    EXPECT_EQ(histogram.maxNs, uint64_t(1000));
+}
+
+TEST(VCStats, JSONHasEveryPhase)
+{
+    VCStats stats;
+    std::stringstream ss;
+    WriteVCStatsJSON(stats, ss);
+    for (size_t phase = 0; phase < (size_t)VCPhase::Count; ++phase)
+        EXPECT_NE(ss.str().find(VCPhaseToString(VCPhase(phase))), std::string::npos);
+}
+
+// Query counts follow from the phase progress data, and every engine counter is filled in by the slice cache engine
+TEST(VCStats, CountsMatchPhases)
+{
+    STBNMaker maker(dims, sigmas, ibpd, ScalarImplementation::SliceCache_2Dx1Dx1D);
+    maker.Make();
+
+    const VCStats& stats = maker.GetVoidAndCluster()->GetStats();
+    const VoidAndClusterProgressData& pd = maker.GetVoidAndCluster()->GetProgressData();
+    if (!VC_STATS())
+    {
+        EXPECT_EQ(GetPhase(stats, VCPhase::Phase2).largestVoidQueries, size_t(0));
+        GTEST_SKIP() << "VC_STATS() is false in this build";
+    }
+
+    EXPECT_EQ(GetPhase(stats, VCPhase::ReorganizeToBlueNoise).tightestClusterQueries, pd.reorganizeToBlueNoiseIterationsSoFar);
+    EXPECT_EQ(GetPhase(stats, VCPhase::Phase1Part1).tightestClusterQueries, pd.phase1Part1OnesCountTotal);
+    EXPECT_EQ(GetPhase(stats, VCPhase::Phase2).largestVoidQueries, dims.x * dims.y * dims.z * dims.w / 2 - pd.phase1Part1OnesCountTotal);
+    EXPECT_EQ(GetPhase(stats, VCPhase::Phase3Part2).tightestClusterQueries, pd.phase3Part2OnesCountTotal);
+    EXPECT_EQ(GetPhase(stats, VCPhase::Phase2).largestVoidLatency.count, GetPhase(stats, VCPhase::Phase2).largestVoidQueries);
+
+    const VCPhaseStats& phase2 = GetPhase(stats, VCPhase::Phase2);
+    EXPECT_EQ(phase2.minCacheHits + phase2.minCacheMisses, phase2.largestVoidQueries * dims.z * dims.w);
+    EXPECT_EQ(phase2.pixelsScanned, phase2.slicesRescanned * dims.x * dims.y);
+    EXPECT_GT(phase2.splatTaps, phase2.splatsOn);
+}
\ No newline at end of file
@@ -0,0 +1,120 @@
+/*
+* Copyright (c) 2024, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "STBNRandom.h"
+#include "SimulatedAnnealing/CheckerboardTiles.h"
+#include "SimulatedAnnealing/SimulatedAnnealing.h"
+#include "Types/Float2.h"
+#include "ValueDistanceFunctions/ValueWeightPolicies.h"
+
+#include "SATestFixture.h"
+
+static size_t TorusDistance(size_t a, size_t b, size_t dim)
+{
+    size_t distance = (a > b) ? a - b : b - a;
+    return std::min(distance, dim - distance);
+}
+
+TEST(CheckerboardTiles, TilesCoverTorus)
+{
+    Dimensions3D dims = { 64, 40, 8 };
+    CheckerboardTiles tiles(dims, { 6, 6, 6 });
+
+    EXPECT_EQ(tiles.GetTileCounts().x, size_t(4));
+    EXPECT_EQ(tiles.GetTileCounts().y, size_t(2));
+    EXPECT_EQ(tiles.GetTileCounts().z, size_t(1));
+    EXPECT_EQ(tiles.NumColors(), size_t(4));
+
+    size_t numPixels = 0;
+    for (size_t color = 0; color < tiles.NumColors(); ++color)
+    {
+        for (size_t tile : tiles.GetTilesOfColor(color))
+            numPixels += tiles.TileNumPixels(tile);
+    }
+    EXPECT_EQ(numPixels, dims.NumPixels());
+}
+
+TEST(CheckerboardTiles, SameColorTilesAreOutOfReach)
+{
+    Dimensions3D dims = { 48, 48, 32 };
+    Dimensions3D reach = { 5, 5, 7 };
+    CheckerboardTiles tiles(dims, reach);
+    tiles.SetOffset({ 13, 40, 21 });
+
+    pcg32_random_t rng = GetRNG();
+    for (size_t color = 0; color < tiles.NumColors(); ++color)
+    {
+        const std::vector<size_t>& colorTiles = tiles.GetTilesOfColor(color);
+        for (size_t tileA : colorTiles)
+        {
+            for (size_t tileB : colorTiles)
+            {
+                if (tileA == tileB)
+                    continue;
+
+                for (int sample = 0; sample < 16; ++sample)
+                {
+                    PixelCoords3D a = PixelIndexToPixelCoords3D(tiles.RandomPixelInTile(tileA, rng), dims);
+                    PixelCoords3D b = PixelIndexToPixelCoords3D(tiles.RandomPixelInTile(tileB, rng), dims);
+                    bool separated = false;
+                    for (int axis = 0; axis < 3; ++axis)
+                        separated = separated || TorusDistance(a[axis], b[axis], dims.dim[axis]) > 2 * reach.dim[axis];
+                    EXPECT_TRUE(separated);
+                }
+            }
+        }
+    }
+}
+
+// Threads racing on the energy would leave Energy() out of step with the stored per pixel energies
+TEST(CheckerboardTiles, ParallelRunKeepsEnergyConsistent)
+{
+    Dimensions3D dims = { 32, 32, 4 };
+    pcg32_random_t rng = GetRNG();
+    RandomFloat2SA fixture(dims, rng);
+
+    SimulatedAnnealing<Float2, L1Weight> sa(dims, fixture.controller, 0.005f, 0.00001f);
+    sa.RunCheckerboard(rng, 4);
+
+    double storedEnergy = 0.0;
+    for (float energy : fixture.data.energy)
+        storedEnergy += double(energy);
+
+    EXPECT_EQ(sa.GetProgressData().swapIndex, sa.GetNumSwaps());
+    EXPECT_NEAR(fixture.controller.Energy(), float(storedEnergy), 1e-5f * float(storedEnergy));
+}
+
+// Each thread keeps its own RNG stream and the same share of every color's tiles, so a run is repeatable
+TEST(CheckerboardTiles, ParallelRunIsRepeatable)
+{
+    Dimensions3D dims = { 32, 32, 4 };
+    std::vector<Float2> results[2];
+    for (std::vector<Float2>& result : results)
+    {
+        pcg32_random_t rng = GetRNG();
+        RandomFloat2SA fixture(dims, rng);
+
+        SimulatedAnnealing<Float2, L1Weight> sa(dims, fixture.controller, 0.005f, 0.00001f);
+        sa.RunCheckerboard(rng, 3);
+        result.assign(fixture.data.cells.begin(), fixture.data.cells.end());
+    }
+
+    ASSERT_EQ(results[0].size(), results[1].size());
+    for (size_t index = 0; index < results[0].size(); ++index)
+    {
+        EXPECT_EQ(results[0][index].x, results[1][index].x);
+        EXPECT_EQ(results[0][index].y, results[1][index].y);
+    }
+}
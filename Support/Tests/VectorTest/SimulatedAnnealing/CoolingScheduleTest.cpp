@@ -0,0 +1,160 @@
+/*
+* Copyright (c) 2024, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+
+#include "STBNRandom.h"
+#include "SimulatedAnnealing/CoolingSchedule.h"
+#include "SimulatedAnnealing/SimulatedAnnealing.h"
+#include "Types/Float2.h"
+#include "ValueDistanceFunctions/ValueWeightPolicies.h"
+
+#include "SATestFixture.h"
+
+static const float coolingRate = 0.001f;
+static const size_t windowSwaps = 100;
+
+// Does numSwaps swaps one at a time, accepting each with acceptance
+static void RunSwaps(CoolingSchedule& schedule, SAProgressData& pd, size_t numSwaps, bool accept)
+{
+    for (size_t swap = 0; swap < numSwaps; ++swap)
+    {
+        schedule.Cool(pd, 1);
+        pd.swapIndex++;
+        schedule.Observe(pd, 1, accept ? 1 : 0);
+    }
+}
+
+TEST(CoolingSchedule, LinearMatchesFixedDecrement)
+{
+    CoolingSchedule schedule(CoolingScheduleParams(), coolingRate, windowSwaps);
+    SAProgressData pd = { 1.0f, 0, 5000, 0.0f };
+    schedule.Start(pd);
+
+    float expected = 1.0f;
+    for (size_t swap = 0; swap < 2000; ++swap)
+    {
+        expected = std::max(expected - coolingRate, 0.0f);
+        RunSwaps(schedule, pd, 1, false);
+        EXPECT_EQ(pd.temperature, expected);
+    }
+    EXPECT_EQ(pd.temperature, 0.0f);
+}
+
+TEST(CoolingSchedule, GeometricReachesFinalTemperature)
+{
+    CoolingScheduleParams params;
+    params.type = CoolingScheduleType::Geometric;
+    CoolingSchedule schedule(params, coolingRate, windowSwaps);
+    SAProgressData pd = { 1.0f, 0, 5000, 0.0f };
+    schedule.Start(pd);
+
+    RunSwaps(schedule, pd, 500, true);
+    EXPECT_NEAR(pd.temperature, std::sqrt(1e-3f), 1e-4f);
+    RunSwaps(schedule, pd, 500, true);
+    EXPECT_NEAR(pd.temperature, 1e-3f, 1e-5f);
+}
+
+TEST(CoolingSchedule, AdaptiveFollowsAcceptanceRate)
+{
+    CoolingScheduleParams params;
+    params.type = CoolingScheduleType::Adaptive;
+    CoolingSchedule schedule(params, coolingRate, windowSwaps);
+    SAProgressData pd = { 1.0f, 0, 5000, 0.0f };
+    schedule.Start(pd);
+
+    // Accepting everything is above the 0.44 target in the middle of the schedule, so it cools...
+    pd.swapIndex = 300;
+    RunSwaps(schedule, pd, 100, true);
+    float cooled = pd.temperature;
+    EXPECT_LT(cooled, 1.0f);
+
+    // ...and accepting nothing warms it back up
+    RunSwaps(schedule, pd, 100, false);
+    RunSwaps(schedule, pd, 100, false);
+    EXPECT_GT(pd.temperature, cooled);
+
+    EXPECT_NEAR(CoolingSchedule::TargetAcceptanceRate(0.0f), 1.0f, 1e-6f);
+    EXPECT_EQ(CoolingSchedule::TargetAcceptanceRate(0.4f), 0.44f);
+    EXPECT_NEAR(CoolingSchedule::TargetAcceptanceRate(1.0f), 0.001f, 1e-6f);
+}
+
+TEST(CoolingSchedule, EarlyStopAfterStalledWindows)
+{
+    CoolingScheduleParams params;
+    params.earlyStop = true;
+    CoolingSchedule schedule(params, coolingRate, windowSwaps);
+    SAProgressData pd = { 1.0f, 0, 5000, 0.0f };
+    schedule.Start(pd);
+
+    // The energy never changes, so windows stall as soon as they stop accepting swaps
+    RunSwaps(schedule, pd, (params.stallWindows - 1) * windowSwaps, false);
+    RunSwaps(schedule, pd, windowSwaps, true);
+    EXPECT_EQ(pd.stopReason, SAStopReason::Running);
+    EXPECT_EQ(pd.acceptanceRate, 1.0f);
+
+    RunSwaps(schedule, pd, params.stallWindows * windowSwaps - 1, false);
+    EXPECT_EQ(pd.stopReason, SAStopReason::Running);
+    RunSwaps(schedule, pd, 1, false);
+    EXPECT_EQ(pd.stopReason, SAStopReason::Converged);
+    EXPECT_EQ(pd.acceptanceRate, 0.0f);
+}
+
+TEST(CoolingSchedule, StopsAtSwapBudgetWithoutEarlyStop)
+{
+    CoolingSchedule schedule(CoolingScheduleParams(), coolingRate, windowSwaps);
+    SAProgressData pd = { 1.0f, 0, 5000, 0.0f };
+    schedule.Start(pd);
+
+    RunSwaps(schedule, pd, 4999, false);
+    EXPECT_EQ(pd.stopReason, SAStopReason::Running);
+    RunSwaps(schedule, pd, 1, false);
+    EXPECT_EQ(pd.stopReason, SAStopReason::SwapBudget);
+}
+
+TEST(CoolingSchedule, ReheatingRaisesTemperatureWhenStalled)
+{
+    CoolingScheduleParams params;
+    params.type = CoolingScheduleType::Reheating;
+    params.earlyStop = true;
+    CoolingSchedule schedule(params, coolingRate, windowSwaps);
+    SAProgressData pd = { 1.0f, 0, 100000, 0.0f };
+    schedule.Start(pd);
+
+    RunSwaps(schedule, pd, 2000, true);
+    float cold = pd.temperature;
+    RunSwaps(schedule, pd, params.stallWindows * windowSwaps, false);
+    EXPECT_GT(pd.temperature, cold);
+    EXPECT_EQ(pd.stopReason, SAStopReason::Running);
+
+    // Once the reheats run out, a stall stops the run
+    for (size_t window = 0; window < 100 && pd.stopReason == SAStopReason::Running; ++window)
+        RunSwaps(schedule, pd, windowSwaps, false);
+    EXPECT_EQ(pd.stopReason, SAStopReason::Converged);
+}
+
+TEST(CoolingSchedule, EarlyStopEndsAnnealing)
+{
+    Dimensions3D dims = { 16, 16, 4 };
+    pcg32_random_t rng = GetRNG();
+    RandomFloat2SA fixture(dims, rng);
+
+    CoolingScheduleParams params;
+    params.earlyStop = true;
+    SimulatedAnnealing<Float2, L1Weight> sa(dims, fixture.controller, 1.0f, 0.00001f, params);
+    sa.Run(rng);
+
+    const SAProgressData& pd = sa.GetProgressData();
+    EXPECT_EQ(pd.stopReason, SAStopReason::Converged);
+    EXPECT_LT(pd.swapIndex, pd.totalSwaps);
+    EXPECT_LT(pd.acceptanceRate, params.stallAcceptance);
+}
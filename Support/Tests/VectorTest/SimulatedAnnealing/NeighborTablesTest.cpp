@@ -0,0 +1,110 @@
+/*
+* Copyright (c) 2024, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#include "gtest/gtest.h"
+
+#include <cstdlib>
+#include <vector>
+
+#include "Kernel/VectorBlueNoiseGaussianKernel.h"
+#include "SimulatedAnnealing/NeighborTables.h"
+#include "Utils/Dimensions3D.h"
+#include "Utils/PixelCoords3D.h"
+
+struct ExpectedNeighbor
+{
+    size_t index;
+    float kernel;
+};
+
+// Wraps every neighbor with a modulo, the way the neighborhoods were walked before the tables
+static void CheckAgainstModulo(const Dimensions3D& dims)
+{
+    SymmetricKernel kernelX = VectorBlueNoiseGaussianKernel(1.9f, dims.x);
+    SymmetricKernel kernelY = VectorBlueNoiseGaussianKernel(1.9f, dims.y);
+    SymmetricKernel kernelZ = VectorBlueNoiseGaussianKernel(1.9f, dims.z);
+    NeighborTables tables(dims, kernelX, kernelY, kernelZ);
+
+    for (size_t pixelIndex = 0; pixelIndex < dims.NumPixels(); ++pixelIndex)
+    {
+        PixelCoords3D coords = PixelIndexToPixelCoords3D(pixelIndex, dims);
+
+        std::vector<ExpectedNeighbor> expectedXY;
+        for (int iy = kernelY.start(); iy < kernelY.end(); ++iy)
+        {
+            size_t y = size_t((int)coords.y + iy + (int)dims.y) % dims.y;
+            for (int ix = kernelX.start(); ix < kernelX.end(); ++ix)
+            {
+                if (ix == 0 && iy == 0)
+                    continue;
+                size_t x = size_t((int)coords.x + ix + (int)dims.x) % dims.x;
+                expectedXY.push_back({ PixelCoords3DToPixelIndex({ x, y, coords.z }, dims), kernelX[size_t(std::abs(ix))] * kernelY[size_t(std::abs(iy))] });
+            }
+        }
+
+        std::vector<ExpectedNeighbor> expectedZ;
+        for (int iz = kernelZ.start(); iz < kernelZ.end(); ++iz)
+        {
+            if (iz == 0)
+                continue;
+            size_t z = size_t((int)coords.z + iz + (int)dims.z) % dims.z;
+            expectedZ.push_back({ PixelCoords3DToPixelIndex({ coords.x, coords.y, z }, dims), kernelZ[size_t(std::abs(iz))] });
+        }
+
+        std::span<const NeighborTables::Neighbor> neighborsXY = tables.GetNeighborsXY(coords);
+        ASSERT_EQ(neighborsXY.size(), expectedXY.size());
+        for (size_t index = 0; index < expectedXY.size(); ++index)
+        {
+            EXPECT_EQ(size_t(std::ptrdiff_t(pixelIndex) + neighborsXY[index].offset), expectedXY[index].index);
+            EXPECT_EQ(neighborsXY[index].kernel, expectedXY[index].kernel);
+        }
+
+        std::span<const NeighborTables::Neighbor> neighborsZ = tables.GetNeighborsZ(coords);
+        ASSERT_EQ(neighborsZ.size(), expectedZ.size());
+        for (size_t index = 0; index < expectedZ.size(); ++index)
+        {
+            EXPECT_EQ(size_t(std::ptrdiff_t(pixelIndex) + neighborsZ[index].offset), expectedZ[index].index);
+            EXPECT_EQ(neighborsZ[index].kernel, expectedZ[index].kernel);
+        }
+
+        // Walking the rows in runs visits the same neighbors in the same order, plus the pixel itself with a 0 weight
+        std::vector<ExpectedNeighbor> runNeighbors;
+        const NeighborTables::Runs& runs = tables.GetRuns(coords);
+        for (const NeighborTables::Row& row : tables.GetRows(coords))
+        {
+            const float* rowKernelX = tables.GetRowKernelX(row.center);
+            for (size_t run = 0; run < runs.numRuns; ++run)
+            {
+                size_t runBegin = size_t(std::ptrdiff_t(pixelIndex) + row.offset + runs.offset[run]);
+                for (size_t lane = 0; lane < runs.count[run]; ++lane)
+                {
+                    float kernel = rowKernelX[runs.kernelOffset[run] + lane] * row.kernelY;
+                    if (row.center && runBegin + lane == pixelIndex)
+                        EXPECT_EQ(kernel, 0.0f);
+                    else
+                        runNeighbors.push_back({ runBegin + lane, kernel });
+                }
+            }
+        }
+        ASSERT_EQ(runNeighbors.size(), expectedXY.size());
+        for (size_t index = 0; index < expectedXY.size(); ++index)
+        {
+            EXPECT_EQ(runNeighbors[index].index, expectedXY[index].index);
+            EXPECT_EQ(runNeighbors[index].kernel, expectedXY[index].kernel);
+        }
+    }
+}
+
+TEST(NeighborTables, MatchesModuloWrap)
+{
+    CheckAgainstModulo({ 32, 32, 16 });
+    CheckAgainstModulo({ 13, 11, 5 });
+    CheckAgainstModulo({ 4, 4, 2 });
+}
@@ -0,0 +1,96 @@
+/*
+* Copyright (c) 2024, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "STBNRandom.h"
+#include "Kernel/VectorBlueNoiseGaussianKernel.h"
+#include "SimulatedAnnealing/ParallelTempering.h"
+#include "Types/Float.h"
+#include "ValueDistanceFunctions/ValueWeightPolicies.h"
+
+TEST(ParallelTempering, LadderRunsFromZeroToMax)
+{
+    Dimensions3D dims = { 4, 4, 2 };
+    SymmetricKernel kernel = VectorBlueNoiseGaussianKernel(1.9f, 4);
+    SAData<Float> data(dims);
+    SAProgressData pd = { 0.0f, 0, 0, 0.0f };
+    ParallelTempering<Float, AbsDistanceWeight> pt(data, kernel, kernel, kernel, 1.0f, 0.01f, 0.00001f, 4, 0.5f, false, SwapProposalParams(), pd);
+
+    EXPECT_EQ(pt.GetNumReplicas(), size_t(4));
+    EXPECT_EQ(pt.GetLadderTemperature(0), 0.0f);
+    for (size_t rung = 1; rung < pt.GetNumReplicas(); ++rung)
+        EXPECT_GT(pt.GetLadderTemperature(rung), pt.GetLadderTemperature(rung - 1));
+    EXPECT_EQ(pt.GetLadderTemperature(3), 0.5f);
+}
+
+TEST(ParallelTempering, ResultIsLowerEnergyPermutation)
+{
+    Dimensions3D dims = { 8, 8, 4 };
+    SymmetricKernel kernelXY = VectorBlueNoiseGaussianKernel(1.9f, 8);
+    SymmetricKernel kernelZ = VectorBlueNoiseGaussianKernel(1.9f, 4);
+
+    pcg32_random_t rng = GetRNG();
+    SAData<Float> data(dims);
+    for (Float& cell : data.cells)
+        cell.x = RandomFloat01(rng);
+    std::vector<float> startingValues;
+    for (const Float& cell : data.cells)
+        startingValues.push_back(cell.x);
+
+    float startingEnergy = 0.0f;
+    {
+        SAData<Float> startingData(dims);
+        std::copy(data.cells.begin(), data.cells.end(), startingData.cells.begin());
+        SADataController<Float, AbsDistanceWeight> controller(startingData, kernelXY, kernelXY, kernelZ, 1.0f);
+        for (size_t index = 0; index < startingData.numPixels; ++index)
+            controller.SplatOn(index);
+        startingEnergy = controller.Energy();
+    }
+
+    SAProgressData pd = { 0.0f, 0, 0, 0.0f };
+    ParallelTempering<Float, AbsDistanceWeight> pt(data, kernelXY, kernelXY, kernelZ, 1.0f, 0.05f, 0.00001f, 3, 0.01f, false, SwapProposalParams(), pd);
+    pt.Run(rng);
+
+    EXPECT_LT(pd.energy, startingEnergy);
+
+    std::vector<float> values;
+    for (const Float& cell : data.cells)
+        values.push_back(cell.x);
+    std::sort(startingValues.begin(), startingValues.end());
+    std::sort(values.begin(), values.end());
+    EXPECT_EQ(values, startingValues);
+}
+
+TEST(ParallelTempering, ReplicasUseSwapProposals)
+{
+    Dimensions3D dims = { 8, 8, 4 };
+    SymmetricKernel kernel = VectorBlueNoiseGaussianKernel(1.9f, 4);
+
+    pcg32_random_t rng = GetRNG();
+    SAData<Float> data(dims);
+    for (Float& cell : data.cells)
+        cell.x = RandomFloat01(rng);
+
+    SwapProposalParams proposals;
+    proposals.spatialFraction = 0.5f;
+    proposals.columnFraction = 0.25f;
+
+    SAProgressData pd = { 0.0f, 0, 0, 0.0f };
+    ParallelTempering<Float, AbsDistanceWeight> pt(data, kernel, kernel, kernel, 1.0f, 0.05f, 0.00001f, 2, 0.01f, false, proposals, pd);
+    pt.Run(rng);
+
+    EXPECT_GT(pd.numProposed[size_t(SwapProposalType::Global)], size_t(0));
+    EXPECT_GT(pd.numProposed[size_t(SwapProposalType::Spatial)], size_t(0));
+    EXPECT_GT(pd.numProposed[size_t(SwapProposalType::Column)], size_t(0));
+}
@@ -0,0 +1,99 @@
+/*
+* Copyright (c) 2024, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#include "gtest/gtest.h"
+
+#include <cmath>
+
+#include "STBNRandom.h"
+#include "SimulatedAnnealing/SADataController.h"
+#include "Types/Float2.h"
+#include "ValueDistanceFunctions/ValueWeightPolicies.h"
+
+#include "SATestFixture.h"
+
+// SwapDelta has to predict exactly what CommitSwap does to Energy(), for accepted and rejected swaps alike
+static void ExpectSwapDeltaMatchesCommit(const Dimensions3D& dims, bool soaCells)
+{
+    pcg32_random_t rng = GetRNG();
+    RandomFloat2SA fixture(dims, rng, soaCells);
+    SAData<Float2>& data = fixture.data;
+    SADataController<Float2, L1Weight>& controller = fixture.controller;
+    controller.SyncCellPlanes();
+    for (size_t index = 0; index < data.numPixels; ++index)
+        controller.SplatOn(index);
+
+    for (int swapIndex = 0; swapIndex < 200; ++swapIndex)
+    {
+        uint32_t indexA = pcg32_boundedrand_r(&rng, (uint32_t)data.numPixels);
+        uint32_t indexB = pcg32_boundedrand_r(&rng, (uint32_t)data.numPixels);
+
+        float energyBefore = controller.Energy();
+        float delta = controller.SwapDelta(indexA, indexB);
+        controller.CommitSwap(indexA, indexB);
+        float energyAfter = controller.Energy();
+
+        EXPECT_NEAR(energyAfter - energyBefore, delta, 1e-5f * std::max(std::abs(energyBefore), 1.0f));
+    }
+}
+
+TEST(SADataController, SwapDeltaMatchesCommit)
+{
+    ExpectSwapDeltaMatchesCommit({ 16, 16, 8 }, false);
+}
+
+TEST(SADataController, SwapDeltaMatchesCommitWhenKernelWraps)
+{
+    // Neighbors wrap around onto the swapped pixels themselves
+    ExpectSwapDeltaMatchesCommit({ 4, 4, 2 }, false);
+}
+
+TEST(SADataController, SoASwapDeltaMatchesCommit)
+{
+    // Widths that leave partial vectors, and rows that wrap around the edge
+    ExpectSwapDeltaMatchesCommit({ 16, 16, 8 }, true);
+    ExpectSwapDeltaMatchesCommit({ 13, 11, 5 }, true);
+    ExpectSwapDeltaMatchesCommit({ 4, 4, 2 }, true);
+}
+
+// The SoA path only changes the order floats are summed in
+TEST(SADataController, SoAMatchesAoS)
+{
+    Dimensions3D dims = { 13, 11, 5 };
+
+    // Both start from the same cells
+    pcg32_random_t rngSoA = GetRNG();
+    RandomFloat2SA<L2Weight> fixtureSoA(dims, rngSoA, true);
+    pcg32_random_t rng = GetRNG();
+    RandomFloat2SA<L2Weight> fixtureAoS(dims, rng, false);
+    SAData<Float2>& dataAoS = fixtureAoS.data;
+    SAData<Float2>& dataSoA = fixtureSoA.data;
+    SADataController<Float2, L2Weight>& controllerAoS = fixtureAoS.controller;
+    SADataController<Float2, L2Weight>& controllerSoA = fixtureSoA.controller;
+    controllerSoA.SyncCellPlanes();
+    for (size_t index = 0; index < dataAoS.numPixels; ++index)
+    {
+        controllerAoS.SplatOn(index);
+        controllerSoA.SplatOn(index);
+    }
+
+    for (int swapIndex = 0; swapIndex < 100; ++swapIndex)
+    {
+        uint32_t indexA = pcg32_boundedrand_r(&rng, (uint32_t)dataAoS.numPixels);
+        uint32_t indexB = pcg32_boundedrand_r(&rng, (uint32_t)dataAoS.numPixels);
+        EXPECT_NEAR(controllerSoA.SwapDelta(indexA, indexB), controllerAoS.SwapDelta(indexA, indexB), 1e-4f);
+        controllerAoS.CommitSwap(indexA, indexB);
+        controllerSoA.CommitSwap(indexA, indexB);
+    }
+
+    EXPECT_NEAR(controllerSoA.Energy(), controllerAoS.Energy(), 1e-5f * controllerAoS.Energy());
+    for (size_t index = 0; index < dataAoS.numPixels; ++index)
+        EXPECT_NEAR(dataSoA.energy[index], dataAoS.energy[index], 1e-5f);
+}
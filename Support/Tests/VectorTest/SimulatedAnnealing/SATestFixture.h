@@ -0,0 +1,44 @@
+/*
+* Copyright (c) 2024, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#pragma once
+
+#include "STBNRandom.h"
+#include "Kernel/VectorBlueNoiseGaussianKernel.h"
+#include "SimulatedAnnealing/SAData.h"
+#include "SimulatedAnnealing/SADataController.h"
+#include "Types/Float2.h"
+#include "Utils/Dimensions3D.h"
+#include "ValueDistanceFunctions/ValueWeightPolicies.h"
+
+#include "pcg_basic.h"
+
+// The setup the simulated annealing tests share: Float2 cells filled with white noise from rng, a sigma 1.9
+// blue noise Gaussian kernel per axis, and a controller over them with a value sigma of 1.
+template<typename ValueWeight = L1Weight>
+struct RandomFloat2SA
+{
+    RandomFloat2SA(const Dimensions3D& dims, pcg32_random_t& rng, bool soaCells = false) :
+        kernelX(VectorBlueNoiseGaussianKernel(1.9f, dims.x)),
+        kernelY(VectorBlueNoiseGaussianKernel(1.9f, dims.y)),
+        kernelZ(VectorBlueNoiseGaussianKernel(1.9f, dims.z)),
+        data(dims),
+        controller(data, kernelX, kernelY, kernelZ, 1.0f, soaCells)
+    {
+        for (Float2& cell : data.cells)
+            cell = { RandomFloat01(rng), RandomFloat01(rng) };
+    }
+
+    SymmetricKernel kernelX;
+    SymmetricKernel kernelY;
+    SymmetricKernel kernelZ;
+    SAData<Float2> data;
+    SADataController<Float2, ValueWeight> controller;
+};
@@ -0,0 +1,74 @@
+/*
+* Copyright (c) 2024, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#include "gtest/gtest.h"
+
+#include "STBNRandom.h"
+#include "SimulatedAnnealing/SimulatedAnnealing.h"
+#include "Types/Float2.h"
+#include "ValueDistanceFunctions/ValueWeightPolicies.h"
+
+#include "SATestFixture.h"
+
+static const Dimensions3D dims = { 16, 16, 4 };
+
+// Runs annealing on the same starting texture, with speculation on numThreads threads, or serially for 0
+static SAData<Float2> RunSA(size_t numThreads, float coolingFactor, const CoolingScheduleParams& schedule, const SwapProposalParams& proposals, pcg32_random_t& rng)
+{
+    rng = GetRNG();
+    RandomFloat2SA fixture(dims, rng);
+
+    SimulatedAnnealing<Float2, L1Weight> sa(dims, fixture.controller, 0.02f, coolingFactor, schedule, proposals);
+    if (numThreads == 0)
+        sa.Run(rng);
+    else
+        sa.RunSpeculative(rng, numThreads);
+    return fixture.data;
+}
+
+static void ExpectSameAsSerial(size_t numThreads, float coolingFactor, const CoolingScheduleParams& schedule = CoolingScheduleParams(), const SwapProposalParams& proposals = SwapProposalParams())
+{
+    pcg32_random_t serialRNG;
+    pcg32_random_t speculativeRNG;
+    SAData<Float2> serial = RunSA(0, coolingFactor, schedule, proposals, serialRNG);
+    SAData<Float2> speculative = RunSA(numThreads, coolingFactor, schedule, proposals, speculativeRNG);
+
+    EXPECT_EQ(speculative.cells, serial.cells);
+    EXPECT_EQ(speculative.energy, serial.energy);
+    EXPECT_EQ(pcg32_random_r(&speculativeRNG), pcg32_random_r(&serialRNG));
+}
+
+TEST(SpeculativeSA, SameAsSerial)
+{
+    ExpectSameAsSerial(4, 0.00001f);
+}
+
+// A slow cooling keeps accepting uphill swaps for longer
+TEST(SpeculativeSA, SameAsSerialWithUphillSwaps)
+{
+    ExpectSameAsSerial(3, 0.01f);
+}
+
+// The adaptive schedule depends on which swaps were accepted, and early stop can end the run on any proposal
+TEST(SpeculativeSA, SameAsSerialWithAdaptiveEarlyStop)
+{
+    CoolingScheduleParams schedule;
+    schedule.type = CoolingScheduleType::Adaptive;
+    schedule.earlyStop = true;
+    ExpectSameAsSerial(3, 0.001f, schedule);
+}
+
+TEST(SpeculativeSA, SameAsSerialWithLocalSwaps)
+{
+    SwapProposalParams proposals;
+    proposals.spatialFraction = 0.5f;
+    proposals.columnFraction = 0.25f;
+    ExpectSameAsSerial(3, 0.01f, CoolingScheduleParams(), proposals);
+}
@@ -0,0 +1,127 @@
+/*
+* Copyright (c) 2024, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <set>
+
+#include "STBNRandom.h"
+#include "SimulatedAnnealing/SwapProposals.h"
+#include "Utils/PixelCoords3D.h"
+
+static size_t TorusDistance(size_t a, size_t b, size_t dim)
+{
+    size_t distance = (a > b) ? a - b : b - a;
+    return std::min(distance, dim - distance);
+}
+
+TEST(SwapProposals, GlobalMatchesUniformDraws)
+{
+    Dimensions3D dims = { 16, 12, 8 };
+    SwapProposals proposals(dims, SwapProposalParams());
+
+    pcg32_random_t rng = GetRNG();
+    pcg32_random_t expectedRNG = rng;
+    for (size_t proposal = 0; proposal < 1000; ++proposal)
+    {
+        uint32_t indexA, indexB;
+        EXPECT_EQ(proposals.Propose(rng, indexA, indexB), SwapProposalType::Global);
+        EXPECT_EQ(indexA, pcg32_boundedrand_r(&expectedRNG, uint32_t(dims.NumPixels())));
+        EXPECT_EQ(indexB, pcg32_boundedrand_r(&expectedRNG, uint32_t(dims.NumPixels())));
+    }
+}
+
+// Every B is a different pixel within the window, and every pixel of the window comes up
+static void CheckWindows(const Dimensions3D& dims, size_t radius)
+{
+    SwapProposalParams params;
+    params.spatialFraction = 0.5f;
+    params.columnFraction = 0.5f;
+    params.spatialRadius = radius;
+    params.columnRadius = radius;
+    SwapProposals proposals(dims, params);
+
+    size_t radiusX = std::min(radius, (dims.x - 1) / 2);
+    size_t radiusY = std::min(radius, (dims.y - 1) / 2);
+    size_t radiusZ = std::min(radius, (dims.z - 1) / 2);
+    std::set<std::pair<int, int>> spatialOffsets;
+    std::set<int> columnOffsets;
+
+    pcg32_random_t rng = GetRNG();
+    for (size_t proposal = 0; proposal < 20000; ++proposal)
+    {
+        uint32_t indexA, indexB;
+        SwapProposalType type = proposals.Propose(rng, indexA, indexB);
+        ASSERT_NE(type, SwapProposalType::Global);
+        ASSERT_NE(indexA, indexB);
+        ASSERT_LT(indexB, dims.NumPixels());
+
+        PixelCoords3D a = PixelIndexToPixelCoords3D(indexA, dims);
+        PixelCoords3D b = PixelIndexToPixelCoords3D(indexB, dims);
+        if (type == SwapProposalType::Spatial)
+        {
+            EXPECT_EQ(b.z, a.z);
+            EXPECT_LE(TorusDistance(a.x, b.x, dims.x), radiusX);
+            EXPECT_LE(TorusDistance(a.y, b.y, dims.y), radiusY);
+            spatialOffsets.insert({ int((b.x + dims.x - a.x) % dims.x), int((b.y + dims.y - a.y) % dims.y) });
+        }
+        else
+        {
+            EXPECT_EQ(b.x, a.x);
+            EXPECT_EQ(b.y, a.y);
+            EXPECT_LE(TorusDistance(a.z, b.z, dims.z), radiusZ);
+            columnOffsets.insert(int((b.z + dims.z - a.z) % dims.z));
+        }
+    }
+
+    EXPECT_EQ(spatialOffsets.size(), (2 * radiusX + 1) * (2 * radiusY + 1) - 1);
+    EXPECT_EQ(columnOffsets.size(), 2 * radiusZ);
+}
+
+TEST(SwapProposals, LocalWindows)
+{
+    CheckWindows({ 32, 32, 16 }, 3);
+    CheckWindows({ 13, 11, 5 }, 4);
+    CheckWindows({ 4, 4, 3 }, 8);
+}
+
+TEST(SwapProposals, MixingRatio)
+{
+    SwapProposalParams params;
+    params.spatialFraction = 0.5f;
+    params.columnFraction = 0.2f;
+    SwapProposals proposals({ 32, 32, 16 }, params);
+
+    size_t counts[size_t(SwapProposalType::Count)] = {};
+    pcg32_random_t rng = GetRNG();
+    const size_t numProposals = 100000;
+    for (size_t proposal = 0; proposal < numProposals; ++proposal)
+    {
+        uint32_t indexA, indexB;
+        counts[size_t(proposals.Propose(rng, indexA, indexB))]++;
+    }
+
+    EXPECT_NEAR(double(counts[size_t(SwapProposalType::Spatial)]) / numProposals, 0.5, 0.01);
+    EXPECT_NEAR(double(counts[size_t(SwapProposalType::Column)]) / numProposals, 0.2, 0.01);
+    EXPECT_NEAR(double(counts[size_t(SwapProposalType::Global)]) / numProposals, 0.3, 0.01);
+}
+
+// A Z axis of 1 or 2 has no window that doesn't wrap onto itself, so column proposals are global
+TEST(SwapProposals, NoColumnWindowInThinTexture)
+{
+    SwapProposalParams params;
+    params.columnFraction = 1.0f;
+    SwapProposals proposals({ 16, 16, 2 }, params);
+
+    pcg32_random_t rng = GetRNG();
+    uint32_t indexA, indexB;
+    EXPECT_EQ(proposals.Propose(rng, indexA, indexB), SwapProposalType::Global);
+}
@@ -0,0 +1,122 @@
+/*
+* Copyright (c) 2024, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <random>
+
+#include "ValueDistanceFunctions/ValueWeightPolicies.h"
+
+// Exponent() has to be Distance()^(N/3), however it gets there
+template<typename T, typename ValueWeight>
+static void ExpectExponentIsDistancePower()
+{
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> value(-1.0f, 1.0f);
+    for (int test = 0; test < 1000; ++test)
+    {
+        T a, b;
+        for (size_t i = 0; i < T::N; ++i)
+        {
+            a[int(i)] = value(rng);
+            b[int(i)] = value(rng);
+        }
+
+        float expected = std::pow(ValueWeight::Distance(a, b), float(T::N) / 3.0f);
+        ASSERT_NEAR(ValueWeight::Exponent(a, b), expected, 1e-5f + 1e-5f * expected);
+    }
+}
+
+#if STBN_X86()
+// ExponentAVX2() has to give what Exponent() gives, lane for lane
+template<typename T, typename ValueWeight>
+STBN_TARGET_AVX2 static void ExpectAVX2MatchesScalar()
+{
+    std::mt19937 rng(2);
+    std::uniform_real_distribution<float> value(-1.0f, 1.0f);
+    for (int test = 0; test < 100; ++test)
+    {
+        alignas(32) float a[T::N][8];
+        alignas(32) float b[T::N][8];
+        for (size_t i = 0; i < T::N; ++i)
+        {
+            for (size_t lane = 0; lane < 8; ++lane)
+            {
+                a[i][lane] = value(rng);
+                b[i][lane] = (lane == 0) ? a[i][lane] : value(rng);
+            }
+        }
+
+        __m256 vectorA[T::N];
+        __m256 vectorB[T::N];
+        for (size_t i = 0; i < T::N; ++i)
+        {
+            vectorA[i] = _mm256_load_ps(a[i]);
+            vectorB[i] = _mm256_load_ps(b[i]);
+        }
+        alignas(32) float exponent[8];
+        _mm256_store_ps(exponent, ValueWeight::ExponentAVX2(vectorA, vectorB));
+
+        for (size_t lane = 0; lane < 8; ++lane)
+        {
+            T cellA, cellB;
+            for (size_t i = 0; i < T::N; ++i)
+            {
+                cellA[int(i)] = a[i][lane];
+                cellB[int(i)] = b[i][lane];
+            }
+            ASSERT_EQ(exponent[lane], ValueWeight::Exponent(cellA, cellB));
+        }
+    }
+}
+
+TEST(ValueWeightPolicies, AVX2MatchesScalar)
+{
+    if (!IsISASupported(CPUISA::AVX2))
+        GTEST_SKIP() << "AVX2 isn't supported here";
+
+    ExpectAVX2MatchesScalar<Float, AbsDistanceWeight>();
+    ExpectAVX2MatchesScalar<Float2, L1Weight>();
+    ExpectAVX2MatchesScalar<Float2, L2Weight>();
+    ExpectAVX2MatchesScalar<Float2, LInfinityWeight>();
+    ExpectAVX2MatchesScalar<Float3, L1Weight>();
+    ExpectAVX2MatchesScalar<Float3, L2Weight>();
+    ExpectAVX2MatchesScalar<Float3, LInfinityWeight>();
+    ExpectAVX2MatchesScalar<Float3, NegativeDotWeight>();
+}
+#endif
+
+TEST(ValueWeightPolicies, AbsDistanceTest)
+{
+    ExpectExponentIsDistancePower<Float, AbsDistanceWeight>();
+}
+
+TEST(ValueWeightPolicies, Float2Test)
+{
+    ExpectExponentIsDistancePower<Float2, L1Weight>();
+    ExpectExponentIsDistancePower<Float2, L2Weight>();
+    ExpectExponentIsDistancePower<Float2, LInfinityWeight>();
+}
+
+TEST(ValueWeightPolicies, Float3Test)
+{
+    ExpectExponentIsDistancePower<Float3, L1Weight>();
+    ExpectExponentIsDistancePower<Float3, L2Weight>();
+    ExpectExponentIsDistancePower<Float3, LInfinityWeight>();
+}
+
+TEST(ValueWeightPolicies, NegativeDotTest)
+{
+    Float3 a = { 1.0f, 2.0f, 3.0f };
+    Float3 b = { -0.5f, 0.25f, 2.0f };
+
+    EXPECT_EQ(NegativeDotWeight::Exponent(a, b), NegativeDot(a, b));
+}
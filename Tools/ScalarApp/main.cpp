@@ -8,15 +8,23 @@
 * license agreement from NVIDIA CORPORATION is strictly prohibited.
 */
 
+#include <algorithm>
+#include <chrono>
 #include <filesystem>
 #include <iostream>
 #include <memory>
 
 #include "cxxopts.hpp"
 
+#include "ArenaAllocator.h"
+#include "STBNExtender.h"
 #include "STBNMaker.h"
+#include "STBNMultiresolutionMaker.h"
+#include "Trace.h"
 #include "Kernel/BlueNoiseGaussianKernel.h"
 #include "Reporting/ProgressReporter.h"
+#include "Utils/PixelCoords.h"
+#include "Utils/RankVolumeIO.h"
 #include "VoidAndCluster/VoidAndCluster.h"
 
 struct ProgramOptions
@@ -26,6 +34,18 @@ struct ProgramOptions
     SigmaPerDimension sigmas;
     float initialBinaryPatternDensity;
     ScalarImplementation implementation;
+    std::vector<int> groups;
+    PixelLayout layout;
+    TileOptions tileOptions;
+    size_t levels;
+    size_t maxRank;
+    bool savePoints;
+    std::string extendFrom;
+    size_t extendFromDimZ;
+    bool saveRaw;
+    std::string statsFile;
+    bool hugePageStats;
+    std::string traceFile;
 };
 
 cxxopts::Options BuildCmdOptions()
@@ -43,7 +63,20 @@ cxxopts::Options BuildCmdOptions()
         ("sZ", "Sigma Z", cxxopts::value<float>()->default_value("1.9"))
         ("sW", "Sigma W", cxxopts::value<float>()->default_value("1.9"))
         ("ibpd", "Initial binary pattern density", cxxopts::value<float>()->default_value("0.1"))
-        ("i,implementation", "sc211 for slice cache 2Dx1Dx1D noise, sc22 for slice cache 2Dx2D noise, r211 for reference 2Dx1Dx1D, r22 reference 2Dx2D noise", cxxopts::value<std::string>()->default_value("sc211"))
+        ("i,implementation", "sc211 for slice cache 2Dx1Dx1D noise, sc22 for slice cache 2Dx2D noise, r211 for reference 2Dx1Dx1D, r22 reference 2Dx2D noise, scnd for slice cache noise grouped by the groups option, a211 for 2Dx1Dx1D noise that picks the fastest strategy as it goes, fp32 or fp64 for slice cache 2Dx1Dx1D noise with 32 or 64 bit fixed point energy, d211 for slice cache 2Dx1Dx1D noise split into tiles", cxxopts::value<std::string>()->default_value("sc211"))
+        ("groups", "Group number per dimension XYZW for scnd. Dimensions in the same group are blue together, e.g. 0,0,1,2 is 2Dx1Dx1D and 0,1,2,3 is 1Dx1Dx1Dx1D", cxxopts::value<std::string>()->default_value("0,0,1,2"))
+        ("layout", "Energy layout in memory. linear, or bricked for 8x8x4 bricks which keeps Z splats cache friendly. Output is always linear", cxxopts::value<std::string>()->default_value("linear"))
+        ("tiles", "Number of tiles for d211. Each tile owns a range of Z slices", cxxopts::value<int>()->default_value("4"))
+        ("tileTransport", "What runs the d211 tiles. threads, or processes which talk to the coordinator over local sockets", cxxopts::value<std::string>()->default_value("threads"))
+        ("levels", "Number of coarse to fine levels. Each coarser level halves X and Y and seeds the initial binary pattern of the level above", cxxopts::value<int>()->default_value("1"))
+        ("max-rank", "Stop once ranks 0 to max-rank - 1 are assigned, for when only the first ranks are used as progressive sample sets. The other pixels get the highest rank. 0 ranks everything. With extendFrom it only cuts the points file", cxxopts::value<int>()->default_value("0"))
+        ("points", "Also save the ranked pixels in rank order as a .raw file of uint32 linear pixel indices", cxxopts::value<bool>()->default_value("false"))
+        ("extendFrom", "Existing rank volume to append Z slices to instead of generating from scratch. Either a png file name pattern containing %i, or a .raw file", cxxopts::value<std::string>()->default_value(""))
+        ("extendFromDimsZ", "Z dimension of the existing rank volume. dimsZ is the Z dimension after appending", cxxopts::value<int>()->default_value("0"))
+        ("raw", "Also save the ranks as a .raw file of uint32s, which extendFrom can read back losslessly", cxxopts::value<bool>()->default_value("false"))
+        ("trace", "Save a Chrome trace event timeline of the run to this JSON file, for Perfetto or chrome://tracing", cxxopts::value<std::string>()->default_value(""))
+        ("stats", "Save per phase query, scan and splat counters and latency histograms to this JSON file. Needs a build with VC_STATS() set to true", cxxopts::value<std::string>()->default_value(""))
+        ("hugePageStats", "Print how many large allocations got huge pages once the run is done", cxxopts::value<bool>()->default_value("false"))
         ("h,help", "Print help")
         ;
     cmdOptions.allow_unrecognised_options();
@@ -70,10 +103,60 @@ ScalarImplementation ParseSplatBasis(const std::string& input)
         return ScalarImplementation::SliceCache_2Dx1Dx1D;
     if (input == "sc22")
         return ScalarImplementation::SliceCache_2Dx2D;
-    printf("Unrecognized splatBasis flag. Options are r22, r22, sc211, or sc22\n.");
+    if (input == "scnd")
+        return ScalarImplementation::SliceCache_ND;
+    if (input == "a211")
+        return ScalarImplementation::Auto_2Dx1Dx1D;
+    if (input == "fp32")
+        return ScalarImplementation::FixedPoint32_2Dx1Dx1D;
+    if (input == "fp64")
+        return ScalarImplementation::FixedPoint64_2Dx1Dx1D;
+    if (input == "d211")
+        return ScalarImplementation::Distributed_2Dx1Dx1D;
+    printf("Unrecognized splatBasis flag. Options are r22, r22, sc211, sc22, scnd, a211, fp32, fp64, or d211\n.");
     exit(-1);
 }
 
+PixelLayout ParseLayout(const std::string& input)
+{
+    if (input == "linear")
+        return PixelLayout::Linear;
+    if (input == "bricked")
+        return PixelLayout::Bricked;
+    printf("Unrecognized layout flag. Options are linear or bricked.\n");
+    exit(-1);
+}
+
+TileTransport ParseTileTransport(const std::string& input)
+{
+    if (input == "threads")
+        return TileTransport::Threads;
+    if (input == "processes")
+        return TileTransport::Processes;
+    printf("Unrecognized tileTransport flag. Options are threads or processes.\n");
+    exit(-1);
+}
+
+std::vector<int> ParseGroups(const std::string& input)
+{
+    std::vector<int> groups;
+    size_t start = 0;
+    while (start <= input.size())
+    {
+        size_t end = input.find(',', start);
+        if (end == std::string::npos)
+            end = input.size();
+        groups.push_back(atoi(input.substr(start, end - start).c_str()));
+        start = end + 1;
+    }
+    if (groups.size() != 4)
+    {
+        printf("groups needs one group number per dimension, e.g. 0,0,1,2.\n");
+        exit(-1);
+    }
+    return groups;
+}
+
 ProgramOptions BuildProgramOptionsFromParsedArgs(cxxopts::ParseResult& parsedOptions)
 {
     ProgramOptions programOptions;
@@ -89,6 +172,19 @@ ProgramOptions BuildProgramOptionsFromParsedArgs(cxxopts::ParseResult& parsedOpt
     programOptions.sigmas.w = parsedOptions["sW"].as<float>();
     programOptions.initialBinaryPatternDensity = parsedOptions["ibpd"].as<float>();
     programOptions.implementation = ParseSplatBasis(parsedOptions["implementation"].as<std::string>());
+    programOptions.groups = ParseGroups(parsedOptions["groups"].as<std::string>());
+    programOptions.layout = ParseLayout(parsedOptions["layout"].as<std::string>());
+    programOptions.tileOptions.numTiles = std::max(parsedOptions["tiles"].as<int>(), 1);
+    programOptions.tileOptions.transport = ParseTileTransport(parsedOptions["tileTransport"].as<std::string>());
+    programOptions.levels = std::max(parsedOptions["levels"].as<int>(), 1);
+    programOptions.maxRank = std::max(parsedOptions["max-rank"].as<int>(), 0);
+    programOptions.savePoints = parsedOptions["points"].as<bool>();
+    programOptions.extendFrom = parsedOptions["extendFrom"].as<std::string>();
+    programOptions.extendFromDimZ = parsedOptions["extendFromDimsZ"].as<int>();
+    programOptions.saveRaw = parsedOptions["raw"].as<bool>();
+    programOptions.statsFile = parsedOptions["stats"].as<std::string>();
+    programOptions.hugePageStats = parsedOptions["hugePageStats"].as<bool>();
+    programOptions.traceFile = parsedOptions["trace"].as<std::string>();
 
     return programOptions;
 }
@@ -107,6 +203,10 @@ std::vector<int> splatBasisToGroups(ScalarImplementation implementation)
     {
         case ScalarImplementation::Reference_2Dx1Dx1D:
         case ScalarImplementation::SliceCache_2Dx1Dx1D:
+        case ScalarImplementation::Auto_2Dx1Dx1D:
+        case ScalarImplementation::FixedPoint32_2Dx1Dx1D:
+        case ScalarImplementation::FixedPoint64_2Dx1Dx1D:
+        case ScalarImplementation::Distributed_2Dx1Dx1D:
             return std::vector<int>{ 0, 0, 1, 2 };
             break;
         case ScalarImplementation::Reference_2Dx2D:
@@ -148,33 +248,145 @@ std::string SplatBasisToString(ScalarImplementation implementation)
     case ScalarImplementation::SliceCache_2Dx2D:
         return "Splice_Cache_2Dx2D";
         break;
+    case ScalarImplementation::SliceCache_ND:
+        return "Splice_Cache_ND";
+        break;
+    case ScalarImplementation::Auto_2Dx1Dx1D:
+        return "Auto_2Dx1Dx1D";
+        break;
+    case ScalarImplementation::FixedPoint32_2Dx1Dx1D:
+        return "Fixed_Point32_2Dx1Dx1D";
+        break;
+    case ScalarImplementation::FixedPoint64_2Dx1Dx1D:
+        return "Fixed_Point64_2Dx1Dx1D";
+        break;
+    case ScalarImplementation::Distributed_2Dx1Dx1D:
+        return "Distributed_2Dx1Dx1D";
+        break;
+    }
+}
+
+std::string OutputFileNamePrefix(const ProgramOptions& programOptions)
+{
+    return "stbn_scalar_" + SplatBasisToString(programOptions.implementation) + "_" + std::to_string(programOptions.dims.x) + "x" + std::to_string(programOptions.dims.y) + "x" + std::to_string(programOptions.dims.z);
+}
+
+void SaveMask(const ProgramOptions& programOptions, const BlueNoiseTexturesND& textures, const STBNData& data)
+{
+    std::filesystem::create_directory(programOptions.outputDirectory);
+
+    // save it out as pngs
+    std::string outputFileNamePrefix = OutputFileNamePrefix(programOptions);
+    std::string outputFileNameTemplate = outputFileNamePrefix + "_%i.png";
+    std::string outputPath = programOptions.outputDirectory.string() + "/" + outputFileNameTemplate;
+    SaveTextures(textures, outputPath.c_str());
+
+    if (programOptions.saveRaw)
+        SaveRanksToRaw(programOptions.outputDirectory.string() + "/" + outputFileNamePrefix + ".raw", PixelValuesToLinearOrder(data.pixelRank, data.dimensions));
+
+    if (programOptions.savePoints)
+    {
+        size_t count = (programOptions.maxRank > 0) ? std::min(programOptions.maxRank, data.numPixels) : data.numPixels;
+        SaveProgressivePointsToRaw(programOptions.outputDirectory.string() + "/" + outputFileNamePrefix + "_points.raw", PixelValuesToLinearOrder(data.pixelRank, data.dimensions), count);
     }
 }
 
 void MakeMask(const ProgramOptions& programOptions)
 {
-    STBNMaker maker(programOptions.dims, programOptions.sigmas, programOptions.initialBinaryPatternDensity, programOptions.implementation);
+    Dimensions dims = programOptions.dims;
+    dims.layout = programOptions.layout;
+    if (!IsLayoutSupported(dims))
+    {
+        printf("The bricked layout needs dimsX and dimsY to be multiples of %zu and dimsZ to be a multiple of %zu.\n", c_brickSizeX, c_brickSizeZ);
+        exit(-1);
+    }
+    if (programOptions.implementation == ScalarImplementation::Distributed_2Dx1Dx1D && dims.layout != PixelLayout::Linear)
+    {
+        printf("d211 needs the linear layout.\n");
+        exit(-1);
+    }
+
+    STBNMultiresolutionMaker maker(dims, programOptions.sigmas, programOptions.initialBinaryPatternDensity, programOptions.implementation, programOptions.levels, programOptions.groups, programOptions.tileOptions);
+    if (maker.GetNumLevels() > 1)
+        printf("Solving %zu coarse to fine levels\n", maker.GetNumLevels());
+    if (programOptions.maxRank > 0)
+        maker.SetMaxRank(programOptions.maxRank);
     ProgressReporter pr(maker.GetVoidAndCluster(), 20);
     pr.LaunchCMDReporter();
 
     maker.Make();
+    if (programOptions.hugePageStats)
+        printf("%s\n", HugePageArena::GetStatsString().c_str());
+
+    if (!programOptions.statsFile.empty())
+    {
+        if (!VC_STATS())
+            printf("Not saving %s, this build has VC_STATS() set to false.\n", programOptions.statsFile.c_str());
+        else if (!SaveVCStatsJSON(maker.GetVoidAndCluster()->GetStats(), programOptions.statsFile.c_str()))
+            printf("Could not save %s\n", programOptions.statsFile.c_str());
+    }
 
     BlueNoiseTexturesND textures = maker.GetBlueNoiseTextures();
 
-    std::filesystem::create_directory(programOptions.outputDirectory);
+    SaveMask(programOptions, textures, maker.GetVoidAndCluster()->GetSTBNData());
+}
 
-    // save it out as pngs
-    std::string outputFileNamePrefix = "stbn_scalar_" + SplatBasisToString(programOptions.implementation) + "_" + std::to_string(programOptions.dims.x) + "x" + std::to_string(programOptions.dims.y) + "x" + std::to_string(programOptions.dims.z);
-    std::string outputFileNameTemplate = outputFileNamePrefix + "_%i.png";
-    std::string outputPath = programOptions.outputDirectory.string() + "/" + outputFileNameTemplate;
-    SaveTextures(textures, outputPath.c_str());
+void ExtendMask(const ProgramOptions& programOptions)
+{
+    Dimensions existingDims = programOptions.dims;
+    existingDims.z = programOptions.extendFromDimZ;
+    if (existingDims.z == 0 || existingDims.z >= programOptions.dims.z)
+    {
+        printf("extendFromDimsZ must be greater than 0 and less than dimsZ.\n");
+        exit(-1);
+    }
+    if (programOptions.layout != PixelLayout::Linear)
+    {
+        printf("Extending needs the linear layout.\n");
+        exit(-1);
+    }
+
+    std::vector<size_t> existingRanks;
+    const std::string& path = programOptions.extendFrom;
+    bool isRaw = path.size() >= 4 && path.compare(path.size() - 4, 4, ".raw") == 0;
+    bool loaded = isRaw ? LoadRanksFromRaw(path, existingDims, existingRanks) : LoadRanksFromPNGs(path, existingDims, existingRanks);
+    if (!loaded)
+    {
+        printf("Could not load the %zux%zux%zux%zu rank volume from %s\n", existingDims.x, existingDims.y, existingDims.z, existingDims.w, path.c_str());
+        exit(-1);
+    }
+
+    STBNExtender extender(existingDims, existingRanks, programOptions.dims.z, programOptions.sigmas, programOptions.implementation, programOptions.groups);
+    printf("Extending %zux%zux%zux%zu to %zu Z slices, running void and cluster on %zu of them\n", existingDims.x, existingDims.y, existingDims.z, existingDims.w, programOptions.dims.z, extender.GetWindowDimZ());
+
+    auto start = std::chrono::steady_clock::now();
+    extender.Make();
+    std::chrono::duration<float> duration = std::chrono::steady_clock::now() - start;
+    printf("[Total time taken: %.3f seconds]\n", duration.count());
+    if (programOptions.hugePageStats)
+        printf("%s\n", HugePageArena::GetStatsString().c_str());
+
+    SaveMask(programOptions, extender.GetBlueNoiseTextures(), extender.GetSTBNData());
 }
 
 int main(int argc, char** argv)
 {
     ProgramOptions programOptions = ParseCmdArgs(argc, argv);
 
-    MakeMask(programOptions);
+    if (!programOptions.traceFile.empty())
+    {
+        if (Trace::Open(programOptions.traceFile.c_str()))
+            Trace::SetThreadName("Main");
+        else
+            printf("Could not save %s\n", programOptions.traceFile.c_str());
+    }
+
+    if (programOptions.extendFrom.empty())
+        MakeMask(programOptions);
+    else
+        ExtendMask(programOptions);
+
+    Trace::Close();
 
     return 0;
 }
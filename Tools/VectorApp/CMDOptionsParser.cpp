@@ -10,6 +10,7 @@
 
 #include "CMDOptionsParser.h"
 
+#include <algorithm>
 #include <iostream>
 
 #include "cxxopts.hpp"
@@ -29,9 +30,25 @@ cxxopts::Options BuildCmdOptions()
         ("valueSigma", "Value sigma", cxxopts::value<float>()->default_value("1.0"))
         ("swapCountFactor", "Swap count factor", cxxopts::value<float>()->default_value("0.001"))
         ("coolingFactor", "Cooling factor", cxxopts::value<float>()->default_value("0.00001"))
+        ("coolingSchedule", "How temperature falls. Options are Linear, Geometric, Adaptive (Lam's schedule, steered by the acceptance rate), or Reheating (Geometric, reheating when the energy stalls)", cxxopts::value<std::string>()->default_value("Linear"))
+        ("earlyStop", "Stop before the swap budget is used up once the energy stalls", cxxopts::value<bool>()->default_value("false"))
+        ("stallImprovement", "Swaps are looked at in windows of one per pixel. A window stalls when it lowers the energy by less than this fraction of it, and accepts less than stallAcceptance of its swaps", cxxopts::value<float>()->default_value("0.00001"))
+        ("stallAcceptance", "Fraction of accepted swaps below which a window may stall, see stallImprovement", cxxopts::value<float>()->default_value("0.01"))
+        ("stallWindows", "Number of stalled windows in a row that reheat or stop early", cxxopts::value<int>()->default_value("4"))
+        ("spatialSwaps", "Fraction of swap proposals that pick the second pixel near the first, in the same XY slice", cxxopts::value<float>()->default_value("0"))
+        ("columnSwaps", "Fraction of swap proposals that pick the second pixel near the first, along the same Z column", cxxopts::value<float>()->default_value("0"))
+        ("spatialSwapRadius", "How far apart in X and Y the pixels of a spatial swap can be", cxxopts::value<int>()->default_value("4"))
+        ("columnSwapRadius", "How far apart in Z the pixels of a column swap can be", cxxopts::value<int>()->default_value("4"))
+        ("threads", "Run simulated annealing on this many threads, swapping inside checkerboard tiles that don't share any pixels. 1 is the original single chain. Experimental: its speedup on multiple cores has not been measured yet", cxxopts::value<int>()->default_value("1"))
+        ("speculativeThreads", "Evaluate upcoming swaps on this many threads at once, keeping the exact results of the single chain. 1 is off", cxxopts::value<int>()->default_value("1"))
+        ("replicas", "Run parallel tempering with this many replicas at fixed temperatures, one thread each, instead of a single cooling chain. 1 is off", cxxopts::value<int>()->default_value("1"))
+        ("replicaMaxTemperature", "Temperature, in energy units, of the hottest parallel tempering replica. The ladder halves from there, with 0 for the coldest", cxxopts::value<float>()->default_value("0.01"))
+        ("soaCells", "Keep a structure of arrays copy of the cells and evaluate swaps 8 neighbors at a time with AVX2, if the CPU has it", cxxopts::value<bool>()->default_value("true"))
         ("t,type", "Type of mask to Make. Options are Float, Float2, or Float3", cxxopts::value<std::string>()->default_value("Float2"))
         ("g,generator", "Generator to use for initial random values. Options are Uniform or Unit. CosineWeightdHemisphere is available for Float3", cxxopts::value<std::string>()->default_value("Uniform"))
         ("d,valueDistance", "ValueDistance function to use in simulated annealing for Float2 and Float3. Options are L1, L2, or LInfinity. Float3 may also specify NegativeDot as well. Float always uses absolute value. ", cxxopts::value<std::string>()->default_value("L1"))
+        ("trace", "Save a Chrome trace event timeline of the run to this JSON file, for Perfetto or chrome://tracing", cxxopts::value<std::string>()->default_value(""))
+        ("hugePageStats", "Print how many large allocations got huge pages once the run is done", cxxopts::value<bool>()->default_value("false"))
         ("h,help", "Print help")
         ;
     cmdOptions.allow_unrecognised_options();
@@ -176,6 +193,22 @@ VectorSTBNTypeArgs ParsedOptionsToMakeType(cxxopts::ParseResult& parsedOptions)
     return typeArgs;
 }
 
+CoolingScheduleParams ParsedOptionsToCoolingSchedule(cxxopts::ParseResult& parsedOptions)
+{
+    CoolingScheduleParams params;
+    auto scheduleStr = parsedOptions["coolingSchedule"].as<std::string>();
+    if (!StringToCoolingScheduleType(scheduleStr, params.type))
+    {
+        std::cout << "Error: Unrecognized cooling schedule option \'" << scheduleStr << "\'. Exiting." << std::endl;
+        exit(-1);
+    }
+    params.earlyStop = parsedOptions["earlyStop"].as<bool>();
+    params.stallImprovement = parsedOptions["stallImprovement"].as<float>();
+    params.stallAcceptance = parsedOptions["stallAcceptance"].as<float>();
+    params.stallWindows = static_cast<size_t>(std::max(parsedOptions["stallWindows"].as<int>(), 1));
+    return params;
+}
+
 VectorProgramOptions BuildProgramOptionsFromParsedArgs(cxxopts::ParseResult& parsedOptions)
 {
     VectorProgramOptions programOptions;
@@ -188,8 +221,20 @@ VectorProgramOptions BuildProgramOptionsFromParsedArgs(cxxopts::ParseResult& par
     programOptions.args.valueSigma = parsedOptions["valueSigma"].as<float>();
     programOptions.args.swapCountFactor = parsedOptions["swapCountFactor"].as<float>();
     programOptions.args.coolingFactor = parsedOptions["coolingFactor"].as<float>();
+    programOptions.args.coolingSchedule = ParsedOptionsToCoolingSchedule(parsedOptions);
+    programOptions.args.swapProposals.spatialFraction = parsedOptions["spatialSwaps"].as<float>();
+    programOptions.args.swapProposals.columnFraction = parsedOptions["columnSwaps"].as<float>();
+    programOptions.args.swapProposals.spatialRadius = static_cast<size_t>(std::max(parsedOptions["spatialSwapRadius"].as<int>(), 1));
+    programOptions.args.swapProposals.columnRadius = static_cast<size_t>(std::max(parsedOptions["columnSwapRadius"].as<int>(), 1));
+    programOptions.args.numThreads = static_cast<size_t>(std::max(parsedOptions["threads"].as<int>(), 1));
+    programOptions.args.numSpeculativeThreads = static_cast<size_t>(std::max(parsedOptions["speculativeThreads"].as<int>(), 1));
+    programOptions.args.numReplicas = static_cast<size_t>(std::max(parsedOptions["replicas"].as<int>(), 1));
+    programOptions.args.maxReplicaTemperature = parsedOptions["replicaMaxTemperature"].as<float>();
+    programOptions.args.soaCells = parsedOptions["soaCells"].as<bool>();
     programOptions.args.baseOutputFilePath = parsedOptions["output"].as<std::string>();
     programOptions.makeType = ParsedOptionsToMakeType(parsedOptions);
+    programOptions.traceFile = parsedOptions["trace"].as<std::string>();
+    programOptions.hugePageStats = parsedOptions["hugePageStats"].as<bool>();
 
     return programOptions;
 }
@@ -10,6 +10,8 @@
 
 #pragma once
 
+#include <string>
+
 #include "VectorSTBNArgs.h"
 #include "VectorSTBNImplSelector.h"
 
@@ -17,4 +19,6 @@ struct VectorProgramOptions
 {
     VectorSTBNTypeArgs makeType;
     VectorSTBNArgs args;
+    std::string traceFile;
+    bool hugePageStats;
 };
\ No newline at end of file
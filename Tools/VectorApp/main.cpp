@@ -23,9 +23,11 @@
 
 #include "cxxopts.hpp"
 
+#include "ArenaAllocator.h"
 #include "BlueNoiseTexturesND.h"
 #include "CMDOptionsParser.h"
 #include "ProgressContext.h"
+#include "Trace.h"
 #include "VectorSTBNImplSelector.h"
 #include "VectorProgramOptions.h"
 #include "Utils/Dimensions3D.h"
@@ -34,8 +36,19 @@ int main(int argc, char** argv)
 {
     VectorProgramOptions programOptions = ParseCmdArgs(argc, argv);
 
+    if (!programOptions.traceFile.empty())
+    {
+        if (Trace::Open(programOptions.traceFile.c_str()))
+            Trace::SetThreadName("Main");
+        else
+            printf("Could not save %s\n", programOptions.traceFile.c_str());
+    }
+
     VectorSTBNImplSelector runner(programOptions.makeType, programOptions.args);
     runner.Run();
+    if (programOptions.hugePageStats)
+        printf("%s\n", HugePageArena::GetStatsString().c_str());
 
+    Trace::Close();
     return 0;
 }